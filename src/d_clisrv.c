@@ -5464,14 +5464,14 @@ static INT16 Consistancy(void)
 		ret += P_GetRandSeed();
 
 #ifdef MOBJCONSISTANCY
-	if (!thinkercap.next)
+	if (!thlist[THINK_MOBJ].next)
 	{
 		DEBFILE(va("Consistancy = %u\n", ret));
 		return ret;
 	}
 	if (gamestate == GS_LEVEL)
 	{
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachThinker(th, THINK_MOBJ)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
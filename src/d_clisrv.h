@@ -24,8 +24,10 @@
 The 'packet version' is used to distinguish packet formats.
 This version is independent of VERSION and SUBVERSION. Different
 applications may follow different packet versions.
+Also bumped when builds that could talk would still desync, as
+with thinker order, so they don't find each other at all.
 */
-#define PACKETVERSION 0
+#define PACKETVERSION 1 // 1: mobjs keep thinker order when retyped
 
 // Network play related stuff.
 // There is a data struct that stores network
@@ -431,8 +431,16 @@ static void D_Display(void)
 		// draw the view directly
 		if (cv_renderview.value && !automapactive)
 		{
+			if (rendermode == render_soft)
+				R_TrimTextureCache();
+
 			R_ApplyLevelInterpolators(R_UsingFrameInterpolation() ? rendertimefrac : FRACUNIT);
 
+#ifdef PARALLELVIEWS
+			if (rendermode == render_soft && splitscreen && cv_parallelviews.value)
+				R_RenderViewsParallel();
+			else
+#endif
 			for (i = 0; i <= splitscreen; i++)
 			{
 				if (players[displayplayers[i]].mo || players[displayplayers[i]].playerstate == PST_DEAD)
@@ -1052,6 +1060,185 @@ static inline void D_MakeTitleString(char *s)
 }
 
 
+// ==========================================================================
+// Startup profiler
+// ==========================================================================
+//
+// -profilestartup [file] times every phase of D_SRB2Main, plus the per-file
+// steps of loading addons, and writes them out as JSON once startup is done
+// (to srb2home/startupprofile.json unless a file is given). Each entry has
+// its nesting depth and its time both with and without what ran inside it.
+
+#define STARTUPPROF_MAXDEPTH 16
+
+typedef struct
+{
+	const char *phase;
+	char *file, *lump;
+	UINT8 depth;
+	precise_t start, end;
+} startupphase_t;
+
+static startupphase_t *startupphases = NULL;
+static size_t numstartupphases = 0, maxstartupphases = 0;
+static size_t startupstack[STARTUPPROF_MAXDEPTH];
+static UINT8 startupdepth = 0;
+static boolean profilingstartup = false, inphase = false;
+static const char *startupprofilefile = NULL;
+static precise_t startupbegin;
+
+static char *D_StartupProfileDup(const char *str)
+{
+	char *dup;
+
+	if (!str || (dup = malloc(strlen(str) + 1)) == NULL)
+		return NULL;
+	return strcpy(dup, str);
+}
+
+/** Starts timing a step of startup, nested in whatever's running now.
+  * Does nothing unless -profilestartup was given.
+  *
+  * \param phase Name of the step, usually the function doing it.
+  * \param file  File it's working on, or NULL.
+  * \param lump  Lump in that file, or NULL.
+  */
+void D_StartupProfileBegin(const char *phase, const char *file, const char *lump)
+{
+	startupphase_t *sp;
+
+	if (!profilingstartup)
+		return;
+
+	if (startupdepth++ >= STARTUPPROF_MAXDEPTH)
+		return;
+
+	if (numstartupphases == maxstartupphases)
+	{
+		startupphase_t *grown;
+		maxstartupphases = maxstartupphases ? maxstartupphases*2 : 256;
+		grown = realloc(startupphases, maxstartupphases * sizeof (*startupphases));
+		if (!grown)
+		{
+			profilingstartup = false;
+			return;
+		}
+		startupphases = grown;
+	}
+
+	startupstack[startupdepth - 1] = numstartupphases;
+	sp = &startupphases[numstartupphases++];
+	sp->phase = phase;
+	sp->file = D_StartupProfileDup(file);
+	sp->lump = D_StartupProfileDup(lump);
+	sp->depth = (UINT8)(startupdepth - 1);
+	sp->start = sp->end = I_GetPreciseTime();
+}
+
+// Finishes the step started by the last D_StartupProfileBegin.
+void D_StartupProfileEnd(void)
+{
+	if (!profilingstartup || !startupdepth)
+		return;
+
+	if (--startupdepth < STARTUPPROF_MAXDEPTH)
+		startupphases[startupstack[startupdepth]].end = I_GetPreciseTime();
+}
+
+// Top-level phases of D_SRB2Main just run one after another.
+static void D_StartupPhase(const char *phase)
+{
+	if (inphase)
+		D_StartupProfileEnd();
+	inphase = (phase != NULL);
+	if (inphase)
+		D_StartupProfileBegin(phase, NULL, NULL);
+}
+
+static void D_WriteJSONString(FILE *f, const char *str)
+{
+	if (!str)
+	{
+		fputs("null", f);
+		return;
+	}
+
+	fputc('"', f);
+	for (; *str; str++)
+	{
+		if (*str == '"' || *str == '\\')
+			fprintf(f, "\\%c", *str);
+		else if ((UINT8)*str < ' ')
+			fprintf(f, "\\u%04x", (UINT8)*str);
+		else
+			fputc(*str, f);
+	}
+	fputc('"', f);
+}
+
+static void D_FinishStartupProfile(void)
+{
+	double precision, total;
+	const char *path;
+	FILE *f;
+	size_t i, j;
+
+	if (!profilingstartup)
+		return;
+
+	D_StartupPhase(NULL);
+	while (startupdepth)
+		D_StartupProfileEnd();
+	profilingstartup = false;
+
+	precision = (double)((INT64)I_GetPrecisePrecision()) / 1000.0;
+	total = (double)(I_GetPreciseTime() - startupbegin) / precision;
+
+	path = startupprofilefile ? startupprofilefile : va("%s"PATHSEP"startupprofile.json", srb2home);
+	if ((f = fopen(path, "w")) == NULL)
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't write startup profile to %s\n"), path);
+	else
+	{
+		fprintf(f, "{\n\t\"version\": ");
+		D_WriteJSONString(f, VERSIONSTRING);
+		fprintf(f, ",\n\t\"files\": %u,\n\t\"total_ms\": %.3f,\n\t\"phases\": [", numwadfiles, total);
+
+		for (i = 0; i < numstartupphases; i++)
+		{
+			startupphase_t *sp = &startupphases[i];
+			double ms = (double)(sp->end - sp->start) / precision;
+			double self = ms;
+
+			// take out the time spent in the steps directly inside this one
+			for (j = i + 1; j < numstartupphases && startupphases[j].depth > sp->depth; j++)
+				if (startupphases[j].depth == sp->depth + 1)
+					self -= (double)(startupphases[j].end - startupphases[j].start) / precision;
+
+			fprintf(f, "%s\n\t\t{\"phase\": ", i ? "," : "");
+			D_WriteJSONString(f, sp->phase);
+			fprintf(f, ", \"file\": ");
+			D_WriteJSONString(f, sp->file);
+			fprintf(f, ", \"lump\": ");
+			D_WriteJSONString(f, sp->lump);
+			fprintf(f, ", \"depth\": %u, \"start_ms\": %.3f, \"ms\": %.3f, \"self_ms\": %.3f}",
+				sp->depth, (double)(sp->start - startupbegin) / precision, ms, self);
+		}
+		fprintf(f, "\n\t]\n}\n");
+		fclose(f);
+
+		CONS_Printf(M_GetText("Startup profile written to %s (%.0f ms)\n"), path, total);
+	}
+
+	for (i = 0; i < numstartupphases; i++)
+	{
+		free(startupphases[i].file);
+		free(startupphases[i].lump);
+	}
+	free(startupphases);
+	startupphases = NULL;
+	numstartupphases = maxstartupphases = 0;
+}
+
 //
 // D_SRB2Main
 //
@@ -1081,6 +1268,14 @@ void D_SRB2Main(void)
 	"We do not claim ownership of SEGA's intellectual property used\n"
 	"in this program.\n\n");
 
+	if (M_CheckParm("-profilestartup"))
+	{
+		profilingstartup = true;
+		startupbegin = I_GetPreciseTime();
+		if (M_IsNextParm())
+			startupprofilefile = M_GetNextParm();
+	}
+
 	// keep error messages until the final flush(stderr)
 #if !defined (PC_DOS) && !defined (_WIN32_WCE) && !defined(NOTERMIOS)
 	if (setvbuf(stderr, NULL, _IOFBF, 1000))
@@ -1246,6 +1441,7 @@ void D_SRB2Main(void)
 	if (M_CheckParm("-server") || dedicated)
 		netgame = server = true;
 
+	D_StartupPhase("Z_Init");
 	CONS_Printf("Z_Init(): Init zone memory allocation daemon. \n");
 	Z_Init();
 
@@ -1268,6 +1464,7 @@ void D_SRB2Main(void)
 	// Have to be done here before files are loaded
 	M_InitCharacterTables();
 
+	D_StartupPhase("W_InitMultipleFiles (main)");
 	// load wad, including the main wad file
 	CONS_Printf("W_InitMultipleFiles(): Adding IWAD and main PWADs.\n");
 	if (!W_InitMultipleFiles(startupwadfiles, false))
@@ -1334,10 +1531,14 @@ void D_SRB2Main(void)
 		}
 	}
 
+	D_StartupPhase("W_InitMultipleFiles (addons)");
 	if (!W_InitMultipleFiles(startuppwads, true))
 		CONS_Error("A PWAD file was not found or not valid.\nCheck the log to see which ones.\n");
 	D_CleanFile(startuppwads);
 
+	if (M_CheckParm("-lumpbench"))
+		W_BenchmarkLookups();
+
 	//
 	// search for maps... again.
 	//
@@ -1373,6 +1574,7 @@ void D_SRB2Main(void)
 	//---------------------------------------------------- READY SCREEN
 	// we need to check for dedicated before initialization of some subsystems
 
+	D_StartupPhase("I_StartupGraphics");
 	CONS_Printf("I_StartupGraphics()...\n");
 	I_StartupGraphics();
 
@@ -1389,9 +1591,11 @@ void D_SRB2Main(void)
 	SCR_Startup();
 
 	// we need the font of the console
+	D_StartupPhase("HU_Init");
 	CONS_Printf("HU_Init(): Setting up heads up display.\n");
 	HU_Init();
 
+	D_StartupPhase("CON_Init");
 	COM_Init();
 	// libogc has a CON_Init function, we must rename SRB2's CON_Init in WII/libogc
 #ifndef _WII
@@ -1408,6 +1612,7 @@ void D_SRB2Main(void)
 	I_RegisterSysCommands();
 
 	//--------------------------------------------------------- CONFIG.CFG
+	D_StartupPhase("M_FirstLoadConfig");
 	M_FirstLoadConfig(); // WARNING : this do a "COM_BufExecute()"
 
 	G_LoadGameData();
@@ -1449,13 +1654,20 @@ void D_SRB2Main(void)
 	if (M_CheckParm("-noupload"))
 		COM_BufAddText("downloading 0\n");
 
+	D_StartupPhase("M_Init");
 	CONS_Printf("M_Init(): Init miscellaneous info.\n");
 	M_Init();
 
+	D_StartupPhase("R_Init");
 	CONS_Printf("R_Init(): Init SRB2 refresh daemon.\n");
 	R_Init();
 
+	// compare the SIMD drawers against the C ones
+	if (M_CheckParm("-drawercheck"))
+		R_CheckDrawers();
+
 	// setting up sound
+	D_StartupPhase("S_Init");
 	if (dedicated)
 	{
 		sound_disabled = true;
@@ -1506,6 +1718,7 @@ void D_SRB2Main(void)
 		S_InitMusicDefs();
 	}
 
+	D_StartupPhase("ST_Init");
 	CONS_Printf("ST_Init(): Init status bar.\n");
 	ST_Init();
 
@@ -1522,6 +1735,7 @@ void D_SRB2Main(void)
 	}
 
 	// init all NETWORK
+	D_StartupPhase("D_CheckNetGame");
 	CONS_Printf("D_CheckNetGame(): Checking network game status.\n");
 	if (D_CheckNetGame())
 		autostart = true;
@@ -1543,6 +1757,7 @@ void D_SRB2Main(void)
 	}
 
 	// user settings come before "+" parameters.
+	D_StartupPhase("exec config");
 	if (dedicated)
 		COM_ImmedExecute(va("exec \"%s"PATHSEP"kartserv.cfg\"\n", srb2home));
 	else
@@ -1551,6 +1766,8 @@ void D_SRB2Main(void)
 	if (!autostart)
 		M_PushSpecialParameters(); // push all "+" parameters at the command buffer
 
+	D_FinishStartupProfile();
+
 	// demo doesn't need anymore to be added with D_AddFile()
 	p = M_CheckParm("-playdemo");
 	if (!p)
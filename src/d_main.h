@@ -35,6 +35,10 @@ void D_SRB2Loop(void) FUNCNORETURN;
 //
 void D_SRB2Main(void);
 
+// -profilestartup: time a step of startup, see d_main.c
+void D_StartupProfileBegin(const char *phase, const char *file, const char *lump);
+void D_StartupProfileEnd(void);
+
 // Called by IO functions when input is detected.
 void D_PostEvent(const event_t *ev);
 #if defined (PC_DOS) && !defined (DOXYGEN)
@@ -3555,6 +3555,7 @@ void DEH_LoadDehackedLumpPwad(UINT16 wad, UINT16 lump)
 #ifdef DELFILE
 	unsocwad = wad;
 #endif
+	D_StartupProfileBegin("DEH_LoadDehackedLumpPwad", wadfiles[wad]->filename, wadfiles[wad]->lumpinfo[lump].fullname);
 	f.wad = wad;
 	f.size = W_LumpLengthPwad(wad, lump);
 	f.data = Z_Malloc(f.size + 1, PU_STATIC, NULL);
@@ -3564,6 +3565,7 @@ void DEH_LoadDehackedLumpPwad(UINT16 wad, UINT16 lump)
 	DEH_LoadDehackedFile(&f, wad);
 	DEH_WriteUndoline(va("# uload for wad: %u, lump: %u", wad, lump), NULL, UNDO_DONE);
 	Z_Free(f.data);
+	D_StartupProfileEnd();
 }
 
 void DEH_LoadDehackedLump(lumpnum_t lumpnum)
@@ -227,6 +227,7 @@ extern char  logfilename[1024];
 // NOTE: it needs more than this to increase the number of players...
 
 #define MAXPLAYERS 16
+#define MAXSPLITSCREENPLAYERS 4 // Max number of players on a single computer
 #define MAXSKINS 255
 #define PLAYERSMASK (MAXPLAYERS-1)
 #define MAXPLAYERNAME 21
@@ -756,6 +757,17 @@ extern const char *compdate, *comptime, *comprevision, *compbranch;
 ///      	SRB2CB itself ported this from PrBoom+
 //#define NEWCLIP
 
+/// Render splitscreen views at the same time, one per thread.
+/// \note	Everything a view writes while rendering is thread-local (RENDERLOCAL),
+///      	so this needs real TLS from the compiler (ATTRTHREAD), and the
+///      	assembly drawers can't be used since they expect plain globals.
+#if defined (HAVE_THREADS) && defined (ATTRTHREAD) && !defined (USEASM)
+#define PARALLELVIEWS
+#define RENDERLOCAL ATTRTHREAD
+#else
+#define RENDERLOCAL
+#endif
+
 /// Hardware renderer: OpenGL
 #define GL_SHADERS
 
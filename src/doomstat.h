@@ -80,7 +80,6 @@ extern boolean multiplayer;
 
 extern INT16 gametype;
 
-#define MAXSPLITSCREENPLAYERS 4 // Max number of players on a single computer
 extern UINT8 splitscreen;
 
 extern boolean circuitmap; // Does this level have 'circuit mode'?
@@ -114,8 +113,12 @@ extern boolean lastdraw;
 extern postimg_t postimgtype[MAXSPLITSCREENPLAYERS];
 extern INT32 postimgparam[MAXSPLITSCREENPLAYERS];
 
-extern INT32 viewwindowx, viewwindowy;
+extern RENDERLOCAL INT32 viewwindowx, viewwindowy;
 extern INT32 viewwidth, scaledviewwidth;
+#ifdef PARALLELVIEWS
+extern boolean renderthreads; // views (or slices of one) are being drawn on worker threads right now
+extern boolean renderslices; // the view being drawn is split into slices, see R_DrawSlices
+#endif
 
 extern boolean gamedataloaded;
 
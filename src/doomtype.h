@@ -311,6 +311,10 @@ size_t strlcpy(char *dst, const char *src, size_t siz);
 
 	#define ATTRUNUSED __attribute__((unused))
 
+	#ifndef __MINGW32__ // MinGW only has emulated TLS, which is slow
+		#define ATTRTHREAD __thread
+	#endif
+
 	// Xbox-only macros
 	#ifdef _XBOX
 		#define FILESTAMP I_OutputMsg("%s:%d\n",__FILE__,__LINE__);
@@ -319,6 +323,7 @@ size_t strlcpy(char *dst, const char *src, size_t siz);
 #elif defined (_MSC_VER)
 	#define ATTRNORETURN __declspec(noreturn)
 	#define ATTRINLINE __forceinline
+	#define ATTRTHREAD __declspec(thread)
 	#if _MSC_VER > 1200 // >= MSVC 6.0
 		#define ATTRNOINLINE __declspec(noinline)
 	#endif
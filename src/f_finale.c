@@ -1161,6 +1161,7 @@ void F_StartWaitingPlayers(void)
 		Z_Free(waitcolormap);
 
 	waitcolormap = R_GetTranslationColormap(randskin, skins[randskin].prefcolor, 0);
+	R_LoadSkinSprites(&skins[randskin]);
 
 	for (i = 0; i < 2; i++)
 	{
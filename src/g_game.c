@@ -3217,7 +3217,7 @@ void G_ChangePlayerReferences(mobj_t *oldmo, mobj_t *newmo)
 	I_Assert((oldmo != NULL) && (newmo != NULL));
 
 	// scan all thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachThinker(th, THINK_MOBJ)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -5104,7 +5104,11 @@ INT32 G_FindMapByNameOrCode(const char *mapname, char **realmapnamep)
 // DEMO RECORDING
 //
 
-#define DEMOVERSION 0x0002
+// 0x0003: thinkers run list by list (polyobjects, specials, then mobjs)
+// instead of in spawn order. 0x0002 replays read the same, but can't be
+// expected to stay in sync.
+#define DEMOVERSION 0x0003
+#define DEMOVERSION_OLDTHINKERS 0x0002
 #define DEMOHEADER  "\xF0" "KartReplay" "\x0F"
 
 #define DF_GHOST        0x01 // This demo contains ghost data too!
@@ -5911,8 +5915,7 @@ void G_ConsGhostTic(INT32 playernum)
 		if (ziptic & EZT_HIT)
 		{ // Resync mob damage.
 			UINT16 i, count = READUINT16(demo_p);
-			thinker_t *th;
-			mobj_t *mobj;
+			mobj_t *mobj, *next;
 
 			UINT32 type;
 			UINT16 health;
@@ -5931,14 +5934,10 @@ void G_ConsGhostTic(INT32 playernum)
 				demo_p += sizeof(angle_t); // angle, unnecessary for cons.
 
 				mobj = NULL;
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				P_ForEachMobjOfType(mobj, next, type)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-						continue;
-					mobj = (mobj_t *)th;
-					if (mobj->type == (mobjtype_t)type && mobj->x == x && mobj->y == y && mobj->z == z)
+					if (mobj->x == x && mobj->y == y && mobj->z == z)
 						break;
-					mobj = NULL; // wasn't this one, keep searching.
 				}
 				if (mobj && mobj->health != health) // Wasn't damaged?! This is desync! Fix it!
 				{
@@ -7193,6 +7192,7 @@ UINT8 G_CmpDemoTime(char *oldname, char *newname)
 	oldversion = READUINT16(p);
 	switch(oldversion) // demoversion
 	{
+	case DEMOVERSION_OLDTHINKERS: // times still count
 	case DEMOVERSION: // latest always supported
 		p += 64; // full demo title
 		break;
@@ -7288,6 +7288,9 @@ void G_LoadDemoInfo(menudemo_t *pdemo)
 
 	switch(pdemoversion)
 	{
+	case DEMOVERSION_OLDTHINKERS:
+		pdemo->type = MD_OUTDATED;
+		/* FALLTHRU */
 	case DEMOVERSION: // latest always supported
 		// demo title
 		M_Memcpy(pdemo->title, info_p, 64);
@@ -7539,6 +7542,10 @@ void G_DoPlayDemo(char *defdemoname)
 	demo.version = READUINT16(demo_p);
 	switch(demo.version)
 	{
+	case DEMOVERSION_OLDTHINKERS:
+		if (!demo.title)
+			CONS_Alert(CONS_WARNING, M_GetText("%s was recorded before a change to thinker order and will probably desync.\n"), pdemoname);
+		/* FALLTHRU */
 	case DEMOVERSION: // latest always supported
 		// demo title
 		M_Memcpy(demo.titlename, demo_p, 64);
@@ -8037,6 +8044,7 @@ void G_AddGhost(char *defdemoname)
 	ghostversion = READUINT16(p);
 	switch(ghostversion)
 	{
+	case DEMOVERSION_OLDTHINKERS: // ghosts replay positions, not inputs
 	case DEMOVERSION: // latest always supported
 		p += 64; // title
 		break;
@@ -8300,6 +8308,7 @@ void G_UpdateStaffGhostName(lumpnum_t l)
 	ghostversion = READUINT16(p);
 	switch(ghostversion)
 	{
+	case DEMOVERSION_OLDTHINKERS:
 	case DEMOVERSION: // latest always supported
 		p += 64; // full demo title
 		break;
@@ -8415,7 +8424,6 @@ void G_DoPlayMetal(void)
 {
 	lumpnum_t l;
 	mobj_t *mo = NULL;
-	thinker_t *th;
 
 	// it's an internal demo
 	if ((l = W_CheckNumForName(va("%sMS",G_BuildMapName(gamemap)))) == LUMPERROR)
@@ -8427,15 +8435,7 @@ void G_DoPlayMetal(void)
 		metalbuffer = metal_p = W_CacheLumpNum(l, PU_STATIC);
 
 	// find metal sonic
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
-	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo = (mobj_t *)th;
-		if (mo->type == MT_METALSONIC_RACE)
-			break;
-	}
+	mo = P_FirstMobjOfType(MT_METALSONIC_RACE);
 	if (!mo)
 	{
 		CONS_Alert(CONS_ERROR, M_GetText("Failed to find bot entity.\n"));
@@ -8450,6 +8450,7 @@ void G_DoPlayMetal(void)
 	metalversion = READUINT16(metal_p);
 	switch(metalversion)
 	{
+	case DEMOVERSION_OLDTHINKERS: // positions, like ghosts
 	case DEMOVERSION: // latest always supported
 		break;
 #ifdef DEMO_COMPAT_100
@@ -129,6 +129,10 @@ typedef struct gr_vissprite_s
 	UINT8 translucency;       //alpha level 0-255
 	mobj_t *mobj;
 	boolean precip; // Tails 08-25-2002
+	// precipitation has no mobj, so it brings along what it's drawn with
+	sector_t *precipsector;
+	UINT32 precipframe;
+	fixed_t precipz;
 	boolean vflip;
    //Hurdler: 25/04/2000: now support colormap in hardware mode
 	UINT8 *colormap;
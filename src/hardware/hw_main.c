@@ -2471,20 +2471,6 @@ void HWR_Subsector(size_t num)
 	{
 		boolean anyMoved = gr_frontsector->moved;
 
-		if (anyMoved == false)
-		{
-			for (rover = gr_frontsector->ffloors; rover; rover = rover->next)
-			{
-				sector_t *controlSec = &sectors[rover->secnum];
-
-				if (controlSec->moved == true)
-				{
-					anyMoved = true;
-					break;
-				}
-			}
-		}
-
 		if (anyMoved == true)
 		{
 			gr_frontsector->numlights = sub->sector->numlights = 0;
@@ -3018,43 +3004,37 @@ static void HWR_DrawSpriteShadow(gr_vissprite_t *spr, GLPatch_t *gpatch, float t
 // This is expecting a pointer to an array containing 4 wallVerts for a sprite
 static void HWR_RotateSpritePolyToAim(gr_vissprite_t *spr, FOutVector *wallVerts)
 {
-	if (cv_grspritebillboarding.value && spr && spr->mobj && !(spr->mobj->frame & FF_PAPERSPRITE) && wallVerts)
+	if (cv_grspritebillboarding.value && spr && wallVerts
+		&& (spr->precip || (spr->mobj && !(spr->mobj->frame & FF_PAPERSPRITE))))
 	{
 		// uncapped/interpolation
 		interpmobjstate_t interp = {0};
 		float basey, lowy;
 
-		// do interpolation
-		if (R_UsingFrameInterpolation() && !paused)
+		if (spr->precip)
 		{
-			if (spr->precip)
-			{
-				R_InterpolatePrecipMobjState((precipmobj_t *)spr->mobj, rendertimefrac, &interp);
-			}
-			else
-			{
-				R_InterpolateMobjState(spr->mobj, rendertimefrac, &interp);
-			}
+			basey = FIXED_TO_FLOAT(spr->precipz);
 		}
 		else
 		{
-			if (spr->precip)
+			// do interpolation
+			if (R_UsingFrameInterpolation() && !paused)
 			{
-				R_InterpolatePrecipMobjState((precipmobj_t *)spr->mobj, FRACUNIT, &interp);
+				R_InterpolateMobjState(spr->mobj, rendertimefrac, &interp);
 			}
 			else
 			{
 				R_InterpolateMobjState(spr->mobj, FRACUNIT, &interp);
 			}
-		}
 
-		if (P_MobjFlip(spr->mobj) == -1)
-		{
-			basey = FIXED_TO_FLOAT(interp.z + spr->mobj->height);
-		}
-		else
-		{
-			basey = FIXED_TO_FLOAT(interp.z);
+			if (P_MobjFlip(spr->mobj) == -1)
+			{
+				basey = FIXED_TO_FLOAT(interp.z + spr->mobj->height);
+			}
+			else
+			{
+				basey = FIXED_TO_FLOAT(interp.z);
+			}
 		}
 		lowy = wallVerts[0].y;
 
@@ -3588,10 +3568,7 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 	GLPatch_t *gpatch; // sprite patch converted to hardware
 	FSurfaceInfo Surf;
 
-	if (!spr->mobj)
-		return;
-
-	if (!spr->mobj->subsector)
+	if (!spr->precipsector)
 		return;
 
 	// cache sprite graphics
@@ -3629,7 +3606,7 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 
 	// colormap test
 	{
-		sector_t *sector = spr->mobj->subsector->sector;
+		sector_t *sector = spr->precipsector;
 		UINT8 lightlevel = 255;
 		extracolormap_t *colormap = sector->extra_colormap;
 
@@ -3637,9 +3614,9 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 		{
 			INT32 light;
 
-			light = R_GetPlaneLight(sector, spr->mobj->z + spr->mobj->height, false); // Always use the light at the top instead of whatever I was doing before
+			light = R_GetPlaneLight(sector, spr->precipz, false); // Always use the light at the top instead of whatever I was doing before
 
-			if (!(spr->mobj->frame & FF_FULLBRIGHT))
+			if (!(spr->precipframe & FF_FULLBRIGHT))
 				lightlevel = *sector->lightlist[light].lightlevel > 255 ? 255 : *sector->lightlist[light].lightlevel;
 
 			if (sector->lightlist[light].extra_colormap)
@@ -3647,7 +3624,7 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 		}
 		else
 		{
-			if (!(spr->mobj->frame & FF_FULLBRIGHT))
+			if (!(spr->precipframe & FF_FULLBRIGHT))
 				lightlevel = sector->lightlevel > 255 ? 255 : sector->lightlevel;
 
 			if (sector->extra_colormap)
@@ -3657,13 +3634,8 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 		HWR_Lighting(&Surf, lightlevel, colormap);
 	}
 
-	if (spr->mobj->flags2 & MF2_SHADOW)
-	{
-		Surf.PolyColor.s.alpha = 0x40;
-		blend = PF_Translucent;
-	}
-	else if (spr->mobj->frame & FF_TRANSMASK)
-		blend = HWR_TranstableToAlpha((spr->mobj->frame & FF_TRANSMASK)>>FF_TRANSSHIFT, &Surf);
+	if (spr->precipframe & FF_TRANSMASK)
+		blend = HWR_TranstableToAlpha((spr->precipframe & FF_TRANSMASK)>>FF_TRANSSHIFT, &Surf);
 	else
 	{
 		// BP: i agree that is little better in environement but it don't
@@ -3696,8 +3668,10 @@ static int CompareVisSprites(const void *p1, const void *p2)
 	// make transparent sprites last
 	// "boolean to int"
 	
-	int transparency1 = (spr1->mobj->flags2 & MF2_SHADOW) || (spr1->mobj->frame & FF_TRANSMASK);
-	int transparency2 = (spr2->mobj->flags2 & MF2_SHADOW) || (spr2->mobj->frame & FF_TRANSMASK);
+	int transparency1 = spr1->precip ? !!(spr1->precipframe & FF_TRANSMASK)
+		: ((spr1->mobj->flags2 & MF2_SHADOW) || (spr1->mobj->frame & FF_TRANSMASK));
+	int transparency2 = spr2->precip ? !!(spr2->precipframe & FF_TRANSMASK)
+		: ((spr2->mobj->flags2 & MF2_SHADOW) || (spr2->mobj->frame & FF_TRANSMASK));
 	idiff = transparency1 - transparency2;
 	if (idiff != 0) return idiff;
 
@@ -4044,7 +4018,8 @@ void HWR_DrawSprites(void)
 void HWR_AddSprites(sector_t *sec)
 {
 	mobj_t *thing;
-	precipmobj_t *precipthing;
+	precipdrop_t *drops;
+	size_t i, numdrops;
 	fixed_t approx_dist, limit_dist;
 
 	INT32 splitflags;
@@ -4147,22 +4122,9 @@ void HWR_AddSprites(sector_t *sec)
 		}
 	}
 
-	// No to infinite precipitation draw distance.
-	if ((limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS))
-	{
-		for (precipthing = sec->preciplist; precipthing; precipthing = precipthing->snext)
-		{
-			if (precipthing->precipflags & PCF_INVISIBLE)
-				continue;
-
-			approx_dist = P_AproxDistance(viewx-precipthing->x, viewy-precipthing->y);
-
-			if (approx_dist > limit_dist)
-				continue;
-
-			HWR_ProjectPrecipitationSprite(precipthing);
-		}
-	}
+	numdrops = R_GatherPrecipitation(sec, &drops);
+	for (i = 0; i < numdrops; i++)
+		HWR_ProjectPrecipitationSprite(&drops[i]);
 }
 
 // --------------------------------------------------------------------------
@@ -4231,7 +4193,10 @@ void HWR_ProjectSprite(mobj_t *thing)
 
 	//Fab : 02-08-98: 'skin' override spritedef currently used for skin
 	if (thing->skin && thing->sprite == SPR_PLAY)
+	{
+		R_LoadSkinSprites(thing->skin);
 		sprdef = &((skin_t *)thing->skin)->spritedef;
+	}
 	else
 		sprdef = &sprites[thing->sprite];
 
@@ -4420,7 +4385,7 @@ void HWR_ProjectSprite(mobj_t *thing)
 }
 
 // Precipitation projector for hardware mode
-void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
+void HWR_ProjectPrecipitationSprite(const precipdrop_t *drop)
 {
 	gr_vissprite_t *vis;
 	float tr_x, tr_y;
@@ -4434,25 +4399,9 @@ void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	unsigned rot = 0;
 	UINT8 flip;
 
-	// uncapped/interpolation
-	interpmobjstate_t interp = {0};
-
-	if (!thing)
-		return;
-
-	// do interpolation
-	if (R_UsingFrameInterpolation() && !paused)
-	{
-		R_InterpolatePrecipMobjState(thing, rendertimefrac, &interp);
-	}
-	else
-	{
-		R_InterpolatePrecipMobjState(thing, FRACUNIT, &interp);
-	}
-
 	// transform the origin point
-	tr_x = FIXED_TO_FLOAT(interp.x) - gr_viewx;
-	tr_y = FIXED_TO_FLOAT(interp.y) - gr_viewy;
+	tr_x = FIXED_TO_FLOAT(drop->x) - gr_viewx;
+	tr_y = FIXED_TO_FLOAT(drop->y) - gr_viewy;
 
 	// rotation around vertical axis
 	tz = (tr_x * gr_viewcos) + (tr_y * gr_viewsin);
@@ -4461,29 +4410,29 @@ void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	if (tz < ZCLIP_PLANE)
 		return;
 
-	tr_x = FIXED_TO_FLOAT(interp.x);
-	tr_y = FIXED_TO_FLOAT(interp.y);
+	tr_x = FIXED_TO_FLOAT(drop->x);
+	tr_y = FIXED_TO_FLOAT(drop->y);
 
 	// decide which patch to use for sprite relative to player
-	if ((unsigned)thing->sprite >= numsprites)
+	if ((unsigned)drop->sprite >= numsprites)
 #ifdef RANGECHECK
 		I_Error("HWR_ProjectPrecipitationSprite: invalid sprite number %i ",
-		        thing->sprite);
+		        drop->sprite);
 #else
 		return;
 #endif
 
-	sprdef = &sprites[thing->sprite];
+	sprdef = &sprites[drop->sprite];
 
-	if ((size_t)(thing->frame&FF_FRAMEMASK) >= sprdef->numframes)
+	if ((size_t)(drop->frame&FF_FRAMEMASK) >= sprdef->numframes)
 #ifdef RANGECHECK
 		I_Error("HWR_ProjectPrecipitationSprite: invalid sprite frame %i : %i for %s",
-		        thing->sprite, thing->frame, sprnames[thing->sprite]);
+		        drop->sprite, drop->frame, sprnames[drop->sprite]);
 #else
 		return;
 #endif
 
-	sprframe = &sprdef->spriteframes[ thing->frame & FF_FRAMEMASK];
+	sprframe = &sprdef->spriteframes[ drop->frame & FF_FRAMEMASK];
 
 	// use single rotation for all views
 	lumpoff = sprframe->lumpid[0];
@@ -4507,16 +4456,6 @@ void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	x1 = tr_x + x1 * rightcos;
 	x2 = tr_x - x2 * rightcos;
 
-	// okay, we can't return now... this is a hack, but weather isn't networked, so it should be ok
-	if (!(thing->precipflags & PCF_THUNK))
-	{
-		if (thing->precipflags & PCF_RAIN)
-			P_RainThinker(thing);
-		else
-			P_SnowThinker(thing);
-		thing->precipflags |= PCF_THUNK;
-	}
-
 	//
 	// store information in a vissprite
 	//
@@ -4529,19 +4468,22 @@ void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis->dispoffset = 0; // Monster Iestyn: 23/11/15: HARDWARE SUPPORT AT LAST
 	vis->patchlumpnum = sprframe->lumppat[rot];
 	vis->flip = flip;
-	vis->mobj = (mobj_t *)thing;
+	vis->mobj = NULL;
 
 	vis->colormap = colormaps;
 
 #ifdef GLENCORE
-	if (encoremap && !(thing->flags & MF_DONTENCOREMAP))
+	if (encoremap && !(mobjinfo[curWeather == PRECIP_SNOW ? MT_SNOWFLAKE : MT_RAIN].flags & MF_DONTENCOREMAP))
 		vis->colormap += (256*32);
 #endif
 
 	// set top/bottom coords
-	vis->ty = FIXED_TO_FLOAT(interp.z + spritecachedinfo[lumpoff].topoffset);
+	vis->ty = FIXED_TO_FLOAT(drop->z + spritecachedinfo[lumpoff].topoffset);
 
 	vis->precip = true;
+	vis->precipsector = drop->sector;
+	vis->precipframe = drop->frame;
+	vis->precipz = drop->z;
 }
 
 static boolean drewsky = false;
@@ -29,6 +29,7 @@
 #include "../am_map.h"
 #include "../d_player.h"
 #include "../r_defs.h"
+#include "../r_things.h"
 
 #define GLENCORE
 
@@ -118,7 +119,7 @@ void HWR_RenderDrawNodes(void);
 // hw_main.c: Sprites
 void HWR_AddSprites(sector_t *sec);
 void HWR_ProjectSprite(mobj_t *thing);
-void HWR_ProjectPrecipitationSprite(precipmobj_t *thing);
+void HWR_ProjectPrecipitationSprite(const precipdrop_t *drop);
 void HWR_DrawSprites(void);
 
 // hw_bsp.c
@@ -1298,7 +1298,10 @@ void HWR_DrawMD2(gr_vissprite_t *spr)
 			p.z = FIXED_TO_FLOAT(interp.z);
 
 		if (spr->mobj->skin && spr->mobj->sprite == SPR_PLAY)
+		{
+			R_LoadSkinSprites(spr->mobj->skin);
 			sprdef = &((skin_t *)spr->mobj->skin)->spritedef;
+		}
 		else
 			sprdef = &sprites[spr->mobj->sprite];
 
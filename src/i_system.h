@@ -308,6 +308,7 @@ typedef struct {
 	int SSE        : 1; ///< SSE features
 	int SSE2       : 1; ///< SSE2 features
 	int SSE3       : 1; ///< SSE3 features
+	int AVX2       : 1; ///< AVX2 features
 	int IA64       : 1; ///< Running on IA64
 	int AMD64      : 1; ///< Running on AMD64
 	int AltiVec    : 1; ///< AltiVec features
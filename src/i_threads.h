@@ -22,7 +22,8 @@ typedef void * I_cond;
 void      I_start_threads (void);
 void      I_stop_threads  (void);
 
-void      I_spawn_thread (const char *name, I_thread_fn, void *userdata);
+/* returns 0 if the thread didn't start, because threads are stopped */
+int       I_spawn_thread (const char *name, I_thread_fn, void *userdata);
 
 /* check in your thread whether to return early */
 int       I_thread_is_stopped (void);
@@ -561,7 +561,7 @@ static int mobj_set(lua_State *L)
 		mobjtype_t newtype = luaL_checkinteger(L, 3);
 		if (newtype >= NUMMOBJTYPES)
 			return luaL_error(L, "mobj.type %d out of range (0 - %d).", newtype, NUMMOBJTYPES-1);
-		mo->type = newtype;
+		P_SetMobjType(mo, newtype);
 		mo->info = &mobjinfo[newtype];
 		P_SetScale(mo, mo->scale);
 		break;
@@ -23,6 +23,7 @@
 #include "p_saveg.h"
 #include "p_local.h"
 #include "p_slopes.h" // for P_SlopeById
+#include "d_main.h" // for D_StartupProfileBegin
 #ifdef LUA_ALLOW_BYTECODE
 #include "d_netfil.h" // for LUA_DumpFile
 #endif
@@ -188,6 +189,9 @@ void LUA_LoadLump(UINT16 wad, UINT16 lump)
 	MYFILE f;
 	char *name;
 	size_t len;
+
+	D_StartupProfileBegin("LUA_LoadLump", wadfiles[wad]->filename, wadfiles[wad]->lumpinfo[lump].fullname);
+
 	f.wad = wad;
 	f.size = W_LumpLengthPwad(wad, lump);
 	f.data = Z_Malloc(f.size, PU_LUA, NULL);
@@ -217,6 +221,8 @@ void LUA_LoadLump(UINT16 wad, UINT16 lump)
 
 	free(name);
 	Z_Free(f.data);
+
+	D_StartupProfileEnd();
 }
 
 #ifdef LUA_ALLOW_BYTECODE
@@ -410,12 +416,14 @@ void LUA_InvalidateUserdata(void *data)
 void LUA_InvalidateLevel(void)
 {
 	thinker_t *th;
+	thinklistnum_t n;
 	size_t i;
 	if (!gL)
 		return;
 
-	for (th = thinkercap.next; th && th != &thinkercap; th = th->next)
-		LUA_InvalidateUserdata(th);
+	for (n = 0; n < NUM_THINKERLISTS; n++)
+		for (th = thlist[n].next; th && th != &thlist[n]; th = th->next)
+			LUA_InvalidateUserdata(th);
 
 	LUA_InvalidateMapthings();
 
@@ -1495,7 +1503,7 @@ void LUA_Archive(void)
 
 	if (gamestate == GS_LEVEL)
 	{
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachThinker(th, THINK_MOBJ)
 			if (th->function.acp1 == (actionf_p1)P_MobjThinker)
 			{
 				// archive function will determine when to skip mobjs,
@@ -1530,7 +1538,7 @@ void LUA_UnArchive(void)
 
 	do {
 		mobjnum = READUINT32(save_p); // read a mobjnum
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachThinker(th, THINK_MOBJ)
 			if (th->function.acp1 == (actionf_p1)P_MobjThinker
 			&& ((mobj_t *)th)->mobjnum == mobjnum) // find matching mobj
 				UnArchiveExtVars(th); // apply variables
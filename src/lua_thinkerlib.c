@@ -28,8 +28,16 @@ static const actionf_p1 iter_funcs[] = {
 	(actionf_p1)P_MobjThinker
 };
 
+// first and last thinker list to walk for each option
+static const thinklistnum_t iter_lists[][2] = {
+	{0, NUM_THINKERLISTS-1},
+	{THINK_MOBJ, THINK_MOBJ}
+};
+
 struct iterationState {
 	actionf_p1 filter;
+	thinklistnum_t first, last;
+	mobjtype_t type; // mobjs.iterate only, NUMMOBJTYPES for any
 	int next;
 };
 
@@ -51,6 +59,26 @@ static int iterationState_gc(lua_State *L)
 		lua_pushlightuserdata(L, (th)); \
 }
 
+// Steps over the heads of the lists being walked, on to the next
+// real thinker, or NULL once the last list has run out.
+static thinker_t *SkipListHeads(thinker_t *th, thinklistnum_t last)
+{
+	thinklistnum_t n;
+
+	for (;;)
+	{
+		for (n = 0; n < NUM_THINKERLISTS; n++)
+			if (th == &thlist[n])
+				break;
+
+		if (n == NUM_THINKERLISTS)
+			return th;
+		if (n >= last)
+			return NULL;
+		th = thlist[n+1].next;
+	}
+}
+
 static int lib_iterateThinkers(lua_State *L)
 {
 	thinker_t *th = NULL, *next = NULL;
@@ -58,7 +86,7 @@ static int lib_iterateThinkers(lua_State *L)
 	lua_settop(L, 2);
 
 	if (lua_isnil(L, 2))
-		th = &thinkercap;
+		th = &thlist[it->first];
 	else if (lua_isuserdata(L, 2))
 	{
 		if (lua_islightuserdata(L, 2))
@@ -88,13 +116,14 @@ static int lib_iterateThinkers(lua_State *L)
 	if (!next)
 		return luaL_error(L, "next thinker invalidated during iteration");
 
-	for (; next != &thinkercap; next = next->next)
+	for (; (next = SkipListHeads(next, it->last)) != NULL; next = next->next)
 		if (!it->filter || next->function.acp1 == it->filter)
 		{
+			th = SkipListHeads(next->next, it->last);
 			push_thinker(next);
-			if (next->next != &thinkercap)
+			if (th)
 			{
-				push_thinker(next->next);
+				push_thinker(th);
 				it->next = luaL_ref(L, LUA_REGISTRYINDEX);
 			}
 			return 1;
@@ -105,19 +134,111 @@ static int lib_iterateThinkers(lua_State *L)
 static int lib_startIterate(lua_State *L)
 {
 	struct iterationState *it;
+	int option;
 
 	lua_pushvalue(L, lua_upvalueindex(1));
 	it = lua_newuserdata(L, sizeof(struct iterationState));
 	luaL_getmetatable(L, META_ITERATIONSTATE);
 	lua_setmetatable(L, -2);
 
-	it->filter = iter_funcs[luaL_checkoption(L, 1, "mobj", iter_opt)];
+	option = luaL_checkoption(L, 1, "mobj", iter_opt);
+	it->filter = iter_funcs[option];
+	it->first = iter_lists[option][0];
+	it->last = iter_lists[option][1];
+	it->type = NUMMOBJTYPES;
 	it->next = LUA_REFNIL;
 	return 2;
 }
 
 #undef push_thinker
 
+// The mobj after mo in a mobjs.iterate walk, or the first one if mo is NULL
+static mobj_t *NextIteratedMobj(mobj_t *mo, mobjtype_t type)
+{
+	thinker_t *th;
+
+	if (type < NUMMOBJTYPES)
+	{
+		// a removed mobj keeps its typenext, so the walk goes on past it
+		mo = mo ? mo->typenext : P_FirstMobjOfType(type);
+		while (mo && P_MobjWasRemoved(mo))
+			mo = mo->typenext;
+		return mo;
+	}
+
+	for (th = mo ? mo->thinker.next : thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
+			return (mobj_t *)th;
+	return NULL;
+}
+
+static int lib_iterateMobjs(lua_State *L)
+{
+	mobj_t *mo = NULL, *next = NULL;
+	struct iterationState *it = luaL_checkudata(L, 1, META_ITERATIONSTATE);
+	lua_settop(L, 2);
+
+	if (!lua_isnil(L, 2))
+	{
+		mo = *(mobj_t **)luaL_checkudata(L, 2, META_MOBJ);
+
+		// The last mobj was removed, or changed type under us;
+		// pick up from the one we saved after it.
+		if (!mo || (it->type < NUMMOBJTYPES && mo->type != it->type))
+		{
+			if (it->next == LUA_REFNIL)
+				return 0;
+
+			lua_rawgeti(L, LUA_REGISTRYINDEX, it->next);
+			next = *(mobj_t **)lua_touserdata(L, -1);
+			if (!next)
+				return luaL_error(L, "next mobj invalidated during iteration");
+		}
+	}
+
+	luaL_unref(L, LUA_REGISTRYINDEX, it->next);
+	it->next = LUA_REFNIL;
+
+	if (!next)
+		next = NextIteratedMobj(mo, it->type);
+	if (!next)
+		return 0;
+
+	mo = NextIteratedMobj(next, it->type);
+	LUA_PushUserdata(L, next, META_MOBJ);
+	if (mo)
+	{
+		LUA_PushUserdata(L, mo, META_MOBJ);
+		it->next = luaL_ref(L, LUA_REGISTRYINDEX);
+	}
+	return 1;
+}
+
+// mobjs.iterate([type]): every mobj, or only those of one type
+static int lib_startIterateMobjs(lua_State *L)
+{
+	struct iterationState *it;
+	mobjtype_t type = NUMMOBJTYPES;
+
+	if (!lua_isnoneornil(L, 1))
+	{
+		type = luaL_checkinteger(L, 1);
+		if (type >= NUMMOBJTYPES)
+			return luaL_error(L, "mobj type %d out of range (0 - %d)", type, NUMMOBJTYPES-1);
+	}
+
+	lua_pushvalue(L, lua_upvalueindex(1));
+	it = lua_newuserdata(L, sizeof(struct iterationState));
+	luaL_getmetatable(L, META_ITERATIONSTATE);
+	lua_setmetatable(L, -2);
+
+	it->filter = (actionf_p1)P_MobjThinker;
+	it->first = it->last = THINK_MOBJ;
+	it->type = type;
+	it->next = LUA_REFNIL;
+	return 2;
+}
+
 int LUA_ThinkerLib(lua_State *L)
 {
 	luaL_newmetatable(L, META_ITERATIONSTATE);
@@ -130,6 +251,12 @@ int LUA_ThinkerLib(lua_State *L)
 		lua_pushcclosure(L, lib_startIterate, 1);
 		lua_setfield(L, -2, "iterate");
 	lua_setglobal(L, "thinkers");
+
+	lua_createtable(L, 0, 1);
+		lua_pushcfunction(L, lib_iterateMobjs);
+		lua_pushcclosure(L, lib_startIterateMobjs, 1);
+		lua_setfield(L, -2, "iterate");
+	lua_setglobal(L, "mobjs");
 	return 0;
 }
 
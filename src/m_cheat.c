@@ -904,7 +904,7 @@ static mapthing_t *OP_CreateNewMapThing(player_t *player, UINT16 type, boolean c
 		thinker_t *th;
 		mobj_t *mo;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachThinker(th, THINK_MOBJ)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -9794,7 +9794,10 @@ static void M_DrawSetupMultiPlayerMenu(void)
 
 	// skin 0 is default player sprite
 	if (R_SkinAvailable(skins[setupm_fakeskin].name) != -1)
+	{
+		R_LoadSkinSprites(&skins[R_SkinAvailable(skins[setupm_fakeskin].name)]);
 		sprdef = &skins[R_SkinAvailable(skins[setupm_fakeskin].name)].spritedef;
+	}
 	else
 		sprdef = &skins[0].spritedef;
 
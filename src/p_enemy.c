@@ -2590,7 +2590,7 @@ void A_MonitorPop(mobj_t *actor)
 	remains = P_SpawnMobj(actor->x, actor->y,
 		((actor->eflags & MFE_VERTICALFLIP) ? (actor->z + actor->height - FixedMul(mobjinfo[actor->info->speed].height, actor->scale)) : actor->z),
 		actor->info->speed);
-	remains->type = actor->type; // Transfer type information
+	P_SetMobjType(remains, actor->type); // Transfer type information
 	P_UnsetThingPosition(remains);
 	if (sector_list)
 	{
@@ -2719,7 +2719,7 @@ void A_Explode(mobj_t *actor)
 void A_BossDeath(mobj_t *mo)
 {
 	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	line_t junk;
 	INT32 i;
 #ifdef HAVE_BLUA
@@ -2745,7 +2745,7 @@ void A_BossDeath(mobj_t *mo)
 
 	// scan the remaining thinkers to see
 	// if all bosses are dead
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachThinker(th, THINK_MOBJ)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -2804,22 +2804,14 @@ bossjustdie:
 
 		// Flee! Flee! Find a point to escape to! If none, just shoot upward!
 		// scan the thinkers to find the runaway point
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, next, MT_BOSSFLYPOINT)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type == MT_BOSSFLYPOINT)
-			{
-				// If this one's closer then the last one, go for it.
-				if (!mo->target ||
-					P_AproxDistance(P_AproxDistance(mo->x - mo2->x, mo->y - mo2->y), mo->z - mo2->z) <
-					P_AproxDistance(P_AproxDistance(mo->x - mo->target->x, mo->y - mo->target->y), mo->z - mo->target->z))
-						P_SetTarget(&mo->target, mo2);
-				// Otherwise... Don't!
-			}
+			// If this one's closer then the last one, go for it.
+			if (!mo->target ||
+				P_AproxDistance(P_AproxDistance(mo->x - mo2->x, mo->y - mo2->y), mo->z - mo2->z) <
+				P_AproxDistance(P_AproxDistance(mo->x - mo->target->x, mo->y - mo->target->y), mo->z - mo->target->z))
+					P_SetTarget(&mo->target, mo2);
+			// Otherwise... Don't!
 		}
 
 		mo->flags |= MF_NOGRAVITY|MF_NOCLIP;
@@ -5451,7 +5443,7 @@ void A_RingExplode(mobj_t *actor)
 
 	S_StartSound(actor, sfx_prloop);
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachThinker(th, THINK_MOBJ)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -7072,8 +7064,7 @@ void A_Boss3Path(mobj_t *actor)
 	}
 	else if (actor->threshold >= 0) // Traveling mode
 	{
-		thinker_t *th;
-		mobj_t *mo2;
+		mobj_t *mo2, *mo2next;
 		fixed_t dist, dist2;
 		fixed_t speed;
 
@@ -7082,13 +7073,9 @@ void A_Boss3Path(mobj_t *actor)
 		// scan the thinkers
 		// to find a point that matches
 		// the number
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, mo2next, MT_BOSS3WAYPOINT)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-			if (mo2->type == MT_BOSS3WAYPOINT && mo2->spawnpoint && mo2->spawnpoint->angle == actor->threshold)
+			if (mo2->spawnpoint && mo2->spawnpoint->angle == actor->threshold)
 			{
 				P_SetTarget(&actor->target, mo2);
 				break;
@@ -7461,8 +7448,7 @@ void A_FindTarget(mobj_t *actor)
 	INT32 locvar1 = var1;
 	INT32 locvar2 = var2;
 	mobj_t *targetedmobj = NULL;
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	fixed_t dist1 = 0, dist2 = 0;
 #ifdef HAVE_BLUA
 	if (LUA_CallAction("A_FindTarget", actor))
@@ -7472,33 +7458,25 @@ void A_FindTarget(mobj_t *actor)
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTarget called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
 	// scan the thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, locvar1)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)locvar1)
+		if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
+			continue; // Ignore spectators
+		if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
+			continue; // Ignore dead things
+		if (targetedmobj == NULL)
 		{
-			if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
-				continue; // Ignore spectators
-			if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
-				continue; // Ignore dead things
-			if (targetedmobj == NULL)
+			targetedmobj = mo2;
+			dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+		}
+		else
+		{
+			dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+			if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
 			{
 				targetedmobj = mo2;
-				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-			}
-			else
-			{
-				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-				if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
-				{
-					targetedmobj = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -7526,8 +7504,7 @@ void A_FindTracer(mobj_t *actor)
 	INT32 locvar1 = var1;
 	INT32 locvar2 = var2;
 	mobj_t *targetedmobj = NULL;
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	fixed_t dist1 = 0, dist2 = 0;
 #ifdef HAVE_BLUA
 	if (LUA_CallAction("A_FindTracer", actor))
@@ -7537,33 +7514,25 @@ void A_FindTracer(mobj_t *actor)
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTracer called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
 	// scan the thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, locvar1)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)locvar1)
+		if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
+			continue; // Ignore spectators
+		if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
+			continue; // Ignore dead things
+		if (targetedmobj == NULL)
 		{
-			if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
-				continue; // Ignore spectators
-			if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
-				continue; // Ignore dead things
-			if (targetedmobj == NULL)
+			targetedmobj = mo2;
+			dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+		}
+		else
+		{
+			dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+			if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
 			{
 				targetedmobj = mo2;
-				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-			}
-			else
-			{
-				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-				if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
-				{
-					targetedmobj = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -8095,34 +8064,25 @@ void A_RemoteAction(mobj_t *actor)
 	{
 		///* DO A_FINDTARGET STUFF *///
 		mobj_t *targetedmobj = NULL;
-		thinker_t *th;
-		mobj_t *mo2;
+		mobj_t *mo2, *next;
 		fixed_t dist1 = 0, dist2 = 0;
 
 		// scan the thinkers
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, next, locvar1)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type == (mobjtype_t)locvar1)
+			if (targetedmobj == NULL)
+			{
+				targetedmobj = mo2;
+				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+			}
+			else
 			{
-				if (targetedmobj == NULL)
+				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+				if ((locvar2 && dist1 < dist2) || (!locvar2 && dist1 > dist2))
 				{
 					targetedmobj = mo2;
-					dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-				}
-				else
-				{
-					dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-					if ((locvar2 && dist1 < dist2) || (!locvar2 && dist1 > dist2))
-					{
-						targetedmobj = mo2;
-						dist2 = dist1;
-					}
+					dist2 = dist1;
 				}
 			}
 		}
@@ -8230,7 +8190,7 @@ void A_ItemPop(mobj_t *actor)
 	P_SetScale(remains, actor->scale);
 
 	remains = P_SpawnMobj(actor->x, actor->y, actor->z, actor->info->damage);
-	remains->type = actor->type; // Transfer type information
+	P_SetMobjType(remains, actor->type); // Transfer type information
 	P_UnsetThingPosition(remains);
 	if (sector_list)
 	{
@@ -8870,9 +8830,8 @@ void A_MayonakaArrow(mobj_t *actor)
 void A_MementosTPParticles(mobj_t *actor)
 {
 	mobj_t *particle;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	int i = 0;
-	thinker_t *th;
 
 #ifdef HAVE_BLUA
 	if (LUA_CallAction("A_MementosTPParticles", (actor)))
@@ -8892,13 +8851,9 @@ void A_MementosTPParticles(mobj_t *actor)
 	// Doesn't seem like much given the small amount of mobjs this map has but heh.
 	if (!actor->target)
 	{
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, next, MT_MEMENTOSTP)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-			if (mo2->type == MT_MEMENTOSTP && mo2 != actor)
+			if (mo2 != actor)
 			{
 				P_SetTarget(&actor->target, mo2);	// The main target we're pursing.
 				break;
@@ -8917,8 +8872,7 @@ void A_ReaperThinker(mobj_t *actor)
 	angle_t an = ANGLE_22h;		// Reminder that angle constants suck.
 
 	//Waypoint stuff:
-	mobj_t *mo2;
-	thinker_t *th;
+	mobj_t *mo2, *next;
 
 	//Player targetting stuff:
 	UINT32 maxscore = 0;	// we target the player with the highest score so yeah there you go.
@@ -8994,15 +8948,8 @@ void A_ReaperThinker(mobj_t *actor)
 		}
 
 		// We have no target and oughta find one, so let's scan through thinkers for a waypoint of angle 0, or something.
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, next, MT_REAPERWAYPOINT)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_REAPERWAYPOINT)
-				continue;
 			if (mo2->spawnpoint->angle != 0)
 				continue;
 
@@ -9060,15 +9007,8 @@ void A_ReaperThinker(mobj_t *actor)
 				P_SetTarget(&actor->target, NULL);	// remove target so we can default back to first waypoint if things go ham.
 
 				// If we reach close to a waypoint, then we should go to the NEXT one.
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				P_ForEachMobjOfType(mo2, next, MT_REAPERWAYPOINT)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-						continue;
-
-					mo2 = (mobj_t *)th;
-
-					if (mo2->type != MT_REAPERWAYPOINT)
-						continue;
 					if (mo2->spawnpoint->angle != actor->extravalue1+1)
 						continue;
 
@@ -9232,8 +9172,7 @@ void A_SetObjectTypeState(mobj_t *actor)
 	const UINT16 loc2lw = (UINT16)(locvar2 & 65535);
 	const UINT16 loc2up = (UINT16)(locvar2 >> 16);
 
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	fixed_t dist = 0;
 
 #ifdef HAVE_BLUA
@@ -9241,26 +9180,18 @@ void A_SetObjectTypeState(mobj_t *actor)
 		return;
 #endif
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, loc2lw)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
+		dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
 
-		if (mo2->type == (mobjtype_t)loc2lw)
+		if (mo2->health > 0)
 		{
-			dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
-
-			if (mo2->health > 0)
+			if (loc2up == 0)
+				P_SetMobjState(mo2, locvar1);
+			else
 			{
-				if (loc2up == 0)
+				if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
 					P_SetMobjState(mo2, locvar1);
-				else
-				{
-					if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
-						P_SetMobjState(mo2, locvar1);
-				}
 			}
 		}
 	}
@@ -9871,32 +9802,23 @@ void A_CheckThingCount(mobj_t *actor)
 	const UINT16 loc2up = (UINT16)(locvar2 >> 16);
 
 	INT32 count = 0;
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	fixed_t dist = 0;
 #ifdef HAVE_BLUA
 	if (LUA_CallAction("A_CheckThingCount", actor))
 		return;
 #endif
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, loc1up)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
+		dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
 
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)loc1up)
+		if (loc2up == 0)
+			count++;
+		else
 		{
-			dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
-
-			if (loc2up == 0)
+			if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
 				count++;
-			else
-			{
-				if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
-					count++;
-			}
 		}
 	}
 
@@ -55,7 +55,7 @@ result_e T_MovePlane(sector_t *sector, fixed_t speed, fixed_t dest, boolean crus
 	boolean sectorisffloor = false;
 	boolean sectorisquicksand = false;
 
-	sector->moved = true;
+	P_FlagSectorMoved(sector);
 
 	switch (floorOrCeiling)
 	{
@@ -327,7 +327,7 @@ void T_MoveFloor(floormove_t *movefloor)
 					movefloor->direction = (movefloor->floordestheight < movefloor->sector->floorheight) ? -1 : 1;
 					movefloor->sector->floorspeed = movefloor->speed * movefloor->direction;
 					movefloor->delaytimer = movefloor->delay;
-					P_RecalcPrecipInSector(movefloor->sector);
+					P_FlagSectorMoved(movefloor->sector);
 					return; // not break, why did this work? Graue 04-03-2004
 				case bounceFloorCrush: // Graue 03-27-2004
 					if (movefloor->floordestheight == lines[movefloor->texture].frontsector->floorheight)
@@ -343,14 +343,14 @@ void T_MoveFloor(floormove_t *movefloor)
 					movefloor->direction = (movefloor->floordestheight < movefloor->sector->floorheight) ? -1 : 1;
 					movefloor->sector->floorspeed = movefloor->speed * movefloor->direction;
 					movefloor->delaytimer = movefloor->delay;
-					P_RecalcPrecipInSector(movefloor->sector);
+					P_FlagSectorMoved(movefloor->sector);
 					return; // not break, why did this work? Graue 04-03-2004
 				case crushFloorOnce:
 					movefloor->floordestheight = lines[movefloor->texture].frontsector->floorheight;
 					movefloor->direction = -1;
 					movefloor->sector->soundorg.z = movefloor->sector->floorheight;
 					S_StartSound(&movefloor->sector->soundorg,sfx_pstop);
-					P_RecalcPrecipInSector(movefloor->sector);
+					P_FlagSectorMoved(movefloor->sector);
 					return;
 				default:
 					break;
@@ -376,7 +376,7 @@ void T_MoveFloor(floormove_t *movefloor)
 					movefloor->direction = (movefloor->floordestheight < movefloor->sector->floorheight) ? -1 : 1;
 					movefloor->sector->floorspeed = movefloor->speed * movefloor->direction;
 					movefloor->delaytimer = movefloor->delay;
-					P_RecalcPrecipInSector(movefloor->sector);
+					P_FlagSectorMoved(movefloor->sector);
 					return; // not break, why did this work? Graue 04-03-2004
 				case bounceFloorCrush: // Graue 03-27-2004
 					if (movefloor->floordestheight == lines[movefloor->texture].frontsector->floorheight)
@@ -392,13 +392,13 @@ void T_MoveFloor(floormove_t *movefloor)
 					movefloor->direction = (movefloor->floordestheight < movefloor->sector->floorheight) ? -1 : 1;
 					movefloor->sector->floorspeed = movefloor->speed * movefloor->direction;
 					movefloor->delaytimer = movefloor->delay;
-					P_RecalcPrecipInSector(movefloor->sector);
+					P_FlagSectorMoved(movefloor->sector);
 					return; // not break, why did this work? Graue 04-03-2004
 				case crushFloorOnce:
 					movefloor->sector->floordata = NULL; // Clear up the thinker so others can use it
 					P_RemoveThinker(&movefloor->thinker);
 					movefloor->sector->floorspeed = 0;
-					P_RecalcPrecipInSector(movefloor->sector);
+					P_FlagSectorMoved(movefloor->sector);
 					return;
 				default:
 					break;
@@ -415,7 +415,7 @@ void T_MoveFloor(floormove_t *movefloor)
 	else
 		movefloor->sector->floorspeed = 0;
 
-	P_RecalcPrecipInSector(movefloor->sector);
+	P_FlagSectorMoved(movefloor->sector);
 }
 
 //
@@ -721,7 +721,7 @@ void T_ContinuousFalling(levelspecthink_t *faller)
 
 	faller->sector->floorspeed = faller->speed*faller->direction;
 	faller->sector->ceilspeed = 42;
-	faller->sector->moved = true;
+	P_FlagSectorMoved(faller->sector);
 #undef speed
 #undef direction
 #undef floorwasheight
@@ -802,7 +802,7 @@ void T_BounceCheese(levelspecthink_t *bouncer)
 	for (i = -1; (i = P_FindSectorFromTag(bouncer->sourceline->tag, i)) >= 0 ;)
 	{
 		actionsector = &sectors[i];
-		actionsector->moved = true;
+		P_FlagSectorMoved(actionsector);
 
 		halfheight = abs(bouncer->sector->ceilingheight - bouncer->sector->floorheight) >> 1;
 
@@ -817,12 +817,12 @@ void T_BounceCheese(levelspecthink_t *bouncer)
 			bouncer->sector->floorheight = bouncer->sector->ceilingheight - (halfheight*2);
 			T_MovePlane(bouncer->sector, 0, bouncer->sector->ceilingheight, 0, 1, -1); // update things on ceiling
 			T_MovePlane(bouncer->sector, 0, bouncer->sector->floorheight, 0, 0, -1); // update things on floor
-			P_RecalcPrecipInSector(actionsector);
+			P_FlagSectorMoved(actionsector);
 			bouncer->sector->ceilingdata = NULL;
 			bouncer->sector->floordata = NULL;
 			bouncer->sector->floorspeed = 0;
 			bouncer->sector->ceilspeed = 0;
-			bouncer->sector->moved = true;
+			P_FlagSectorMoved(bouncer->sector);
 			P_RemoveThinker(&bouncer->thinker); // remove bouncer from actives
 			return;
 		}
@@ -833,12 +833,12 @@ void T_BounceCheese(levelspecthink_t *bouncer)
 			bouncer->sector->floorheight = floorheight;
 			T_MovePlane(bouncer->sector, 0, bouncer->sector->ceilingheight, 0, 1, -1); // update things on ceiling
 			T_MovePlane(bouncer->sector, 0, bouncer->sector->floorheight, 0, 0, -1); // update things on floor
-			P_RecalcPrecipInSector(actionsector);
+			P_FlagSectorMoved(actionsector);
 			bouncer->sector->ceilingdata = NULL;
 			bouncer->sector->floordata = NULL;
 			bouncer->sector->floorspeed = 0;
 			bouncer->sector->ceilspeed = 0;
-			bouncer->sector->moved = true;
+			P_FlagSectorMoved(bouncer->sector);
 			P_RemoveThinker(&bouncer->thinker); // remove bouncer from actives
 			return;
 		}
@@ -907,7 +907,7 @@ void T_BounceCheese(levelspecthink_t *bouncer)
 			bouncer->sector->floordata = NULL;
 			bouncer->sector->floorspeed = 0;
 			bouncer->sector->ceilspeed = 0;
-			bouncer->sector->moved = true;
+			P_FlagSectorMoved(bouncer->sector);
 			P_RemoveThinker(&bouncer->thinker);    // remove bouncer from actives
 		}
 
@@ -915,7 +915,7 @@ void T_BounceCheese(levelspecthink_t *bouncer)
 			bouncer->distance--;
 
 		if (actionsector)
-			P_RecalcPrecipInSector(actionsector);
+			P_FlagSectorMoved(actionsector);
 	}
 #undef speed
 #undef distance
@@ -1094,15 +1094,14 @@ void T_StartCrumble(elevator_t *elevator)
 		elevator->sector->ceilingdata = NULL;
 		elevator->sector->ceilspeed = 0;
 		elevator->sector->floorspeed = 0;
-		elevator->sector->moved = true;
+		P_FlagSectorMoved(elevator->sector);
 		P_RemoveThinker(&elevator->thinker);
 	}
 
 	for (i = -1; (i = P_FindSectorFromTag(elevator->sourceline->tag, i)) >= 0 ;)
 	{
 		sector = &sectors[i];
-		sector->moved = true;
-		P_RecalcPrecipInSector(sector);
+		P_FlagSectorMoved(sector);
 	}
 }
 
@@ -1156,7 +1155,7 @@ void T_MarioBlock(levelspecthink_t *block)
 	}
 
 	for (i = -1; (i = P_FindSectorFromTag((INT16)block->vars[0], i)) >= 0 ;)
-		P_RecalcPrecipInSector(&sectors[i]);
+		P_FlagSectorMoved(&sectors[i]);
 
 #undef speed
 #undef direction
@@ -1272,7 +1271,7 @@ void T_FloatSector(levelspecthink_t *floater)
 		else if (floater->sector->crumblestate == 0 || floater->sector->crumblestate >= 3/* || floatanyway*/)
 			EV_BounceSector(floater->sector, FRACUNIT, floater->sourceline);
 
-		P_RecalcPrecipInSector(actionsector);
+		P_FlagSectorMoved(actionsector);
 	}
 }
 
@@ -1654,7 +1653,7 @@ wegotit:
 		}
 
 	//	for (i = -1; (i = P_FindSectorFromTag(bridge->sourceline->tag, i)) >= 0 ;)
-	//		P_RecalcPrecipInSector(&sectors[i]);
+	//		P_FlagSectorMoved(&sectors[i]);
 	}
 	else
 	{
@@ -1969,7 +1968,7 @@ void T_ThwompSector(levelspecthink_t *thwomp)
 	else // Not going anywhere, so look for players.
 	{
 		//thinker_t *th;
-		//mobj_t *mo;
+		//mobj_t *mo, *next;
 
 		thwomp->direction = -1;
 
@@ -1978,13 +1977,9 @@ void T_ThwompSector(levelspecthink_t *thwomp)
 		if (!rover || (rover->flags & FF_EXISTS))
 		{
 			// scan the thinkers to find players!
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			P_ForEachMobjOfType(mo, next, MT_PLAYER)
 			{
-				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-					continue;
-
-				mo = (mobj_t *)th;
-				if (mo->type == MT_PLAYER && mo->health && mo->player && !mo->player->spectator
+				if (mo->health && mo->player && !mo->player->spectator
 				    && mo->z <= thwomp->sector->ceilingheight
 					&& P_AproxDistance(thwompx - mo->x, thwompy - mo->y) <= 96*FRACUNIT)
 				{
@@ -1998,7 +1993,7 @@ void T_ThwompSector(levelspecthink_t *thwomp)
 		thwomp->sector->floorspeed = 0;
 	}
 
-	P_RecalcPrecipInSector(actionsector);
+	P_FlagSectorMoved(actionsector);
 #undef speed
 #undef direction
 #undef distance
@@ -2524,7 +2519,7 @@ void T_RaiseSector(levelspecthink_t *raise)
 	raise->sector->floorspeed = raise->vars[3]*raise->vars[8];
 
 	for (i = -1; (i = P_FindSectorFromTag(raise->sourceline->tag, i)) >= 0 ;)
-		P_RecalcPrecipInSector(&sectors[i]);
+		P_FlagSectorMoved(&sectors[i]);
 }
 
 void T_CameraScanner(elevator_t *elevator)
@@ -2678,7 +2673,7 @@ INT32 EV_DoFloor(line_t *line, floor_e floortype)
 		// new floor thinker
 		rtn = 1;
 		dofloor = Z_Calloc(sizeof (*dofloor), PU_LEVSPEC, NULL);
-		P_AddThinker(&dofloor->thinker);
+		P_AddThinker(THINK_MAIN, &dofloor->thinker);
 
 		// make sure another floor thinker won't get started over this one
 		sec->floordata = dofloor;
@@ -2902,7 +2897,7 @@ INT32 EV_DoElevator(line_t *line, elevator_e elevtype, boolean customspeed)
 		// create and initialize new elevator thinker
 		rtn = 1;
 		elevator = Z_Calloc(sizeof (*elevator), PU_LEVSPEC, NULL);
-		P_AddThinker(&elevator->thinker);
+		P_AddThinker(THINK_MAIN, &elevator->thinker);
 		sec->floordata = elevator;
 		sec->ceilingdata = elevator;
 		elevator->thinker.function.acp1 = (actionf_p1)T_MoveElevator;
@@ -3088,7 +3083,7 @@ INT32 EV_BounceSector(sector_t *sec, fixed_t momz, line_t *sourceline)
 		return 0;
 
 	bouncer = Z_Calloc(sizeof (*bouncer), PU_LEVSPEC, NULL);
-	P_AddThinker(&bouncer->thinker);
+	P_AddThinker(THINK_MAIN, &bouncer->thinker);
 	sec->ceilingdata = bouncer;
 	bouncer->thinker.function.acp1 = (actionf_p1)T_BounceCheese;
 
@@ -3126,7 +3121,7 @@ INT32 EV_DoContinuousFall(sector_t *sec, sector_t *backsector, fixed_t spd, bool
 
 	// create and initialize new thinker
 	faller = Z_Calloc(sizeof (*faller), PU_LEVSPEC, NULL);
-	P_AddThinker(&faller->thinker);
+	P_AddThinker(THINK_MAIN, &faller->thinker);
 	faller->thinker.function.acp1 = (actionf_p1)T_ContinuousFalling;
 
 	// set up the fields
@@ -3179,7 +3174,7 @@ INT32 EV_StartCrumble(sector_t *sec, ffloor_t *rover, boolean floating,
 
 	// create and initialize new elevator thinker
 	elevator = Z_Calloc(sizeof (*elevator), PU_LEVSPEC, NULL);
-	P_AddThinker(&elevator->thinker);
+	P_AddThinker(THINK_MAIN, &elevator->thinker);
 	elevator->thinker.function.acp1 = (actionf_p1)T_StartCrumble;
 
 	// Does this crumbler return?
@@ -3257,7 +3252,7 @@ INT32 EV_MarioBlock(sector_t *sec, sector_t *roversector, fixed_t topheight, mob
 		// create and initialize new elevator thinker
 
 		block = Z_Calloc(sizeof (*block), PU_LEVSPEC, NULL);
-		P_AddThinker(&block->thinker);
+		P_AddThinker(THINK_MAIN, &block->thinker);
 		sec->floordata = block;
 		sec->ceilingdata = block;
 		block->thinker.function.acp1 = (actionf_p1)T_MarioBlock;
@@ -1012,7 +1012,7 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 				count = 1;
 
 				// scan the remaining thinkers
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				P_ForEachThinker(th, THINK_MOBJ)
 				{
 					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 						continue;
@@ -1062,7 +1062,7 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 
 				// Now we RE-scan all the thinkers to find close objects to pull
 				// in from the paraloop. Isn't this just so efficient?
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				P_ForEachThinker(th, THINK_MOBJ)
 				{
 					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 						continue;
@@ -1421,7 +1421,6 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 		case MT_AXE:
 			{
 				line_t junk;
-				thinker_t  *th;
 				mobj_t *mo2;
 
 				if (player->bot)
@@ -1430,19 +1429,9 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 				junk.tag = 649;
 				EV_DoElevator(&junk, bridgeFall, false);
 
-				// scan the remaining thinkers to find koopa
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
-				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-						continue;
-
-					mo2 = (mobj_t *)th;
-					if (mo2->type == MT_KOOPA)
-					{
-						mo2->momz = 5*FRACUNIT;
-						break;
-					}
-				}
+				// find koopa
+				if ((mo2 = P_FirstMobjOfType(MT_KOOPA)) != NULL)
+					mo2->momz = 5*FRACUNIT;
 			}
 			break;
 		case MT_FIREFLOWER:
@@ -2131,7 +2120,7 @@ boolean P_CheckRacers(void)
 void P_KillMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 {
 	mobjtype_t item;
-	mobj_t *mo;
+	mobj_t *mo, *monext;
 
 	//if (inflictor && (inflictor->type == MT_SHELL || inflictor->type == MT_FIREBALL))
 	//	P_SetTarget(&target->tracer, inflictor);
@@ -2568,18 +2557,13 @@ void P_KillMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 
 	if (target->type == MT_EGGMOBILE3)
 	{
-		thinker_t *th;
 		UINT32 i = 0; // to check how many clones we've removed
 
 		// scan the thinkers to make sure all the old pinch dummies are gone on death
 		// this can happen if the boss was hurt earlier than expected
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo, monext, target->info->mass)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo = (mobj_t *)th;
-			if (mo->type == (mobjtype_t)target->info->mass && mo->tracer == target)
+			if (mo->tracer == target)
 			{
 				P_RemoveMobj(mo);
 				i++;
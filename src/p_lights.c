@@ -19,6 +19,9 @@
 #include "m_random.h"
 #include "d_netcmd.h"
 
+// Storms spawn and remove lightning flashes all through the level.
+static zpool_t lightflashpool = Z_POOL("lightflash_t", lightflash_t, PU_LEVSPEC);
+
 /** Removes any active lighting effects in a sector.
   *
   * \param sector The sector to remove effects from.
@@ -76,7 +79,7 @@ fireflicker_t *P_SpawnAdjustableFireFlicker(sector_t *minsector, sector_t *maxse
 	P_RemoveLighting(maxsector); // out with the old, in with the new
 	flick = Z_Calloc(sizeof (*flick), PU_LEVSPEC, NULL);
 
-	P_AddThinker(&flick->thinker);
+	P_AddThinker(THINK_MAIN, &flick->thinker);
 
 	flick->thinker.function.acp1 = (actionf_p1)T_FireFlicker;
 	flick->sector = maxsector;
@@ -153,9 +156,9 @@ void P_SpawnLightningFlash(sector_t *sector)
 
 	sector->lightingdata = NULL;
 
-	flash = Z_Calloc(sizeof (*flash), PU_LEVSPEC, NULL);
+	flash = Z_PoolCalloc(&lightflashpool);
 
-	P_AddThinker(&flash->thinker);
+	P_AddThinker(THINK_MAIN, &flash->thinker);
 
 	flash->thinker.function.acp1 = (actionf_p1)T_LightningFlash;
 	flash->sector = sector;
@@ -214,7 +217,7 @@ strobe_t *P_SpawnAdjustableStrobeFlash(sector_t *minsector, sector_t *maxsector,
 	P_RemoveLighting(maxsector); // out with the old, in with the new
 	flash = Z_Calloc(sizeof (*flash), PU_LEVSPEC, NULL);
 
-	P_AddThinker(&flash->thinker);
+	P_AddThinker(THINK_MAIN, &flash->thinker);
 
 	flash->sector = maxsector;
 	flash->darktime = darktime;
@@ -289,7 +292,7 @@ glow_t *P_SpawnAdjustableGlowingLight(sector_t *minsector, sector_t *maxsector,
 	P_RemoveLighting(maxsector); // out with the old, in with the new
 	g = Z_Calloc(sizeof (*g), PU_LEVSPEC, NULL);
 
-	P_AddThinker(&g->thinker);
+	P_AddThinker(THINK_MAIN, &g->thinker);
 
 	g->sector = maxsector;
 	g->minlight = minsector->lightlevel;
@@ -350,7 +353,7 @@ void P_FadeLight(INT16 tag, INT32 destvalue, INT32 speed)
 		ll->thinker.function.acp1 = (actionf_p1)T_LightFade;
 		sector->lightingdata = ll; // set it to the lightlevel_t
 
-		P_AddThinker(&ll->thinker); // add thinker
+		P_AddThinker(THINK_MAIN, &ll->thinker); // add thinker
 
 		ll->sector = sector;
 		ll->destlevel = destvalue;
@@ -64,11 +64,24 @@
 // P_TICK
 //
 
-// both the head and tail of the thinker list
-extern thinker_t thinkercap;
+// Thinkers are kept in one list per class, run in this order each tic
+typedef enum
+{
+	THINK_POLYOBJ, // polyobject movers, first so carrying physics works right
+	THINK_MAIN,    // sector movers, lights and other level specials
+	THINK_MOBJ,    // map objects, only ever P_MobjThinker or pending removal
+	NUM_THINKERLISTS
+} thinklistnum_t;
+
+// both the head and tail of each thinker list
+extern thinker_t thlist[NUM_THINKERLISTS];
+
+// Walks thinker list n from the front. Removed thinkers stay linked until
+// the end of the tic, so check the function before trusting a mobj.
+#define P_ForEachThinker(th, n) for ((th) = thlist[n].next; (th) != &thlist[n]; (th) = (th)->next)
 
 void P_InitThinkers(void);
-void P_AddThinker(thinker_t *thinker);
+void P_AddThinker(const thinklistnum_t n, thinker_t *thinker);
 void P_RemoveThinker(thinker_t *thinker);
 
 //
@@ -235,12 +248,24 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type);
 
 mobj_t *P_SpawnShadowMobj(mobj_t * caster);
 
-void P_RecalcPrecipInSector(sector_t *sector);
 void P_PrecipitationEffects(void);
 
 void P_RemoveMobj(mobj_t *th);
 boolean P_MobjWasRemoved(mobj_t *th);
 void P_RemoveSavegameMobj(mobj_t *th);
+
+void P_ClearMobjTypeLists(void);
+void P_LinkMobjType(mobj_t *mobj);
+void P_SetMobjType(mobj_t *mobj, mobjtype_t type);
+mobj_t *P_FirstMobjOfType(mobjtype_t type);
+
+// Walks the live mobjs of a type in thinker order. next is read before the
+// body runs, so the body may remove the current mobj or change its type;
+// anything else it removes is skipped over. Changing the type of some
+// other mobj of this type takes the walk off into that type's list.
+#define P_ForEachMobjOfType(mo, next, type) \
+	for ((mo) = P_FirstMobjOfType(type); (mo) && ((next) = (mo)->typenext, true); (mo) = (next)) \
+		if (P_MobjWasRemoved(mo)) ; else
 boolean P_SetPlayerMobjState(mobj_t *mobj, statenum_t state);
 boolean P_SetMobjState(mobj_t *mobj, statenum_t state);
 //void P_RunShields(void);
@@ -340,8 +365,6 @@ extern line_t *ceilingline;
 extern line_t *blockingline;
 extern msecnode_t *sector_list;
 
-extern mprecipsecnode_t *precipsector_list;
-
 void P_UnsetThingPosition(mobj_t *thing);
 void P_SetThingPosition(mobj_t *thing);
 void P_SetUnderlayPosition(mobj_t *thing);
@@ -361,7 +384,6 @@ void P_CheckHoopPosition(mobj_t *hoopthing, fixed_t x, fixed_t y, fixed_t z, fix
 boolean P_CheckSector(sector_t *sector, boolean crunch);
 
 void P_DelSeclist(msecnode_t *node);
-void P_DelPrecipSeclist(mprecipsecnode_t *node);
 
 void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y);
 void P_Initsecnode(void);
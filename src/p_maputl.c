@@ -794,17 +794,6 @@ void P_UnsetThingPosition(mobj_t *thing)
 	}
 }
 
-void P_UnsetPrecipThingPosition(precipmobj_t *thing)
-{
-	precipmobj_t **sprev = thing->sprev;
-	precipmobj_t  *snext = thing->snext;
-	if ((*sprev = snext) != NULL)  // unlink from sector list
-		snext->sprev = sprev;
-
-	precipsector_list = thing->touching_sectorlist;
-	thing->touching_sectorlist = NULL; //to be restored by P_SetPrecipThingPosition
-}
-
 //
 // P_SetThingPosition
 // Links a thing into both a block and a subsector
@@ -931,22 +920,6 @@ void P_SetUnderlayPosition(mobj_t *thing)
 	sector_list = NULL; // clear for next time
 }
 
-void P_SetPrecipitationThingPosition(precipmobj_t *thing)
-{
-	subsector_t *ss = thing->subsector = R_PointInSubsector(thing->x, thing->y);
-
-	precipmobj_t **link = &ss->sector->preciplist;
-	precipmobj_t *snext = *link;
-	if ((thing->snext = snext) != NULL)
-		snext->sprev = &thing->snext;
-	thing->sprev = link;
-	*link = thing;
-
-	P_CreatePrecipSecNodeList(thing, thing->x, thing->y);
-	thing->touching_sectorlist = precipsector_list; // Attach to Thing's precipmobj_t
-	precipsector_list = NULL; // clear for next time
-}
-
 //
 // BLOCK MAP ITERATORS
 // For each line/thing in the given mapblock,
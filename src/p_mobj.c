@@ -49,6 +49,10 @@ static mobj_t *overlaycap = NULL;
 static mobj_t *shadowcap = NULL;
 mobj_t *waypointcap = NULL;
 
+// Mobjs come and go constantly (sparks, trails, dust), so they get their
+// own pool instead of going through Z_Calloc every time.
+zpool_t mobjpool = Z_POOL("mobj_t", mobj_t, PU_LEVEL);
+
 void P_InitCachedActions(void)
 {
 	actioncachehead.prev = actioncachehead.next = &actioncachehead;
@@ -341,25 +345,6 @@ boolean P_SetMobjStateNF(mobj_t *mobj, statenum_t state)
 	return true;
 }
 
-static boolean P_SetPrecipMobjState(precipmobj_t *mobj, statenum_t state)
-{
-	state_t *st;
-
-	if (state == S_NULL)
-	{ // Remove mobj
-		P_RemovePrecipMobj(mobj);
-		return false;
-	}
-	st = &states[state];
-	mobj->state = st;
-	mobj->tics = st->tics;
-	mobj->sprite = st->sprite;
-	mobj->frame = st->frame;
-	mobj->anim_duration = (UINT16)st->var2; // only used if FF_ANIMATE is set
-
-	return true;
-}
-
 //
 // P_MobjFlip
 //
@@ -423,7 +408,7 @@ boolean P_WeaponOrPanel(mobjtype_t type)
 		spawnpoints[i] = NULL;
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	P_ForEachThinker(think, THINK_MOBJ)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -3418,7 +3403,7 @@ void P_DestroyRobots(void)
 	mobj_t *mo;
 	thinker_t *think;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	P_ForEachThinker(think, THINK_MOBJ)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -3752,123 +3737,6 @@ animonly:
 	}
 }
 
-static void CalculatePrecipFloor(precipmobj_t *mobj)
-{
-	// recalculate floorz each time
-	const sector_t *mobjsecsubsec;
-	if (mobj && mobj->subsector && mobj->subsector->sector)
-		mobjsecsubsec = mobj->subsector->sector;
-	else
-		return;
-	mobj->floorz =
-				mobjsecsubsec->f_slope ? P_GetZAt(mobjsecsubsec->f_slope, mobj->x, mobj->y) :
-				mobjsecsubsec->floorheight;
-	if (mobjsecsubsec->ffloors)
-	{
-		ffloor_t *rover;
-		fixed_t topheight;
-
-		for (rover = mobjsecsubsec->ffloors; rover; rover = rover->next)
-		{
-			// If it exists, it'll get rained on.
-			if (!(rover->flags & FF_EXISTS))
-				continue;
-
-			if (!(rover->flags & FF_BLOCKOTHERS) && !(rover->flags & FF_SWIMMABLE))
-				continue;
-
-			if (*rover->t_slope)
-				topheight = P_GetZAt(*rover->t_slope, mobj->x, mobj->y);
-			else
-			topheight = *rover->topheight;
-
-			if (topheight > mobj->floorz)
-				mobj->floorz = topheight;
-		}
-	}
-}
-
-void P_RecalcPrecipInSector(sector_t *sector)
-{
-	mprecipsecnode_t *psecnode;
-
-	if (!sector)
-		return;
-
-	sector->moved = true; // Recalc lighting and things too, maybe
-
-	for (psecnode = sector->touching_preciplist; psecnode; psecnode = psecnode->m_thinglist_next)
-		CalculatePrecipFloor(psecnode->m_thing);
-}
-
-//
-// P_NullPrecipThinker
-//
-// For "Blank" precipitation
-//
-void P_NullPrecipThinker(precipmobj_t *mobj)
-{
-	//(void)mobj;
-	mobj->precipflags &= ~PCF_THUNK;
-}
-
-void P_SnowThinker(precipmobj_t *mobj)
-{
-	R_ResetPrecipitationMobjInterpolationState(mobj);
-
-	P_CycleStateAnimation((mobj_t *)mobj);
-
-	// adjust height
-	if ((mobj->z += mobj->momz) <= mobj->floorz)
-	{
-		mobj->z = mobj->ceilingz;
-		R_ResetPrecipitationMobjInterpolationState(mobj);
-	}
-}
-
-void P_RainThinker(precipmobj_t *mobj)
-{
-	R_ResetPrecipitationMobjInterpolationState(mobj);
-
-	P_CycleStateAnimation((mobj_t *)mobj);
-
-	if (mobj->state != &states[S_RAIN1])
-	{
-		// cycle through states,
-		// calling action functions at transitions
-		if (mobj->tics <= 0)
-			return;
-
-		if (--mobj->tics)
-			return;
-
-		if (!P_SetPrecipMobjState(mobj, mobj->state->nextstate))
-			return;
-
-		if (mobj->state != &states[S_RAINRETURN])
-			return;
-
-		mobj->z = mobj->ceilingz;
-		R_ResetPrecipitationMobjInterpolationState(mobj);
-		P_SetPrecipMobjState(mobj, S_RAIN1);
-
-		return;
-	}
-
-	// adjust height
-	if ((mobj->z += mobj->momz) <= mobj->floorz)
-	{
-		// no splashes on sky or bottomless pits
-		if (mobj->precipflags & PCF_PIT)
-			mobj->z = mobj->ceilingz;
-		else
-		{
-			mobj->z = mobj->floorz;
-			P_SetPrecipMobjState(mobj, S_SPLASH1);
-		}
-	}
-}
-
 static void P_RingThinker(mobj_t *mobj)
 {
 	if (mobj->momx || mobj->momy)
@@ -4220,8 +4088,7 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 		if (!mobj->reactiontime && mobj->health <= mobj->info->damage)
 		{ // Spawn pinch dummies from the center when we're leaving it.
-			thinker_t *th;
-			mobj_t *mo2;
+			mobj_t *mo2, *mo2next;
 			mobj_t *dummy;
 			SINT8 way = mobj->threshold - 1; // 0 through 4.
 			SINT8 way2;
@@ -4230,13 +4097,9 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 			// scan the thinkers to make sure all the old pinch dummies are gone before making new ones
 			// this can happen if the boss was hurt earlier than expected
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			P_ForEachMobjOfType(mo2, mo2next, mobj->info->mass)
 			{
-				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-					continue;
-
-				mo2 = (mobj_t *)th;
-				if (mo2->type == (mobjtype_t)mobj->info->mass && mo2->tracer == mobj)
+				if (mo2->tracer == mobj)
 				{
 					P_RemoveMobj(mo2);
 					i++;
@@ -4307,8 +4170,7 @@ static void P_Boss3Thinker(mobj_t *mobj)
 	}
 	else if (mobj->threshold >= 0) // Traveling mode
 	{
-		thinker_t *th;
-		mobj_t *mo2;
+		mobj_t *mo2, *mo2next;
 		fixed_t dist, dist2;
 		fixed_t speed;
 
@@ -4321,13 +4183,9 @@ static void P_Boss3Thinker(mobj_t *mobj)
 		// scan the thinkers
 		// to find a point that matches
 		// the number
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, mo2next, MT_BOSS3WAYPOINT)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-			if (mo2->type == MT_BOSS3WAYPOINT && mo2->spawnpoint && mo2->spawnpoint->angle == mobj->threshold)
+			if (mo2->spawnpoint && mo2->spawnpoint->angle == mobj->threshold)
 			{
 				P_SetTarget(&mobj->target, mo2);
 				break;
@@ -4913,13 +4771,12 @@ static void P_Boss7Thinker(mobj_t *mobj)
 	}
 	else if (mobj->state == &states[S_BLACKEGG_JUMP1] && mobj->tics == 1)
 	{
-		mobj_t *hitspot = NULL, *mo2;
+		mobj_t *hitspot = NULL, *mo2, *next;
 		angle_t an;
 		fixed_t dist, closestdist;
 		fixed_t vertical, horizontal;
 		fixed_t airtime = 5*TICRATE;
 		INT32 waypointNum = 0;
-		thinker_t *th;
 		INT32 i;
 		boolean foundgoop = false;
 		INT32 closestNum;
@@ -4942,13 +4799,9 @@ static void P_Boss7Thinker(mobj_t *mobj)
 				closestdist = 16384*FRACUNIT; // Just in case...
 
 				// Find waypoint he is closest to
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				P_ForEachMobjOfType(mo2, next, MT_BOSS3WAYPOINT)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-						continue;
-
-					mo2 = (mobj_t *)th;
-					if (mo2->type == MT_BOSS3WAYPOINT && mo2->spawnpoint)
+					if (mo2->spawnpoint)
 					{
 						dist = P_AproxDistance(players[i].mo->x - mo2->x, players[i].mo->y - mo2->y);
 
@@ -4997,13 +4850,9 @@ static void P_Boss7Thinker(mobj_t *mobj)
 
 		// scan the thinkers to find
 		// the waypoint to use
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, next, MT_BOSS3WAYPOINT)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-			if (mo2->type == MT_BOSS3WAYPOINT && mo2->spawnpoint && (mo2->spawnpoint->options & 7) == waypointNum)
+			if (mo2->spawnpoint && (mo2->spawnpoint->options & 7) == waypointNum)
 			{
 				hitspot = mo2;
 				break;
@@ -5107,8 +4956,7 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 	if (!mobj->tracer)
 	{
-		thinker_t *th;
-		mobj_t *mo2;
+		mobj_t *mo2, *next;
 		mobj_t *last=NULL;
 
 		// Initialize the boss, spawn jet fumes, etc.
@@ -5120,21 +4968,14 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 		// Run through the thinkers ONCE and find all of the MT_BOSS9GATHERPOINT in the map.
 		// Build a hoop linked list of 'em!
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, next, MT_BOSS9GATHERPOINT)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-			if (mo2->type == MT_BOSS9GATHERPOINT)
-			{
-				if (last)
-					P_SetTarget(&last->hnext, mo2);
-				else
-					P_SetTarget(&mobj->hnext, mo2);
-				P_SetTarget(&mo2->hprev, last);
-				last = mo2;
-			}
+			if (last)
+				P_SetTarget(&last->hnext, mo2);
+			else
+				P_SetTarget(&mobj->hnext, mo2);
+			P_SetTarget(&mo2->hprev, last);
+			last = mo2;
 		}
 	}
 
@@ -5548,35 +5389,26 @@ static void P_Boss9Thinker(mobj_t *mobj)
 // Finds the CLOSEST axis to the source mobj
 mobj_t *P_GetClosestAxis(mobj_t *source)
 {
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	mobj_t *closestaxis = NULL;
 	fixed_t dist1, dist2 = 0;
 
 	// scan the thinkers to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, MT_AXIS)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_AXIS)
+		if (closestaxis == NULL)
+		{
+			closestaxis = mo2;
+			dist2 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
+		}
+		else
 		{
-			if (closestaxis == NULL)
+			dist1 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
+
+			if (dist1 < dist2)
 			{
 				closestaxis = mo2;
-				dist2 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
-			}
-			else
-			{
-				dist1 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
-
-				if (dist1 < dist2)
-				{
-					closestaxis = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -9533,7 +9365,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 {
 	const mobjinfo_t *info = &mobjinfo[type];
 	state_t *st;
-	mobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	mobj_t *mobj = Z_PoolCalloc(&mobjpool);
 
 	// this is officially a mobj, declared as soon as possible.
 	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
@@ -9915,7 +9747,10 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	}
 
 	if (!(mobj->flags & MF_NOTHINK))
-		P_AddThinker(&mobj->thinker); // Needs to come before the shadow spawn, or else the shadow's reference gets forgotten
+	{
+		P_AddThinker(THINK_MOBJ, &mobj->thinker); // Needs to come before the shadow spawn, or else the shadow's reference gets forgotten
+		P_LinkMobjType(mobj);
+	}
 
 	switch (mobj->type)
 	{
@@ -9982,7 +9817,7 @@ mobj_t *P_SpawnShadowMobj(mobj_t * caster)
 {
 	const mobjinfo_t *info = &mobjinfo[MT_SHADOW];
 	state_t *st;
-	mobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	mobj_t *mobj = Z_PoolCalloc(&mobjpool);
 
 	// this is officially a mobj, declared as soon as possible.
 	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
@@ -10051,7 +9886,10 @@ mobj_t *P_SpawnShadowMobj(mobj_t * caster)
 		mobj->eflags |= MFE_ONGROUND;
 
 	if (!(mobj->flags & MF_NOTHINK))
-		P_AddThinker(&mobj->thinker);
+	{
+		P_AddThinker(THINK_MOBJ, &mobj->thinker);
+		P_LinkMobjType(mobj);
+	}
 
 	// Call action functions when the state is set
 	if (st->action.acp1 && (mobj->flags & MF_RUNSPAWNFUNC))
@@ -10089,69 +9927,147 @@ mobj_t *P_SpawnShadowMobj(mobj_t * caster)
 	return mobj;
 }
 
-static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
+// The mobjs in the thinker list, one list per type, in the order they
+// joined it. A scan for one type walks these instead of every mobj.
+static struct
 {
-	state_t *st;
-	precipmobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
-	fixed_t starting_floorz;
+	mobj_t *first, *last;
+} mobjtypelists[NUMMOBJTYPES];
 
-	mobj->x = x;
-	mobj->y = y;
-	mobj->flags = mobjinfo[type].flags;
+void P_ClearMobjTypeLists(void)
+{
+	memset(mobjtypelists, 0, sizeof (mobjtypelists));
+}
 
-	// do not set the state with P_SetMobjState,
-	// because action routines can not be called yet
-	st = &states[mobjinfo[type].spawnstate];
+//
+// P_LinkMobjType
+//
+// Appends a mobj to the list for its type. Call this wherever a mobj is
+// added to the end of the thinker list; with P_SetMobjType keeping its
+// place too, the type lists hold the same mobjs in the same order a
+// thinker scan would find them.
+//
+void P_LinkMobjType(mobj_t *mobj)
+{
+	mobj->typenext = NULL;
+	mobj->typeprev = mobjtypelists[mobj->type].last;
 
-	mobj->state = st;
-	mobj->tics = st->tics;
-	mobj->sprite = st->sprite;
-	mobj->frame = st->frame; // FF_FRAMEMASK for frame, and other bits..
-	mobj->anim_duration = (UINT16)st->var2; // only used if FF_ANIMATE is set
+	if (mobj->typeprev)
+		mobj->typeprev->typenext = mobj;
+	else
+		mobjtypelists[mobj->type].first = mobj;
+	mobjtypelists[mobj->type].last = mobj;
+}
 
-	// set subsector and/or block links
-	P_SetPrecipitationThingPosition(mobj);
+//
+// P_UnlinkMobjType
+//
+// Takes a mobj out of its type's list, returning false if it wasn't in
+// one. The mobj keeps its typenext, so a loop that removes the mobj it
+// is on can still step to the next one.
+//
+static boolean P_UnlinkMobjType(mobj_t *mobj)
+{
+	if (mobj->typeprev)
+		mobj->typeprev->typenext = mobj->typenext;
+	else if (mobjtypelists[mobj->type].first == mobj)
+		mobjtypelists[mobj->type].first = mobj->typenext;
+	else
+		return false;
 
-	mobj->floorz = starting_floorz =
-				mobj->subsector->sector->f_slope ? P_GetZAt(mobj->subsector->sector->f_slope, x, y) :
-				mobj->subsector->sector->floorheight;
-	mobj->ceilingz =
-				mobj->subsector->sector->c_slope ? P_GetZAt(mobj->subsector->sector->c_slope, x, y) :
-				mobj->subsector->sector->ceilingheight;
+	if (mobj->typenext)
+		mobj->typenext->typeprev = mobj->typeprev;
+	else
+		mobjtypelists[mobj->type].last = mobj->typeprev;
+	mobj->typeprev = NULL;
+	return true;
+}
 
-	mobj->z = z;
-	mobj->momz = mobjinfo[type].speed;
+// Puts a mobj into its type's list right after another, or at the front
+// if that's NULL.
+static void P_InsertMobjType(mobj_t *mobj, mobj_t *after)
+{
+	mobj->typeprev = after;
+	mobj->typenext = after ? after->typenext : mobjtypelists[mobj->type].first;
 
-	mobj->thinker.function.acp1 = (actionf_p1)P_NullPrecipThinker;
-	P_AddThinker(&mobj->thinker);
+	if (mobj->typenext)
+		mobj->typenext->typeprev = mobj;
+	else
+		mobjtypelists[mobj->type].last = mobj;
+	if (after)
+		after->typenext = mobj;
+	else
+		mobjtypelists[mobj->type].first = mobj;
+}
 
-	CalculatePrecipFloor(mobj);
+//
+// P_SetMobjType
+//
+// Changes a mobj's type, moving it into the new type's list where it sits
+// in the thinker list, so the type lists keep thinker order; a savegame
+// rebuilds them in that order, so anything else would differ after a
+// join. Doesn't touch mobj->info, that's up to the caller.
+//
+void P_SetMobjType(mobj_t *mobj, mobjtype_t type)
+{
+	thinker_t *back, *ahead;
 
-	if (mobj->floorz != starting_floorz)
-		mobj->precipflags |= PCF_FOF;
-	else if (GETSECSPECIAL(mobj->subsector->sector->special, 1) == 7
-	 || GETSECSPECIAL(mobj->subsector->sector->special, 1) == 6
-	 || mobj->subsector->sector->floorpic == skyflatnum)
-		mobj->precipflags |= PCF_PIT;
+	if (!P_UnlinkMobjType(mobj))
+	{
+		mobj->type = type;
+		return;
+	}
+	mobj->type = type;
 
-	R_ResetPrecipitationMobjInterpolationState(mobj);
+	if (!mobjtypelists[type].first)
+	{
+		P_LinkMobjType(mobj);
+		return;
+	}
 
-	return mobj;
-}
+	// Look both ways for the nearest live mobj of the new type.
+	back = mobj->thinker.prev;
+	ahead = mobj->thinker.next;
+	for (;;)
+	{
+		if (back == &thlist[THINK_MOBJ])
+		{
+			P_InsertMobjType(mobj, NULL); // none before it
+			return;
+		}
+		if (back->function.acp1 == (actionf_p1)P_MobjThinker && ((mobj_t *)back)->type == type)
+		{
+			P_InsertMobjType(mobj, (mobj_t *)back);
+			return;
+		}
+		back = back->prev;
 
-static inline precipmobj_t *P_SpawnRainMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
-{
-	precipmobj_t *mo = P_SpawnPrecipMobj(x,y,z,type);
-	mo->precipflags |= PCF_RAIN;
-	//mo->thinker.function.acp1 = (actionf_p1)P_RainThinker;
-	return mo;
+		if (ahead == &thlist[THINK_MOBJ])
+		{
+			P_LinkMobjType(mobj); // none after it
+			return;
+		}
+		if (ahead->function.acp1 == (actionf_p1)P_MobjThinker && ((mobj_t *)ahead)->type == type)
+		{
+			P_InsertMobjType(mobj, ((mobj_t *)ahead)->typeprev);
+			return;
+		}
+		ahead = ahead->next;
+	}
 }
 
-static inline precipmobj_t *P_SpawnSnowMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
+//
+// P_FirstMobjOfType
+//
+// Returns the first live mobj of a type, or NULL if there are none; follow
+// typenext for the rest. The current mobj may be removed while walking,
+// but not the next one.
+//
+mobj_t *P_FirstMobjOfType(mobjtype_t type)
 {
-	precipmobj_t *mo = P_SpawnPrecipMobj(x,y,z,type);
-	//mo->thinker.function.acp1 = (actionf_p1)P_SnowThinker;
-	return mo;
+	if ((unsigned)type >= NUMMOBJTYPES)
+		return NULL;
+	return mobjtypelists[type].first;
 }
 
 //
@@ -10178,6 +10094,8 @@ void P_RemoveMobj(mobj_t *mobj)
 	I_Assert(!P_MobjWasRemoved(mobj));
 #endif
 
+	P_UnlinkMobjType(mobj);
+
 	// Rings only, please!
 	if (mobj->spawnpoint &&
 		(mobj->type == MT_RING
@@ -10275,7 +10193,7 @@ void P_RemoveMobj(mobj_t *mobj)
 		else
 		{ // Add thinker just to delay removing it until refrences are gone.
 			mobj->flags &= ~MF_NOTHINK;
-			P_AddThinker((thinker_t *)mobj);
+			P_AddThinker(THINK_MOBJ, (thinker_t *)mobj);
 #ifdef SCRAMBLE_REMOVED
 			// Invalidate mobj_t data to cause crashes if accessed!
 			memset((UINT8 *)mobj + sizeof(thinker_t), 0xff, sizeof(mobj_t) - sizeof(thinker_t));
@@ -10304,46 +10222,17 @@ boolean P_MobjWasRemoved(mobj_t *mobj)
 	return true;
 }
 
-void P_RemovePrecipMobj(precipmobj_t *mobj)
-{
-	// unlink from sector and block lists
-	P_UnsetPrecipThingPosition(mobj);
-
-	if (precipsector_list)
-	{
-		P_DelPrecipSeclist(precipsector_list);
-		precipsector_list = NULL;
-	}
-
-	// free block
-	P_RemoveThinker((thinker_t *)mobj);
-}
-
 // Clearing out stuff for savegames
 void P_RemoveSavegameMobj(mobj_t *mobj)
 {
 	// unlink from sector and block lists
-	if (((thinker_t *)mobj)->function.acp1 == (actionf_p1)P_NullPrecipThinker)
-	{
-		P_UnsetPrecipThingPosition((precipmobj_t *)mobj);
+	P_UnsetThingPosition(mobj);
 
-		if (precipsector_list)
-		{
-			P_DelPrecipSeclist(precipsector_list);
-			precipsector_list = NULL;
-		}
-	}
-	else
+	// Remove touching_sectorlist from mobj.
+	if (sector_list)
 	{
-		// unlink from sector and block lists
-		P_UnsetThingPosition(mobj);
-
-		// Remove touching_sectorlist from mobj.
-		if (sector_list)
-		{
-			P_DelSeclist(sector_list);
-			sector_list = NULL;
-		}
+		P_DelSeclist(sector_list);
+		sector_list = NULL;
 	}
 
 	// stop any playing sound
@@ -10367,74 +10256,6 @@ static CV_PossibleValue_t flagtime_cons_t[] = {{0, "MIN"}, {300, "MAX"}, {0, NUL
 consvar_t cv_flagtime = {"flagtime", "30", CV_NETVAR|CV_CHEAT|CV_NOSHOWHELP, flagtime_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 consvar_t cv_suddendeath = {"suddendeath", "Off", CV_NETVAR|CV_CHEAT|CV_NOSHOWHELP, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
-void P_SpawnPrecipitation(void)
-{
-	INT32 i, mrand;
-	fixed_t basex, basey, x, y, height;
-	subsector_t *precipsector = NULL;
-	precipmobj_t *rainmo = NULL;
-
-	if (dedicated || /*!cv_precipdensity*/!cv_drawdist_precip.value || curWeather == PRECIP_NONE) // SRB2Kart
-		return;
-
-	// Use the blockmap to narrow down our placing patterns
-	for (i = 0; i < bmapwidth*bmapheight; ++i)
-	{
-		basex = bmaporgx + (i % bmapwidth) * MAPBLOCKSIZE;
-		basey = bmaporgy + (i / bmapwidth) * MAPBLOCKSIZE;
-
-		//for (j = 0; j < cv_precipdensity.value; ++j) -- density is 1 for kart always
-		{
-			x = basex + ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3);
-			y = basey + ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3);
-
-			precipsector = R_IsPointInSubsector(x, y);
-
-			// No sector? Stop wasting time,
-			// move on to the next entry in the blockmap
-			if (!precipsector)
-				continue;
-
-			// Not in a sector with visible sky?
-			if (precipsector->sector->ceilingpic != skyflatnum)
-				continue;
-
-			// Exists, but is too small for reasonable precipitation.
-			if (!(precipsector->sector->floorheight <= precipsector->sector->ceilingheight - (32<<FRACBITS)))
-				continue;
-
-			// Don't set height yet...
-			height = precipsector->sector->ceilingheight;
-
-			if (curWeather == PRECIP_SNOW)
-			{
-				rainmo = P_SpawnSnowMobj(x, y, height, MT_SNOWFLAKE);
-				mrand = M_RandomByte();
-				if (mrand < 64)
-					P_SetPrecipMobjState(rainmo, S_SNOW3);
-				else if (mrand < 144)
-					P_SetPrecipMobjState(rainmo, S_SNOW2);
-			}
-			else // everything else.
-				rainmo = P_SpawnRainMobj(x, y, height, MT_RAIN);
-
-			// Randomly assign a height, now that floorz is set.
-			rainmo->z = M_RandomRange(rainmo->floorz>>FRACBITS, rainmo->ceilingz>>FRACBITS)<<FRACBITS;
-		}
-	}
-
-	if (curWeather == PRECIP_BLANK)
-	{
-		curWeather = PRECIP_RAIN;
-		P_SwitchWeather(PRECIP_BLANK);
-	}
-	else if (curWeather == PRECIP_STORM_NORAIN)
-	{
-		curWeather = PRECIP_RAIN;
-		P_SwitchWeather(PRECIP_STORM_NORAIN);
-	}
-}
-
 //
 // P_PrecipitationEffects
 //
@@ -10569,19 +10390,13 @@ void P_RespawnSpecials(void)
 
 	if (G_BattleGametype() && numgotboxes >= (4*nummapboxes/5)) // Battle Mode respawns all boxes in a different way
 	{
-		thinker_t *th;
+		mobj_t *box, *next;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(box, next, MT_RANDOMITEM)
 		{
-			mobj_t *box;
 			mobj_t *newmobj;
 
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)	// not a mobj
-				continue;
-
-			box = (mobj_t *)th;
-
-			if (box->type != MT_RANDOMITEM || box->threshold != 68 || box->fuse) // only popped items
+			if (box->threshold != 68 || box->fuse) // only popped items
 				continue;
 
 			// Respawn from mapthing if you have one!
@@ -11709,7 +11524,7 @@ ML_NOCLIMB : Direction not controllable
 		mobj->health = (mthing->angle / 360) + 1;
 
 		// See if other starposts exist in this level that have the same value.
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachThinker(th, THINK_MOBJ)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
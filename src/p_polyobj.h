@@ -83,7 +83,7 @@ typedef struct polyobj_s
 
 	degenmobj_t spawnSpot; // location of spawn spot
 	vertex_t    centerPt;  // center point
-	fixed_t zdist;         // viewz distance for sorting
+	fixed_t zdist[MAXSPLITSCREENPLAYERS]; // viewz distance for sorting, per view
 	angle_t angle;         // for rotation
 	UINT8 attached;         // if true, is attached to a subsector
 
@@ -99,7 +99,7 @@ typedef struct polyobj_s
 	UINT8 isBad;         // a bad polyobject: should not be rendered/manipulated
 	INT32 translucency; // index to translucency tables
 
-	struct visplane_s *visplane; // polyobject's visplane, for ease of putting into the list later
+	struct visplane_s *visplane[MAXSPLITSCREENPLAYERS]; // polyobject's visplane in each view, for ease of putting into the list later
 
 	// these are saved for netgames, so do not let Lua touch these!
 	INT32 spawnflags; // Flags the polyobject originally spawned with
@@ -710,11 +710,11 @@ static void P_LoadRawSectors(UINT8 *data, size_t i)
 
 		memset(&ss->soundorg, 0, sizeof(ss->soundorg));
 		ss->validcount = 0;
+		memset(ss->spritevalidcount, 0, sizeof (ss->spritevalidcount));
 
 		ss->thinglist = NULL;
 		ss->touching_thinglist = NULL;
-		ss->preciplist = NULL;
-		ss->touching_preciplist = NULL;
+		ss->firstprecip = ss->numprecip = 0;
 
 		ss->floordata = NULL;
 		ss->ceilingdata = NULL;
@@ -835,7 +835,7 @@ void P_ReloadRings(void)
 	mapthing_t *mt = mapthings;
 
 	// scan the thinkers to find rings/wings/hoops to unset
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachThinker(th, THINK_MOBJ)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -2447,7 +2447,7 @@ void P_LoadThingsOnly(void)
 	mobj_t *mo;
 	thinker_t *think;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	P_ForEachThinker(think, THINK_MOBJ)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -2801,6 +2801,153 @@ static boolean P_CanSave(void)
 #endif
 }
 
+//
+// Level prefetching
+//
+// Once the vote or intermission knows which map comes next, its lumps are
+// handed to W_StartPrefetch to be paged in (and inflated, for PK3s) in the
+// background, and P_PrefetchTicker composites its wall textures a few per
+// tic. P_SetupLevel then finds all that already done; whatever isn't ready
+// by then is simply loaded the normal way.
+//
+
+#define PREFETCH_TEXTURESPERTIC 4
+
+static INT32 *prefetchtextures = NULL;
+static size_t prefetchnumtextures = 0, prefetchtexturepos = 0;
+
+static void P_PrefetchTexture(INT32 texnum, UINT8 *present)
+{
+	texpatch_t *patch;
+	INT32 i;
+
+	if (texnum <= 0 || texnum >= numtextures || present[texnum])
+		return;
+	present[texnum] = 1;
+	prefetchtextures[prefetchnumtextures++] = texnum;
+
+	for (i = 0, patch = textures[texnum]->patches; i < textures[texnum]->patchcount; i++, patch++)
+		W_PrefetchLump((patch->wad<<16) + patch->lump);
+}
+
+static void P_PrefetchSideTexture(const char *name, UINT8 *present)
+{
+	char texname[9];
+
+	M_Memcpy(texname, name, 8);
+	texname[8] = '\0';
+	P_PrefetchTexture(R_CheckTextureNumForName(texname), present);
+}
+
+/** Starts warming up a map that's about to be loaded.
+  *
+  * \param mapnum Map number, as in gamemap.
+  */
+void P_PrefetchLevel(INT16 mapnum)
+{
+	lumpnum_t maplumpnum;
+	size_t i, j, num;
+	UINT8 *present;
+	char flatname[9];
+	char (*flats)[8];
+	size_t numflats = 0;
+	mapsidedef_t *msd;
+	mapsector_t *ms;
+	UINT8 *data;
+
+	P_StopPrefetch();
+
+	if (mapnum < 1 || mapnum > NUMMAPS || !mapheaderinfo[mapnum-1] || M_CheckParm("-noprefetch"))
+		return;
+
+	maplumpnum = W_CheckNumForName(G_BuildMapName(mapnum));
+	if (maplumpnum == LUMPERROR)
+		return;
+
+	// A map WAD in a PK3 is just the one lump. Its textures aren't looked
+	// at here, since that would mean opening it up early.
+	if (W_IsLumpWad(maplumpnum))
+	{
+		W_PrefetchLump(maplumpnum);
+		W_StartPrefetch();
+		return;
+	}
+
+	for (i = ML_THINGS; i <= ML_BLOCKMAP; i++)
+		if (LUMPNUM(maplumpnum) + i < wadfiles[WADFILENUM(maplumpnum)]->numlumps)
+			W_PrefetchLump(maplumpnum + i);
+
+	if (rendermode != render_soft || LUMPNUM(maplumpnum) + ML_SECTORS >= wadfiles[WADFILENUM(maplumpnum)]->numlumps)
+	{
+		W_StartPrefetch();
+		return;
+	}
+
+	// Flats, once per name.
+	num = W_LumpLength(maplumpnum + ML_SECTORS) / sizeof (mapsector_t);
+	flats = malloc(2 * num * sizeof (*flats));
+	data = W_CacheLumpNum(maplumpnum + ML_SECTORS, PU_CACHE);
+	for (i = 0, ms = (mapsector_t *)data; flats && i < 2*num; i++)
+	{
+		const char *pic = (i & 1) ? ms[i/2].ceilingpic : ms[i/2].floorpic;
+
+		for (j = 0; j < numflats; j++)
+			if (!strnicmp(flats[j], pic, 8))
+				break;
+		if (j < numflats)
+			continue;
+
+		M_Memcpy(flats[numflats++], pic, 8);
+		M_Memcpy(flatname, pic, 8);
+		flatname[8] = '\0';
+		if (stricmp(flatname, SKYFLATNAME))
+			W_PrefetchLump(R_GetFlatNumForName(flatname));
+	}
+	free(flats);
+
+	// Wall textures and the sky.
+	present = calloc(numtextures, sizeof (*present));
+	prefetchtextures = malloc(numtextures * sizeof (*prefetchtextures));
+	if (!present || !prefetchtextures)
+	{
+		free(present);
+		W_StartPrefetch();
+		return;
+	}
+
+	num = W_LumpLength(maplumpnum + ML_SIDEDEFS) / sizeof (mapsidedef_t);
+	data = W_CacheLumpNum(maplumpnum + ML_SIDEDEFS, PU_CACHE);
+	for (i = 0, msd = (mapsidedef_t *)data; i < num; i++, msd++)
+	{
+		P_PrefetchSideTexture(msd->toptexture, present);
+		P_PrefetchSideTexture(msd->midtexture, present);
+		P_PrefetchSideTexture(msd->bottomtexture, present);
+	}
+	P_PrefetchTexture(R_CheckTextureNumForName(va("SKY%d", mapheaderinfo[mapnum-1]->skynum)), present);
+	free(present);
+
+	W_StartPrefetch();
+}
+
+void P_PrefetchTicker(void)
+{
+	INT32 i;
+
+	W_PrefetchTicker();
+
+	for (i = 0; i < PREFETCH_TEXTURESPERTIC && prefetchtexturepos < prefetchnumtextures; i++)
+		R_CheckTextureCache(prefetchtextures[prefetchtexturepos++]);
+}
+
+void P_StopPrefetch(void)
+{
+	W_StopPrefetch();
+
+	free(prefetchtextures);
+	prefetchtextures = NULL;
+	prefetchnumtextures = prefetchtexturepos = 0;
+}
+
 /** Loads a level from a lump or external wad.
   *
   * \param skipprecip If true, don't spawn precipitation.
@@ -2820,6 +2967,12 @@ boolean P_SetupLevel(boolean skipprecip)
 
 	levelloading = true;
 
+	// Keep whatever the vote screen got done, and stop getting more.
+	P_StopPrefetch();
+
+	// Skins nobody is racing as don't need their patches kept around.
+	R_FlushSkinSprites();
+
 	// This is needed. Don't touch.
 	maptol = mapheaderinfo[gamemap-1]->typeoflevel;
 
@@ -3139,8 +3292,7 @@ boolean P_SetupLevel(boolean skipprecip)
 	// set up world state
 	P_SpawnSpecials(fromnetsave);
 
-	if (loadprecip) //  ugly hack for P_NetUnArchiveMisc (and P_LoadNetGame)
-		P_SpawnPrecipitation();
+	R_SetupPrecipitation();
 
 #ifdef HWRENDER // not win32 only 19990829 by Kin
 	if (rendermode != render_soft && rendermode != render_none)
@@ -148,6 +148,10 @@ void P_RunDynamicSlopes(void) {
 			slope->zdelta = FixedDiv(zdelta, slope->extent);
 			slope->zangle = R_PointToAngle2(0, 0, slope->extent, -zdelta);
 			P_CalculateSlopeNormal(slope);
+
+			// Whichever side owns the slope, its 3D floor light list needs sorting again
+			P_FlagSectorMoved(slope->sourceline->frontsector);
+			P_FlagSectorMoved(slope->sourceline->backsector);
 		}
 	}
 }
@@ -40,14 +40,15 @@ tic_t leveltime;
 // but the first element must be thinker_t.
 //
 
-// Both the head and tail of the thinker list.
-thinker_t thinkercap;
+// Both the head and tail of each thinker list.
+thinker_t thlist[NUM_THINKERLISTS];
 
 void Command_Numthinkers_f(void)
 {
 	INT32 num;
 	INT32 count = 0;
 	actionf_p1 action;
+	thinklistnum_t n;
 	thinker_t *think;
 
 	if (gamestate != GS_LEVEL)
@@ -61,12 +62,9 @@ void Command_Numthinkers_f(void)
 		CONS_Printf(M_GetText("numthinkers <#>: Count number of thinkers\n"));
 		CONS_Printf(
 			"\t1: P_MobjThinker\n"
-			/*"\t2: P_RainThinker\n"
-			"\t3: P_SnowThinker\n"*/
-			"\t2: P_NullPrecipThinker\n"
-			"\t3: T_Friction\n"
-			"\t4: T_Pusher\n"
-			"\t5: P_RemoveThinkerDelayed\n");
+			"\t2: T_Friction\n"
+			"\t3: T_Pusher\n"
+			"\t4: P_RemoveThinkerDelayed\n");
 		return;
 	}
 
@@ -78,27 +76,15 @@ void Command_Numthinkers_f(void)
 			action = (actionf_p1)P_MobjThinker;
 			CONS_Printf(M_GetText("Number of %s: "), "P_MobjThinker");
 			break;
-		/*case 2:
-			action = (actionf_p1)P_RainThinker;
-			CONS_Printf(M_GetText("Number of %s: "), "P_RainThinker");
-			break;
-		case 3:
-			action = (actionf_p1)P_SnowThinker;
-			CONS_Printf(M_GetText("Number of %s: "), "P_SnowThinker");
-			break;*/
 		case 2:
-			action = (actionf_p1)P_NullPrecipThinker;
-			CONS_Printf(M_GetText("Number of %s: "), "P_NullPrecipThinker");
-			break;
-		case 3:
 			action = (actionf_p1)T_Friction;
 			CONS_Printf(M_GetText("Number of %s: "), "T_Friction");
 			break;
-		case 4:
+		case 3:
 			action = (actionf_p1)T_Pusher;
 			CONS_Printf(M_GetText("Number of %s: "), "T_Pusher");
 			break;
-		case 5:
+		case 4:
 			action = (actionf_p1)P_RemoveThinkerDelayed;
 			CONS_Printf(M_GetText("Number of %s: "), "P_RemoveThinkerDelayed");
 			break;
@@ -107,20 +93,21 @@ void Command_Numthinkers_f(void)
 			return;
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
-	{
-		if (think->function.acp1 != action)
-			continue;
+	for (n = 0; n < NUM_THINKERLISTS; n++)
+		P_ForEachThinker(think, n)
+		{
+			if (think->function.acp1 != action)
+				continue;
 
-		count++;
-	}
+			count++;
+		}
 
 	CONS_Printf("%d\n", count);
 }
 
 void Command_CountMobjs_f(void)
 {
-	thinker_t *th;
+	mobj_t *mo, *next;
 	mobjtype_t i;
 	INT32 count;
 
@@ -144,14 +131,8 @@ void Command_CountMobjs_f(void)
 
 			count = 0;
 
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
-			{
-				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-					continue;
-
-				if (((mobj_t *)th)->type == i)
-					count++;
-			}
+			P_ForEachMobjOfType(mo, next, i)
+				count++;
 
 			CONS_Printf(M_GetText("There are %d objects of type %d currently in the level.\n"), count, i);
 		}
@@ -164,14 +145,8 @@ void Command_CountMobjs_f(void)
 	{
 		count = 0;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
-		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			if (((mobj_t *)th)->type == i)
-				count++;
-		}
+		P_ForEachMobjOfType(mo, next, i)
+			count++;
 
 		if (count > 0) // Don't bother displaying if there are none of this type!
 			CONS_Printf(" * %d: %d\n", i, count);
@@ -183,20 +158,24 @@ void Command_CountMobjs_f(void)
 //
 void P_InitThinkers(void)
 {
-	thinkercap.prev = thinkercap.next = &thinkercap;
+	thinklistnum_t n;
+
+	for (n = 0; n < NUM_THINKERLISTS; n++)
+		thlist[n].prev = thlist[n].next = &thlist[n];
+	P_ClearMobjTypeLists();
 	waypointcap = NULL;
 }
 
 //
 // P_AddThinker
-// Adds a new thinker at the end of the list.
+// Adds a new thinker at the end of list n.
 //
-void P_AddThinker(thinker_t *thinker)
+void P_AddThinker(const thinklistnum_t n, thinker_t *thinker)
 {
-	thinkercap.prev->next = thinker;
-	thinker->next = &thinkercap;
-	thinker->prev = thinkercap.prev;
-	thinkercap.prev = thinker;
+	thlist[n].prev->next = thinker;
+	thinker->next = &thlist[n];
+	thinker->prev = thlist[n].prev;
+	thlist[n].prev = thinker;
 
 	thinker->references = 0;    // killough 11/98: init reference counter to 0
 }
@@ -225,7 +204,7 @@ void P_RemoveThinkerDelayed(void *pthinker)
 	if (!thinker->references)
 	{
 		{
-			/* Remove from main thinker list */
+			/* Remove from its thinker list */
 			thinker_t *next = thinker->next;
 			/* Note that currentthinker is guaranteed to point to us,
 			 * and since we're freeing our memory, we had better change that. So
@@ -301,13 +280,19 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 // Rewritten to delete nodes implicitly, by making currentthinker
 // external and using P_RemoveThinkerDelayed() implicitly.
 //
+// Each list is run in full before the next one, so the update order
+// within a class is the order its thinkers were added in.
+//
 static inline void P_RunThinkers(void)
 {
-	for (currentthinker = thinkercap.next; currentthinker != &thinkercap; currentthinker = currentthinker->next)
-	{
-		if (currentthinker->function.acp1)
-			currentthinker->function.acp1(currentthinker);
-	}
+	thinklistnum_t n;
+
+	for (n = 0; n < NUM_THINKERLISTS; n++)
+		P_ForEachThinker(currentthinker, n)
+		{
+			if (currentthinker->function.acp1)
+				currentthinker->function.acp1(currentthinker);
+		}
 }
 
 //
@@ -350,7 +350,7 @@ void P_ResetScore(player_t *player)
 /*UINT8 P_FindLowestMare(void)
 {
 	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	UINT8 mare = UINT8_MAX;
 
 	if (G_RaceGametype())
@@ -358,14 +358,9 @@ void P_ResetScore(player_t *player)
 
 	// scan the thinkers
 	// to find the egg capsule with the lowest mare
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, MT_EGGCAPSULE)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_EGGCAPSULE && mo2->health > 0)
+		if (mo2->health > 0)
 		{
 			const UINT8 threshold = (UINT8)mo2->threshold;
 			if (mare == 255)
@@ -444,7 +439,7 @@ UINT8 P_FindHighestLap(void)
 /*boolean P_TransferToNextMare(player_t *player)
 {
 	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	mobj_t *closestaxis = NULL;
 	INT32 lowestaxisnum = -1;
 	UINT8 mare = P_FindLowestMare();
@@ -459,33 +454,25 @@ UINT8 P_FindHighestLap(void)
 
 	// scan the thinkers
 	// to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, MT_AXIS)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_AXIS)
+		if (mo2->threshold == mare)
 		{
-			if (mo2->threshold == mare)
+			if (closestaxis == NULL)
 			{
-				if (closestaxis == NULL)
+				closestaxis = mo2;
+				lowestaxisnum = mo2->health;
+				dist2 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
+			}
+			else if (mo2->health < lowestaxisnum)
+			{
+				dist1 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
+
+				if (dist1 < dist2)
 				{
 					closestaxis = mo2;
 					lowestaxisnum = mo2->health;
-					dist2 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
-				}
-				else if (mo2->health < lowestaxisnum)
-				{
-					dist1 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
-
-					if (dist1 < dist2)
-					{
-						closestaxis = mo2;
-						lowestaxisnum = mo2->health;
-						dist2 = dist1;
-					}
+					dist2 = dist1;
 				}
 			}
 		}
@@ -505,27 +492,13 @@ UINT8 P_FindHighestLap(void)
 // the mobj for that axis point.
 static mobj_t *P_FindAxis(INT32 mare, INT32 axisnum)
 {
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 
-	// scan the thinkers
-	// to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the axis points
+	P_ForEachMobjOfType(mo2, next, MT_AXIS)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		// Axis things are only at beginning of list.
-		if (!(mo2->flags2 & MF2_AXIS))
-			return NULL;
-
-		if (mo2->type == MT_AXIS)
-		{
-			if (mo2->health == axisnum && mo2->threshold == mare)
-				return mo2;
-		}
+		if (mo2->health == axisnum && mo2->threshold == mare)
+			return mo2;
 	}
 
 	return NULL;
@@ -538,27 +511,13 @@ static mobj_t *P_FindAxis(INT32 mare, INT32 axisnum)
 // the mobj for that axis transfer point.
 static mobj_t *P_FindAxisTransfer(INT32 mare, INT32 axisnum, mobjtype_t type)
 {
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 
-	// scan the thinkers
-	// to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the axis transfer points
+	P_ForEachMobjOfType(mo2, next, type)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		// Axis things are only at beginning of list.
-		if (!(mo2->flags2 & MF2_AXIS))
-			return NULL;
-
-		if (mo2->type == type)
-		{
-			if (mo2->health == axisnum && mo2->threshold == mare)
-				return mo2;
-		}
+		if (mo2->health == axisnum && mo2->threshold == mare)
+			return mo2;
 	}
 
 	return NULL;
@@ -571,7 +530,7 @@ static mobj_t *P_FindAxisTransfer(INT32 mare, INT32 axisnum, mobjtype_t type)
 void P_TransferToAxis(player_t *player, INT32 axisnum)
 {
 	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	mobj_t *closestaxis;
 	INT32 mare = player->mare;
 	fixed_t dist1, dist2 = 0;
@@ -582,31 +541,23 @@ void P_TransferToAxis(player_t *player, INT32 axisnum)
 
 	// scan the thinkers
 	// to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, MT_AXIS)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_AXIS)
+		if (mo2->health == axisnum && mo2->threshold == mare)
 		{
-			if (mo2->health == axisnum && mo2->threshold == mare)
+			if (closestaxis == NULL)
 			{
-				if (closestaxis == NULL)
+				closestaxis = mo2;
+				dist2 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
+			}
+			else
+			{
+				dist1 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
+
+				if (dist1 < dist2)
 				{
 					closestaxis = mo2;
-					dist2 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
-				}
-				else
-				{
-					dist1 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
-
-					if (dist1 < dist2)
-					{
-						closestaxis = mo2;
-						dist2 = dist1;
-					}
+					dist2 = dist1;
 				}
 			}
 		}
@@ -632,7 +583,7 @@ void P_TransferToAxis(player_t *player, INT32 axisnum)
 static void P_DeNightserizePlayer(player_t *player)
 {
 	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 
 	player->pflags &= ~PF_NIGHTSMODE;
 
@@ -681,15 +632,8 @@ static void P_DeNightserizePlayer(player_t *player)
 	}
 
 	// Check to see if the player should be killed.
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, MT_NIGHTSDRONE)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-		if (!(mo2->type == MT_NIGHTSDRONE))
-			continue;
-
 		if (mo2->flags2 & MF2_AMBUSH)
 			P_DamageMobj(player->mo, NULL, NULL, 10000);
 
@@ -1567,8 +1511,7 @@ boolean P_IsDisplayPlayer(player_t *player)
 void P_SpawnShieldOrb(player_t *player)
 {
 	mobjtype_t orbtype;
-	thinker_t *th;
-	mobj_t *shieldobj, *ov;
+	mobj_t *shieldobj, *ov, *next;
 
 #ifdef PARANOIA
 	if (!player->mo)
@@ -1599,14 +1542,9 @@ void P_SpawnShieldOrb(player_t *player)
 	}
 
 	// blaze through the thinkers to see if an orb already exists!
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(shieldobj, next, orbtype)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		shieldobj = (mobj_t *)th;
-
-		if (shieldobj->type == orbtype && shieldobj->target == player->mo)
+		if (shieldobj->target == player->mo)
 			P_RemoveMobj(shieldobj); //kill the old one(s)
 	}
 
@@ -2779,7 +2717,7 @@ static void P_DoClimbing(player_t *player)  // SRB2kart - unused
 			angle_t sideangle;
 			fixed_t dx, dy;
 
-			for (think = thinkercap.next; think != &thinkercap; think = think->next)
+			P_ForEachThinker(think, THINK_MAIN)
 			{
 				if (think->function.acp1 != (actionf_p1)T_Scroll)
 					continue;
@@ -3657,7 +3595,7 @@ void P_Telekinesis(player_t *player, fixed_t thrust, fixed_t range)
 	if (player->powers[pw_super]) // increase range when super
 		range *= 2;
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachThinker(th, THINK_MOBJ)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -4323,7 +4261,7 @@ static void P_NightsTransferPoints(player_t *player, fixed_t xspeed, fixed_t rad
 		fixed_t truexspeed = xspeed*(!(player->pflags & PF_TRANSFERTOCLOSEST) && player->mo->target->flags2 & MF2_AMBUSH ? -1 : 1);
 
 		// Find next waypoint
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachThinker(th, THINK_MOBJ)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
 				continue;
@@ -4359,7 +4297,7 @@ static void P_NightsTransferPoints(player_t *player, fixed_t xspeed, fixed_t rad
 		// Look for a wrapper point.
 		if (!transfer1)
 		{
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			P_ForEachThinker(th, THINK_MOBJ)
 			{
 				if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
 					continue;
@@ -4387,7 +4325,7 @@ static void P_NightsTransferPoints(player_t *player, fixed_t xspeed, fixed_t rad
 		}
 		if (!transfer2)
 		{
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			P_ForEachThinker(th, THINK_MOBJ)
 			{
 				if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
 					continue;
@@ -4853,7 +4791,7 @@ static void P_NiGHTSMovement(player_t *player)
 	INT16 newangle = 0;
 	fixed_t xspeed, yspeed;
 	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 	mobj_t *closestaxis = NULL;
 	fixed_t newx, newy, radius;
 	angle_t movingangle;
@@ -4934,31 +4872,23 @@ static void P_NiGHTSMovement(player_t *player)
 
 		// scan the thinkers
 		// to find the closest axis point
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, next, MT_AXIS)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type == MT_AXIS)
+			if (mo2->threshold == player->mare)
 			{
-				if (mo2->threshold == player->mare)
+				if (closestaxis == NULL)
+				{
+					closestaxis = mo2;
+					dist2 = R_PointToDist2(newx, newy, mo2->x, mo2->y)-mo2->radius;
+				}
+				else
 				{
-					if (closestaxis == NULL)
+					dist1 = R_PointToDist2(newx, newy, mo2->x, mo2->y)-mo2->radius;
+
+					if (dist1 < dist2)
 					{
 						closestaxis = mo2;
-						dist2 = R_PointToDist2(newx, newy, mo2->x, mo2->y)-mo2->radius;
-					}
-					else
-					{
-						dist1 = R_PointToDist2(newx, newy, mo2->x, mo2->y)-mo2->radius;
-
-						if (dist1 < dist2)
-						{
-							closestaxis = mo2;
-							dist2 = dist1;
-						}
+						dist2 = dist1;
 					}
 				}
 			}
@@ -5649,17 +5579,11 @@ static void P_MovePlayer(player_t *player)
 		if (!player->capsule && !player->bonustime)
 		{
 			thinker_t *th;
-			mobj_t *mo2;
+			mobj_t *mo2, *mo2next;
 
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			P_ForEachMobjOfType(mo2, mo2next, MT_EGGCAPSULE)
 			{
-				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-					continue;
-
-				mo2 = (mobj_t *)th;
-
-				if (mo2->type == MT_EGGCAPSULE
-					&& mo2->threshold == player->mare)
+				if (mo2->threshold == player->mare)
 					P_SetTarget(&player->capsule, mo2);
 			}
 		}
@@ -6418,8 +6342,7 @@ static void P_DoZoomTube(player_t *player)
 {
 	INT32 sequence;
 	fixed_t speed;
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *mo2next;
 	mobj_t *waypoint = NULL;
 	fixed_t dist;
 	boolean reverse;
@@ -6468,16 +6391,8 @@ static void P_DoZoomTube(player_t *player)
 		CONS_Debug(DBG_GAMELOGIC, "Looking for next waypoint...\n");
 
 		// Find next waypoint
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, mo2next, MT_TUBEWAYPOINT)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_TUBEWAYPOINT)
-				continue;
-
 			if (mo2->threshold == sequence)
 			{
 				if ((reverse && mo2->health == player->mo->tracer->health - 1)
@@ -6548,7 +6463,7 @@ static void P_DoRopeHang(player_t *player) // SRB2kart - unused.
 	INT32 sequence;
 	fixed_t speed;
 	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *mo2next;
 	mobj_t *waypoint = NULL;
 	fixed_t dist;
 	fixed_t playerz;
@@ -6610,16 +6525,8 @@ static void P_DoRopeHang(player_t *player) // SRB2kart - unused.
 		CONS_Debug(DBG_GAMELOGIC, "Looking for next waypoint...\n");
 
 		// Find next waypoint
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachMobjOfType(mo2, mo2next, MT_TUBEWAYPOINT)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_TUBEWAYPOINT)
-				continue;
-
 			if (mo2->threshold == sequence)
 			{
 				if (mo2->health == player->mo->tracer->health + 1)
@@ -6635,16 +6542,8 @@ static void P_DoRopeHang(player_t *player) // SRB2kart - unused.
 			CONS_Debug(DBG_GAMELOGIC, "Next waypoint not found, wrapping to start...\n");
 
 			// Wrap around back to first waypoint
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			P_ForEachMobjOfType(mo2, mo2next, MT_TUBEWAYPOINT)
 			{
-				if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
-					continue;
-
-				mo2 = (mobj_t *)th;
-
-				if (mo2->type != MT_TUBEWAYPOINT)
-					continue;
-
 				if (mo2->threshold == sequence)
 				{
 					if (mo2->health == 0)
@@ -6705,7 +6604,7 @@ static void P_NukeAllPlayers(player_t *player)
 	mobj_t *mo;
 	thinker_t *think;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	P_ForEachThinker(think, THINK_MOBJ)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -6755,7 +6654,7 @@ void P_NukeEnemies(mobj_t *inflictor, mobj_t *source, fixed_t radius)
 		}
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	P_ForEachThinker(think, THINK_MOBJ)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -6835,7 +6734,7 @@ boolean P_LookForEnemies(player_t *player)
 	mobj_t *closestmo = NULL;
 	angle_t an;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	P_ForEachThinker(think, THINK_MOBJ)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -6953,28 +6852,20 @@ void P_HomingAttack(mobj_t *source, mobj_t *enemy) // Home in on your target
 // Search for emeralds
 void P_FindEmerald(void)
 {
-	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 
 	hunt1 = hunt2 = hunt3 = NULL;
 
 	// scan the remaining thinkers
 	// to find all emeralds
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, MT_EMERHUNT)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-		if (mo2->type == MT_EMERHUNT)
-		{
-			if (!hunt1)
-				hunt1 = mo2;
-			else if (!hunt2)
-				hunt2 = mo2;
-			else if (!hunt3)
-				hunt3 = mo2;
-		}
+		if (!hunt1)
+			hunt1 = mo2;
+		else if (!hunt2)
+			hunt2 = mo2;
+		else if (!hunt3)
+			hunt3 = mo2;
 	}
 	return;
 }
@@ -8620,7 +8511,7 @@ void P_PlayerThink(player_t *player)
 		fixed_t y = player->mo->y;
 		fixed_t z = player->mo->z;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		P_ForEachThinker(th, THINK_MOBJ)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
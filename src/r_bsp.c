@@ -21,21 +21,21 @@
 #include "p_slopes.h"
 #include "z_zone.h" // Check R_Prep3DFloors
 
-seg_t *curline;
-side_t *sidedef;
-line_t *linedef;
-sector_t *frontsector;
-sector_t *backsector;
-boolean portalline; // is curline a portal seg?
+RENDERLOCAL seg_t *curline;
+RENDERLOCAL side_t *sidedef;
+RENDERLOCAL line_t *linedef;
+RENDERLOCAL sector_t *frontsector;
+RENDERLOCAL sector_t *backsector;
+RENDERLOCAL boolean portalline; // is curline a portal seg?
 
 // very ugly realloc() of drawsegs at run-time, I upped it to 512
 // instead of 256.. and someone managed to send me a level with
 // 896 drawsegs! So too bad here's a limit removal a-la-Boom
-drawseg_t *drawsegs = NULL;
-drawseg_t *ds_p = NULL;
+RENDERLOCAL drawseg_t *drawsegs = NULL;
+RENDERLOCAL drawseg_t *ds_p = NULL;
 
 // indicates doors closed wrt automap bugfix:
-INT32 doorclosed;
+RENDERLOCAL INT32 doorclosed;
 
 boolean R_NoEncore(sector_t *sector, boolean ceiling)
 {
@@ -69,8 +69,8 @@ void R_ClearDrawSegs(void)
 #define MAXSEGS (MAXVIDWIDTH/2+1)
 
 // newend is one past the last valid seg
-static cliprange_t *newend;
-static cliprange_t solidsegs[MAXSEGS];
+static RENDERLOCAL cliprange_t *newend;
+static RENDERLOCAL cliprange_t solidsegs[MAXSEGS];
 
 //
 // R_ClipSolidWallSegment
@@ -402,7 +402,7 @@ static void R_AddLine(seg_t *line)
 {
 	INT32 x1, x2;
 	angle_t angle1, angle2, span, tspan;
-	static sector_t tempsec;
+	static RENDERLOCAL sector_t tempsec;
 
 	portalline = false;
 
@@ -649,9 +649,9 @@ static boolean R_CheckBBox(const fixed_t *bspcoord)
 }
 
 
-size_t numpolys;        // number of polyobjects in current subsector
-size_t num_po_ptrs;     // number of polyobject pointers allocated
-polyobj_t **po_ptrs; // temp ptr array to sort polyobject pointers
+RENDERLOCAL size_t numpolys;        // number of polyobjects in current subsector
+RENDERLOCAL size_t num_po_ptrs;     // number of polyobject pointers allocated
+RENDERLOCAL polyobj_t **po_ptrs; // temp ptr array to sort polyobject pointers
 
 //
 // R_PolyobjCompare
@@ -665,7 +665,7 @@ static int R_PolyobjCompare(const void *p1, const void *p2)
 	const polyobj_t *po1 = *(const polyobj_t * const *)p1;
 	const polyobj_t *po2 = *(const polyobj_t * const *)p2;
 
-	return po1->zdist - po2->zdist;
+	return po1->zdist[viewssnum] - po2->zdist[viewssnum];
 }
 
 //
@@ -697,7 +697,7 @@ void R_SortPolyObjects(subsector_t *sub)
 
 		while (po)
 		{
-			po->zdist = R_PointToDist2(viewx, viewy,
+			po->zdist[viewssnum] = R_PointToDist2(viewx, viewy,
 				po->centerPt.x, po->centerPt.y);
 			po_ptrs[i++] = po;
 			po = (polyobj_t *)(po->link.next);
@@ -820,14 +820,14 @@ static void R_AddPolyObjects(subsector_t *sub)
 // Draw one or more line segments.
 //
 
-drawseg_t *firstseg;
+RENDERLOCAL drawseg_t *firstseg;
 
 static void R_Subsector(size_t num)
 {
 	INT32 count, floorlightlevel, ceilinglightlevel, light;
 	seg_t *line;
 	subsector_t *sub;
-	static sector_t tempsec; // Deep water hack
+	static RENDERLOCAL sector_t tempsec; // Deep water hack
 	extracolormap_t *floorcolormap;
 	extracolormap_t *ceilingcolormap;
 	fixed_t floorcenterz, ceilingcenterz;
@@ -863,21 +863,14 @@ static void R_Subsector(size_t num)
 	// Check and prep all 3D floors. Set the sector floor/ceiling light levels and colormaps.
 	if (frontsector->ffloors)
 	{
+		// P_FlagSectorMoved passes control sector changes on to us,
+		// so an unchanged sector keeps the light list it already has.
 		boolean anyMoved = frontsector->moved;
 
-		if (anyMoved == false)
-		{
-			for (rover = frontsector->ffloors; rover; rover = rover->next)
-			{
-				sector_t *controlSec = &sectors[rover->secnum];
-
-				if (controlSec->moved == true)
-				{
-					anyMoved = true;
-					break;
-				}
-			}
-		}
+#ifdef PARALLELVIEWS
+		if (renderthreads)
+			anyMoved = false; // R_PrepMoved3DFloors got to it before the views started
+#endif
 
 		if (anyMoved == true)
 		{
@@ -1062,7 +1055,7 @@ static void R_Subsector(size_t num)
 				ffloor[numffloors].polyobj = po;
 				ffloor[numffloors].slope = NULL;
 //				ffloor[numffloors].ffloor = rover;
-				po->visplane = ffloor[numffloors].plane;
+				po->visplane[viewssnum] = ffloor[numffloors].plane;
 				numffloors++;
 			}
 
@@ -1087,7 +1080,7 @@ static void R_Subsector(size_t num)
 				ffloor[numffloors].height = polysec->ceilingheight;
 				ffloor[numffloors].slope = NULL;
 //				ffloor[numffloors].ffloor = rover;
-				po->visplane = ffloor[numffloors].plane;
+				po->visplane[viewssnum] = ffloor[numffloors].plane;
 				numffloors++;
 			}
 
@@ -1130,6 +1123,31 @@ static void R_Subsector(size_t num)
 	}
 }
 
+#ifdef PARALLELVIEWS
+//
+// R_PrepMoved3DFloors
+//
+// Does R_Subsector's 3D floor prep for the whole level up front, so that
+// splitscreen views drawn at the same time don't all race to do it.
+// Sectors with fake flats get lit from their real heights here.
+//
+void R_PrepMoved3DFloors(void)
+{
+	sector_t *sector;
+	size_t i;
+
+	for (i = 0, sector = sectors; i < numsectors; i++, sector++)
+	{
+		if (!sector->ffloors || !sector->moved)
+			continue;
+
+		sector->numlights = 0;
+		R_Prep3DFloors(sector);
+		sector->moved = false;
+	}
+}
+#endif
+
 //
 // R_Prep3DFloors
 //
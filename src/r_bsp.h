@@ -18,20 +18,20 @@
 #pragma interface
 #endif
 
-extern seg_t *curline;
-extern side_t *sidedef;
-extern line_t *linedef;
-extern sector_t *frontsector;
-extern sector_t *backsector;
-extern boolean portalline; // is curline a portal seg?
+extern RENDERLOCAL seg_t *curline;
+extern RENDERLOCAL side_t *sidedef;
+extern RENDERLOCAL line_t *linedef;
+extern RENDERLOCAL sector_t *frontsector;
+extern RENDERLOCAL sector_t *backsector;
+extern RENDERLOCAL boolean portalline; // is curline a portal seg?
 
 // drawsegs are allocated on the fly... see r_segs.c
 
 extern INT32 checkcoord[12][4];
 
-extern drawseg_t *drawsegs;
-extern drawseg_t *ds_p;
-extern INT32 doorclosed;
+extern RENDERLOCAL drawseg_t *drawsegs;
+extern RENDERLOCAL drawseg_t *ds_p;
+extern RENDERLOCAL INT32 doorclosed;
 
 // BSP?
 void R_ClearClipSegs(void);
@@ -46,9 +46,9 @@ boolean R_NoEncore(sector_t *sector, boolean ceiling);
 
 void R_SortPolyObjects(subsector_t *sub);
 
-extern size_t numpolys;        // number of polyobjects in current subsector
-extern size_t num_po_ptrs;     // number of polyobject pointers allocated
-extern polyobj_t **po_ptrs; // temp ptr array to sort polyobject pointers
+extern RENDERLOCAL size_t numpolys;        // number of polyobjects in current subsector
+extern RENDERLOCAL size_t num_po_ptrs;     // number of polyobject pointers allocated
+extern RENDERLOCAL polyobj_t **po_ptrs; // temp ptr array to sort polyobject pointers
 
 sector_t *R_FakeFlat(sector_t *sec, sector_t *tempsec, INT32 *floorlightlevel,
 	INT32 *ceilinglightlevel, boolean back);
@@ -56,4 +56,7 @@ boolean R_IsEmptyLine(seg_t *line, sector_t *front, sector_t *back);
 
 INT32 R_GetPlaneLight(sector_t *sector, fixed_t planeheight, boolean underside);
 void R_Prep3DFloors(sector_t *sector);
+#ifdef PARALLELVIEWS
+void R_PrepMoved3DFloors(void);
+#endif
 #endif
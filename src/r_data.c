@@ -25,6 +25,10 @@
 #include "v_video.h" // pLocalPalette
 #include "dehacked.h"
 
+#ifdef HAVE_THREADS
+#include "i_threads.h"
+#endif
+
 #if defined (_WIN32) || defined (_WIN32_WCE)
 #include <malloc.h> // alloca(sizeof)
 #endif
@@ -100,6 +104,13 @@ INT32 numtextures = 0; // total number of textures found,
 texture_t **textures = NULL;
 static UINT32 **texturecolumnofs; // column offset lookup table for each texture
 static UINT8 **texturecache; // graphics data for each generated full-size texture
+static size_t *texturesize; // and how big it is
+static UINT32 *texturelastused; // texturetime it was last drawn at
+static UINT32 texturetime; // counts frames, see R_TrimTextureCache
+
+static void TextureBudget_OnChange(void);
+static CV_PossibleValue_t texturebudget_cons_t[] = {{0, "MIN"}, {4096, "MAX"}, {0, NULL}};
+consvar_t cv_texturebudget = {"r_texturebudget", "0", CV_SAVE|CV_CALL, texturebudget_cons_t, TextureBudget_OnChange, 0, NULL, NULL, 0, 0, NULL};
 
 // texture width is a power of 2, so it can easily repeat along sidedefs using a simple mask
 INT32 *texturewidthmask;
@@ -178,26 +189,34 @@ static inline void R_DrawColumnInCache(column_t *patch, UINT8 *cache, INT32 orig
 }
 
 //
-// R_GenerateTexture
+// R_ReleaseTexturePatch
 //
-// Allocate space for full size texture, either single patch or 'composite'
-// Build the full textures from patches.
-// The texture caching system is a little more hungry of memory, but has
-// been simplified for the sake of highcolor, dynamic ligthing, & speed.
+// The patches that go into a texture are cached PU_STATIC while it's being
+// built, so another allocation running out of memory can't purge them from
+// under it. This hands one back to the zone once the texture is done.
 //
-// This is not optimised, but it's supposed to be executed only once
-// per level, when enough memory is available.
+static void R_ReleaseTexturePatch(texpatch_t *patch)
+{
+	W_CacheLumpNumPwad(patch->wad, patch->lump, PU_CACHE);
+}
+
 //
-static UINT8 *R_GenerateTexture(size_t texnum)
+// R_AllocTexture
+//
+// Allocate space for full size texture, either single patch or 'composite'.
+// Single-patch textures with holes are copied over whole right here; for
+// the rest, R_CompositeTexture draws the patches in afterwards. If
+// realpatches is given, it's filled with the patches it will need, which
+// stay PU_STATIC until R_ReleaseTexturePatch.
+//
+static UINT8 *R_AllocTexture(size_t texnum, patch_t **realpatches)
 {
 	UINT8 *block;
-	UINT8 *blocktex;
 	texture_t *texture;
 	texpatch_t *patch;
 	patch_t *realpatch;
-	int x, x1, x2, i;
+	int x, i;
 	size_t blocksize;
-	column_t *patchcol;
 	UINT8 *colofs;
 
 	I_Assert(texnum <= (size_t)numtextures);
@@ -214,7 +233,7 @@ static UINT8 *R_GenerateTexture(size_t texnum)
 	{
 		boolean holey = false;
 		patch = texture->patches;
-		realpatch = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_CACHE);
+		realpatch = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_STATIC);
 
 		// Check the patch for holes.
 		if (texture->width > SHORT(realpatch->width) || texture->height > SHORT(realpatch->height))
@@ -244,42 +263,67 @@ static UINT8 *R_GenerateTexture(size_t texnum)
 		{
 			texture->holes = true;
 			blocksize = W_LumpLengthPwad(patch->wad, patch->lump);
-			block = Z_Calloc(blocksize, PU_STATIC, // will change tag at end of this function
-				&texturecache[texnum]);
+			block = Z_Calloc(blocksize, PU_STATIC, // will change tag and user in R_PublishTexture
+				NULL);
 			M_Memcpy(block, realpatch, blocksize);
+			R_ReleaseTexturePatch(patch);
 			texturememory += blocksize;
+			texturesize[texnum] = blocksize;
 
 			// use the patch's column lookup
 			colofs = (block + 8);
 			texturecolumnofs[texnum] = (UINT32 *)colofs;
-			blocktex = block;
 			for (x = 0; x < texture->width; x++)
 				*(UINT32 *)&colofs[x<<2] = LONG(LONG(*(UINT32 *)&colofs[x<<2]) + 3);
-			goto done;
+			return block;
 		}
 
 		// Otherwise, do multipatch format.
+		R_ReleaseTexturePatch(patch);
 	}
 
 	// multi-patch textures (or 'composite')
 	texture->holes = false;
 	blocksize = (texture->width * 4) + (texture->width * texture->height);
 	texturememory += blocksize;
-	block = Z_Malloc(blocksize+1, PU_STATIC, &texturecache[texnum]);
-
-	memset(block, 0xF7, blocksize+1); // Transparency hack
+	texturesize[texnum] = blocksize;
+	block = Z_Malloc(blocksize+1, PU_STATIC, NULL);
 
 	// columns lookup table
-	colofs = block;
-	texturecolumnofs[texnum] = (UINT32 *)colofs;
+	texturecolumnofs[texnum] = (UINT32 *)block;
+
+	if (realpatches)
+		for (i = 0, patch = texture->patches; i < texture->patchcount; i++, patch++)
+			realpatches[i] = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_STATIC);
+
+	return block;
+}
+
+//
+// R_CompositeTexture
+//
+// Build the full texture from its patches, in the block R_AllocTexture
+// made for it. Touches nothing but the two, so the precache threads can
+// run it; without realpatches, the patches are cached here instead, and
+// let go of again as soon as each is drawn in.
+//
+static void R_CompositeTexture(texture_t *texture, UINT8 *block, patch_t **realpatches)
+{
+	texpatch_t *patch;
+	patch_t *realpatch;
+	int x, x1, x2, i;
+	column_t *patchcol;
+	UINT8 *colofs = block;
+
+	if (texture->holes)
+		return; // already copied
 
-	// texture data after the lookup table
-	blocktex = block + (texture->width*4);
+	memset(block, 0xF7, (texture->width * 4) + (texture->width * texture->height) + 1); // Transparency hack
 
 	// Composite the columns together.
 	for (i = 0, patch = texture->patches; i < texture->patchcount; i++, patch++)
 	{
-		realpatch = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_CACHE);
+		realpatch = realpatches ? realpatches[i] : W_CacheLumpNumPwad(patch->wad, patch->lump, PU_STATIC);
 		x1 = patch->originx;
 		x2 = x1 + SHORT(realpatch->width);
 
@@ -299,12 +343,101 @@ static UINT8 *R_GenerateTexture(size_t texnum)
 			*(UINT32 *)&colofs[x<<2] = LONG((x * texture->height) + (texture->width*4));
 			R_DrawColumnInCache(patchcol, block + LONG(*(UINT32 *)&colofs[x<<2]), patch->originy, texture->height);
 		}
+
+		if (!realpatches)
+			R_ReleaseTexturePatch(patch);
+	}
+}
+
+static void R_PublishTexture(size_t texnum, UINT8 *block)
+{
+	// Only publish the block once it's complete, other views may be looking.
+	Z_SetUser(block, (void **)&texturecache[texnum]);
+	texturelastused[texnum] = texturetime;
+	// Now that the texture has been built in column cache, it is purgable from zone memory,
+	// or with a budget, left for R_TrimTextureCache to throw out.
+	Z_ChangeTag(block, cv_texturebudget.value ? PU_STATIC : PU_CACHE);
+}
+
+//
+// R_GenerateTexture
+//
+// Builds a texture the first time it's drawn. This is what R_PrecacheLevel
+// is there to avoid: it's not optimised, and compositing big textures in
+// the middle of a frame shows.
+//
+static UINT8 *R_GenerateTexture(size_t texnum)
+{
+	UINT8 *block = R_AllocTexture(texnum, NULL);
+
+	R_CompositeTexture(textures[texnum], block, NULL);
+	R_PublishTexture(texnum, block);
+	return block;
+}
+
+// Total size of the textures built right now
+static size_t R_TextureCacheSize(void)
+{
+	size_t total = 0;
+	INT32 i;
+
+	for (i = 0; i < numtextures; i++)
+		if (texturecache[i])
+			total += texturesize[i];
+	return total;
+}
+
+static int R_CompareTextureAge(const void *a, const void *b)
+{
+	UINT32 ta = texturelastused[*(const INT32 *)a], tb = texturelastused[*(const INT32 *)b];
+	return (ta > tb) - (ta < tb);
+}
+
+//
+// R_TrimTextureCache
+//
+// Once a frame, before any views are drawn. With r_texturebudget set, frees
+// the textures that went longest without being drawn until the cache fits
+// in the budget again. Whatever was drawn last frame stays regardless.
+//
+void R_TrimTextureCache(void)
+{
+	const size_t budget = (size_t)cv_texturebudget.value<<20;
+	size_t total;
+	INT32 *order;
+	INT32 i, n = 0;
+
+	texturetime++;
+
+	if (!budget || (total = R_TextureCacheSize()) <= budget)
+		return;
+
+	order = malloc(numtextures * sizeof (*order));
+	if (!order)
+		return;
+
+	for (i = 0; i < numtextures; i++)
+		if (texturecache[i] && texturelastused[i] + 1 < texturetime)
+			order[n++] = i;
+	qsort(order, n, sizeof (*order), R_CompareTextureAge);
+
+	for (i = 0; i < n && total > budget; i++)
+	{
+		total -= texturesize[order[i]];
+		texturememory -= texturesize[order[i]];
+		Z_Free(texturecache[order[i]]);
 	}
+	free(order);
+}
+
+static void TextureBudget_OnChange(void)
+{
+	INT32 i;
 
-done:
-	// Now that the texture has been built in column cache, it is purgable from zone memory.
-	Z_ChangeTag(block, PU_CACHE);
-	return blocktex;
+	// Hand the textures already built over to the zone, or take them back.
+	for (i = 0; i < numtextures; i++)
+		if (texturecache[i])
+			Z_ChangeTag(texturecache[i], cv_texturebudget.value ? PU_STATIC : PU_CACHE);
 }
 
 //
@@ -330,7 +463,12 @@ INT32 R_GetTextureNum(INT32 texnum)
 void R_CheckTextureCache(INT32 tex)
 {
 	if (!texturecache[tex])
-		R_GenerateTexture(tex);
+	{
+		R_LockShared();
+		if (!texturecache[tex]) // another view may have beaten us to it
+			R_GenerateTexture(tex);
+		R_UnlockShared();
+	}
 }
 
 //
@@ -343,8 +481,17 @@ UINT8 *R_GetColumn(fixed_t tex, INT32 col)
 	col &= texturewidthmask[tex];
 	data = texturecache[tex];
 
+	if (texturelastused[tex] != texturetime) // don't dirty the line for the other views
+		texturelastused[tex] = texturetime;
+
 	if (!data)
-		data = R_GenerateTexture(tex);
+	{
+		R_LockShared();
+		data = texturecache[tex];
+		if (!data) // another view may have beaten us to it
+			data = R_GenerateTexture(tex);
+		R_UnlockShared();
+	}
 
 	return data + LONG(texturecolumnofs[tex][col]);
 }
@@ -450,8 +597,8 @@ void R_LoadTextures(void)
 		I_Error("No textures detected in any WADs!\n");
 
 	// Allocate memory and initialize to 0 for all the textures we are initialising.
-	// There are actually 5 buffers allocated in one for convenience.
-	textures = Z_Calloc((numtextures * sizeof(void *)) * 5, PU_STATIC, NULL);
+	// There are actually 7 buffers allocated in one for convenience.
+	textures = Z_Calloc((numtextures * sizeof(void *)) * 7, PU_STATIC, NULL);
 
 	// Allocate texture column offset table.
 	texturecolumnofs = (void *)((UINT8 *)textures + (numtextures * sizeof(void *)));
@@ -461,6 +608,9 @@ void R_LoadTextures(void)
 	texturewidthmask = (void *)((UINT8 *)textures + ((numtextures * sizeof(void *)) * 3));
 	// Allocate texture height mask table.
 	textureheight    = (void *)((UINT8 *)textures + ((numtextures * sizeof(void *)) * 4));
+	// Allocate the cache's bookkeeping for R_TrimTextureCache.
+	texturesize      = (void *)((UINT8 *)textures + ((numtextures * sizeof(void *)) * 5));
+	texturelastused  = (void *)((UINT8 *)textures + ((numtextures * sizeof(void *)) * 6));
 	// Create translation table for global animation.
 	texturetranslation = Z_Malloc((numtextures + 1) * sizeof(*texturetranslation), PU_STATIC, NULL);
 
@@ -1115,6 +1265,8 @@ void R_ReInitColormaps(UINT16 num, lumpnum_t newencoremap)
 	else
 		encoremap = NULL;
 
+	R_ClearSkyCache();
+
 	// Init Boom colormaps.
 	R_ClearColormaps();
 }
@@ -1590,6 +1742,167 @@ INT32 R_TextureNumForName(const char *name)
 	return i;
 }
 
+// Composites textures for R_PrecacheTextures, a few threads at once.
+#define PRECACHE_THREADS 4
+
+typedef struct
+{
+	size_t texnum;
+	UINT8 *block;
+	patch_t **realpatches;
+} texturejob_t;
+
+static texturejob_t *texturejobs;
+static size_t numtexturejobs, nexttexturejob, texturejobsdone;
+static size_t textureworkers; // threads that haven't left R_TextureWorker yet
+
+#ifdef HAVE_THREADS
+static I_mutex texturejob_mutex;
+static I_cond texturejob_cond;
+#endif
+
+// Runs on the precache threads, so it mustn't touch anything but its jobs.
+static void R_TextureWorker(void *userdata)
+{
+	texturejob_t *job;
+	size_t i;
+
+	(void)userdata;
+	for (;;)
+	{
+#ifdef HAVE_THREADS
+		I_lock_mutex(&texturejob_mutex);
+#endif
+		i = nexttexturejob++;
+		if (i >= numtexturejobs)
+		{
+			textureworkers--;
+#ifdef HAVE_THREADS
+			I_wake_all_cond(&texturejob_cond);
+			I_unlock_mutex(texturejob_mutex);
+#endif
+			return;
+		}
+#ifdef HAVE_THREADS
+		I_unlock_mutex(texturejob_mutex);
+#endif
+
+		job = &texturejobs[i];
+		R_CompositeTexture(textures[job->texnum], job->block, job->realpatches);
+
+#ifdef HAVE_THREADS
+		I_lock_mutex(&texturejob_mutex);
+		if (++texturejobsdone == numtexturejobs)
+			I_wake_all_cond(&texturejob_cond);
+		I_unlock_mutex(texturejob_mutex);
+#else
+		texturejobsdone++;
+#endif
+	}
+}
+
+//
+// R_PrecacheTextures
+//
+// Builds every texture in the list that isn't already. Blocks are allocated
+// and patches cached here, then the compositing is spread across threads,
+// then the lot is handed over to the cache. With a budget set, stops
+// before going over it.
+//
+static void R_PrecacheTextures(const char *texturepresent)
+{
+	const size_t budget = (size_t)cv_texturebudget.value<<20;
+	size_t cached = R_TextureCacheSize();
+	size_t i, numpatches = 0;
+	patch_t **patchlist;
+#ifdef HAVE_THREADS
+	size_t threads;
+#endif
+
+	for (i = 0; i < (unsigned)numtextures; i++)
+		if (texturepresent[i] && !texturecache[i])
+		{
+			numtexturejobs++;
+			numpatches += textures[i]->patchcount;
+		}
+	if (!numtexturejobs)
+		return;
+
+	texturejobs = Z_Calloc(numtexturejobs * sizeof (*texturejobs), PU_STATIC, NULL);
+	patchlist = Z_Malloc(max(numpatches, 1) * sizeof (*patchlist), PU_STATIC, NULL);
+	numtexturejobs = nexttexturejob = texturejobsdone = numpatches = 0;
+
+	for (i = 0; i < (unsigned)numtextures; i++)
+	{
+		texturejob_t *job = &texturejobs[numtexturejobs];
+		texture_t *texture = textures[i];
+
+		if (!texturepresent[i] || texturecache[i])
+			continue;
+
+		if (budget && cached + (texture->width * 4) + (texture->width * texture->height) > budget)
+			break; // the rest can wait until they're drawn
+
+		job->texnum = i;
+		job->realpatches = &patchlist[numpatches];
+		job->block = R_AllocTexture(i, job->realpatches);
+		cached += texturesize[i];
+		numpatches += texture->patchcount;
+		numtexturejobs++;
+	}
+
+#ifdef HAVE_THREADS
+	// the main thread pitches in too
+	I_lock_mutex(&texturejob_mutex);
+	textureworkers = 1;
+	I_unlock_mutex(texturejob_mutex);
+	for (threads = 1; threads < numtexturejobs && threads < PRECACHE_THREADS; threads++)
+	{
+		I_lock_mutex(&texturejob_mutex);
+		textureworkers++;
+		I_unlock_mutex(texturejob_mutex);
+		if (!I_spawn_thread("tex-precache", R_TextureWorker, NULL))
+		{
+			I_lock_mutex(&texturejob_mutex);
+			textureworkers--;
+			I_unlock_mutex(texturejob_mutex);
+			break;
+		}
+	}
+	R_TextureWorker(NULL);
+
+	// Every worker has to be out of R_TextureWorker, not just done with
+	// its last job, before the job list can go.
+	I_lock_mutex(&texturejob_mutex);
+	while (texturejobsdone < numtexturejobs || textureworkers)
+		I_hold_cond(&texturejob_cond, texturejob_mutex);
+	I_unlock_mutex(texturejob_mutex);
+#else
+	textureworkers = 1;
+	R_TextureWorker(NULL);
+#endif
+
+	for (i = 0; i < numtexturejobs; i++)
+		R_PublishTexture(texturejobs[i].texnum, texturejobs[i].block);
+
+	// Only now, with every texture built, can their patches be purged.
+	for (i = 0; i < numtexturejobs; i++)
+	{
+		texture_t *texture = textures[texturejobs[i].texnum];
+		INT32 p;
+
+		if (texture->holes)
+			continue; // let go of in R_AllocTexture
+		for (p = 0; p < texture->patchcount; p++)
+			R_ReleaseTexturePatch(&texture->patches[p]);
+	}
+
+	Z_Free(patchlist);
+	Z_Free(texturejobs);
+	texturejobs = NULL;
+	numtexturejobs = 0;
+}
+
 //
 // R_PrecacheLevel
 //
@@ -1639,16 +1952,9 @@ void R_PrecacheLevel(void)
 	texturepresent[skytexture] = 1;
 
 	texturememory = 0;
-	for (j = 0; j < (unsigned)numtextures; j++)
-	{
-		if (!texturepresent[j])
-			continue;
-
-		if (!texturecache[j])
-			R_GenerateTexture(j);
-		// pre-caching individual patches that compose textures became obsolete,
-		// since we cache entire composite textures
-	}
+	// pre-caching individual patches that compose textures became obsolete,
+	// since we cache entire composite textures
+	R_PrecacheTextures(texturepresent);
 	free(texturepresent);
 
 	//
@@ -1657,7 +1963,7 @@ void R_PrecacheLevel(void)
 	spritepresent = calloc(numsprites, sizeof (*spritepresent));
 	if (spritepresent == NULL) I_Error("%s: Out of memory looking up sprites", "R_PrecacheLevel");
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachThinker(th, THINK_MOBJ)
 		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
 			spritepresent[((mobj_t *)th)->sprite] = 1;
 
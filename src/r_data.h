@@ -65,6 +65,10 @@ extern CV_PossibleValue_t Color_cons_t[];
 void R_LoadTextures(void);
 void R_FlushTextureCache(void);
 
+// Memory budget for built textures, in megabytes (0 leaves it to the zone)
+extern consvar_t cv_texturebudget;
+void R_TrimTextureCache(void);
+
 INT32 R_GetTextureNum(INT32 texnum);
 void R_CheckTextureCache(INT32 tex);
 
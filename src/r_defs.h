@@ -292,6 +292,7 @@ typedef struct sector_s
 
 	// if == validcount, already checked
 	size_t validcount;
+	size_t spritevalidcount[MAXSPLITSCREENPLAYERS]; // same, for R_AddSprites in each view
 
 	// list of mobjs in sector
 	mobj_t *thinglist;
@@ -364,9 +365,8 @@ typedef struct sector_s
 	// Current speed of ceiling/floor. For Knuckles to hold onto stuff.
 	fixed_t floorspeed, ceilspeed;
 
-	// list of precipitation mobjs in sector
-	precipmobj_t *preciplist;
-	struct mprecipsecnode_s *touching_preciplist;
+	// precipitation drops under this sector, see R_SetupPrecipitation
+	size_t firstprecip, numprecip;
 
 	// Eternity engine slope
 	pslope_t *f_slope; // floor slope
@@ -501,16 +501,6 @@ typedef struct msecnode_s
 	boolean visited; // used in search algorithms
 } msecnode_t;
 
-typedef struct mprecipsecnode_s
-{
-	sector_t *m_sector; // a sector containing this object
-	struct precipmobj_s *m_thing;  // this object
-	struct mprecipsecnode_s *m_sectorlist_prev;  // prev msecnode_t for this thing
-	struct mprecipsecnode_s *m_sectorlist_next;  // next msecnode_t for this thing
-	struct mprecipsecnode_s *m_thinglist_prev;  // prev msecnode_t for this sector
-	struct mprecipsecnode_s *m_thinglist_next;  // next msecnode_t for this sector
-	boolean visited; // used in search algorithms
-} mprecipsecnode_t;
 
 //
 // The lineseg.
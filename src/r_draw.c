@@ -37,11 +37,12 @@
 
 /**	\brief view info
 */
-INT32 viewwidth, scaledviewwidth, viewheight, viewwindowx, viewwindowy;
+INT32 viewwidth, scaledviewwidth, viewheight;
+RENDERLOCAL INT32 viewwindowx, viewwindowy;
 
 /**	\brief pointer to the start of each line of the screen,
 */
-UINT8 *ylookup[MAXVIDHEIGHT*4];
+RENDERLOCAL UINT8 *ylookup[MAXVIDHEIGHT*4];
 
 /**	\brief pointer to the start of each line of the screen, for view1 (splitscreen)
 */
@@ -64,19 +65,23 @@ UINT8 *ylookup4[MAXVIDHEIGHT*4];
 */
 INT32 columnofs[MAXVIDWIDTH*4];
 
-UINT8 *topleft;
+RENDERLOCAL UINT8 *topleft;
+
+/**	\brief the columns of the view this thread draws, see R_DrawSlices
+*/
+RENDERLOCAL INT32 slicex1 = 0, slicex2 = MAXVIDWIDTH-1;
 
 // =========================================================================
 //                      COLUMN DRAWING CODE STUFF
 // =========================================================================
 
-lighttable_t *dc_colormap;
-INT32 dc_x = 0, dc_yl = 0, dc_yh = 0;
+RENDERLOCAL lighttable_t *dc_colormap;
+RENDERLOCAL INT32 dc_x = 0, dc_yl = 0, dc_yh = 0;
 
-fixed_t dc_iscale, dc_texturemid;
-UINT8 dc_hires; // under MSVC boolean is a byte, while on other systems, it a bit,
+RENDERLOCAL fixed_t dc_iscale, dc_texturemid;
+RENDERLOCAL UINT8 dc_hires; // under MSVC boolean is a byte, while on other systems, it a bit,
                // soo lets make it a byte on all system for the ASM code
-UINT8 *dc_source;
+RENDERLOCAL UINT8 *dc_source;
 
 // -----------------------
 // translucency stuff here
@@ -87,7 +92,7 @@ UINT8 *transtables; // translucency tables
 
 /**	\brief R_DrawTransColumn uses this
 */
-UINT8 *dc_transmap; // one of the translucency tables
+RENDERLOCAL UINT8 *dc_transmap; // one of the translucency tables
 
 // ----------------------
 // translation stuff here
@@ -96,30 +101,31 @@ UINT8 *dc_transmap; // one of the translucency tables
 
 /**	\brief R_DrawTranslatedColumn uses this
 */
-UINT8 *dc_translation;
+RENDERLOCAL UINT8 *dc_translation;
 
-struct r_lightlist_s *dc_lightlist = NULL;
-INT32 dc_numlights = 0, dc_maxlights, dc_texheight;
+RENDERLOCAL struct r_lightlist_s *dc_lightlist = NULL;
+RENDERLOCAL INT32 dc_numlights = 0, dc_maxlights, dc_texheight;
 
 // =========================================================================
 //                      SPAN DRAWING CODE STUFF
 // =========================================================================
 
-INT32 ds_y, ds_x1, ds_x2;
-lighttable_t *ds_colormap;
-fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+RENDERLOCAL INT32 ds_y, ds_x1, ds_x2;
+RENDERLOCAL lighttable_t *ds_colormap;
+RENDERLOCAL fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
 
-UINT8 *ds_source; // start of a 64*64 tile image
-UINT8 *ds_transmap; // one of the translucency tables
+RENDERLOCAL UINT8 *ds_source; // start of a 64*64 tile image
+RENDERLOCAL UINT8 *ds_transmap; // one of the translucency tables
 
-pslope_t *ds_slope; // Current slope being used
-floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
-float focallengthf, zeroheight;
+RENDERLOCAL pslope_t *ds_slope; // Current slope being used
+RENDERLOCAL floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
+float focallengthf;
+RENDERLOCAL float zeroheight;
 
 /**	\brief Variable flat sizes
 */
 
-UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
+RENDERLOCAL UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
 
 // ==========================================================================
 //                        OLD DOOM FUZZY EFFECT
@@ -535,6 +541,7 @@ UINT8* R_GetTranslationColormap(INT32 skinnum, skincolors_t color, UINT8 flags)
 
 	if (flags & GTC_CACHE)
 	{
+		R_LockShared(); // splitscreen views share the cache; released below
 
 		// Allocate table for skin if necessary
 		if (!translationtablecache[skintableindex])
@@ -556,6 +563,8 @@ UINT8* R_GetTranslationColormap(INT32 skinnum, skincolors_t color, UINT8 flags)
 			translationtablecache[skintableindex][color] = ret;
 	}
 
+	if (flags & GTC_CACHE)
+		R_UnlockShared();
 	return ret;
 }
 
@@ -813,6 +822,245 @@ void R_DrawViewBorder(void)
 
 #include "r_draw8.c"
 
+#ifdef SIMDDRAW
+#include <immintrin.h>
+
+#define SIMD_SSE2 1
+#define SIMD_AVX2 2
+
+#define SIMDISA SIMD_SSE2
+#include "r_draw8_simd.c"
+#undef SIMDISA
+
+#define SIMDISA SIMD_AVX2
+#include "r_draw8_simd.c"
+#undef SIMDISA
+#endif
+
+// ==========================================================================
+//                   DRAWER CHECK
+// ==========================================================================
+
+#define CHECKWIDTH 320
+#define CHECKHEIGHT 200
+#define CHECKRUNS 4096
+
+typedef struct
+{
+	const char *name;
+	void (*ref)(void);
+	void (*test)(void);
+	UINT8 kind; // 0 column, 1 span, 2 tilted span
+} drawercheck_t;
+
+// Same sequence every time, so a failure can be looked at again
+static UINT32 R_CheckRandom(UINT32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 8;
+}
+
+static void R_CheckDrawTo(UINT8 *buf)
+{
+	INT32 y;
+
+	screens[0] = topleft = buf;
+	for (y = 0; y < CHECKHEIGHT; y++)
+		ylookup[y] = buf + y*CHECKWIDTH;
+}
+
+// Random but sane inputs for one call of a drawer
+static void R_CheckDrawerInputs(UINT8 kind, UINT32 *seed)
+{
+	static const INT32 heights[] = {16, 32, 64, 128, 256, 72, 100, 200};
+	UINT32 r;
+
+	if (kind == 0)
+	{
+		dc_x = R_CheckRandom(seed) % CHECKWIDTH;
+		dc_yl = R_CheckRandom(seed) % CHECKHEIGHT;
+		dc_yh = dc_yl + R_CheckRandom(seed) % (CHECKHEIGHT - dc_yl);
+		dc_iscale = R_CheckRandom(seed) % (4*FRACUNIT) + 1;
+		dc_texturemid = (fixed_t)(R_CheckRandom(seed) << 8);
+		dc_texheight = heights[R_CheckRandom(seed) % (sizeof (heights) / sizeof (*heights))];
+		dc_hires = (R_CheckRandom(seed) % 4 == 0);
+		return;
+	}
+
+	ds_y = R_CheckRandom(seed) % CHECKHEIGHT;
+	ds_x1 = R_CheckRandom(seed) % CHECKWIDTH;
+	ds_x2 = ds_x1 + R_CheckRandom(seed) % (CHECKWIDTH - ds_x1);
+	ds_xfrac = (fixed_t)(R_CheckRandom(seed) << 8);
+	ds_yfrac = (fixed_t)(R_CheckRandom(seed) << 8);
+	ds_xstep = (fixed_t)(R_CheckRandom(seed) % (8*FRACUNIT)) - 4*FRACUNIT;
+	ds_ystep = (fixed_t)(R_CheckRandom(seed) % (8*FRACUNIT)) - 4*FRACUNIT;
+
+	r = R_CheckRandom(seed) % 3;
+	nflatmask = (r == 0) ? 0xFC0 : (r == 1) ? 0x3F80 : 0xFF00;
+	nflatxshift = 26 - r;
+	nflatyshift = 20 - 2*r;
+	nflatshiftup = 10 - r;
+
+	if (kind == 2)
+	{
+		ds_sz.x = (float)((INT32)(R_CheckRandom(seed) % 2001) - 1000) / 1000000.0f;
+		ds_sz.y = (float)((INT32)(R_CheckRandom(seed) % 2001) - 1000) / 1000000.0f;
+		ds_sz.z = 0.5f + (float)(R_CheckRandom(seed) % 1000) / 1000.0f;
+		ds_su.x = (float)((INT32)(R_CheckRandom(seed) % 2001) - 1000);
+		ds_su.y = (float)((INT32)(R_CheckRandom(seed) % 2001) - 1000);
+		ds_su.z = (float)((INT32)(R_CheckRandom(seed) % 200001) - 100000) * 256.0f;
+		ds_sv.x = (float)((INT32)(R_CheckRandom(seed) % 2001) - 1000);
+		ds_sv.y = (float)((INT32)(R_CheckRandom(seed) % 2001) - 1000);
+		ds_sv.z = (float)((INT32)(R_CheckRandom(seed) % 200001) - 100000) * 256.0f;
+		zeroheight = (float)(R_CheckRandom(seed) % 2000) + 1.0f;
+	}
+}
+
+/** Renders the same random inputs through the C drawers and each
+  * SIMD drawer this CPU can run, and compares the results byte for byte.
+  * Started with -drawercheck.
+  *
+  * \return true if every drawer matched.
+  */
+boolean R_CheckDrawers(void)
+{
+#ifdef SIMDDRAW
+	drawercheck_t checks[] = {
+		{"R_DrawColumn_8_SSE2", R_DrawColumn_8, R_DrawColumn_8_SSE2, 0},
+		{"R_DrawTranslucentColumn_8_SSE2", R_DrawTranslucentColumn_8, R_DrawTranslucentColumn_8_SSE2, 0},
+		{"R_DrawSpan_8_SSE2", R_DrawSpan_8, R_DrawSpan_8_SSE2, 1},
+		{"R_DrawTranslucentSpan_8_SSE2", R_DrawTranslucentSpan_8, R_DrawTranslucentSpan_8_SSE2, 1},
+		{"R_DrawTiltedSpan_8_SSE2", R_DrawTiltedSpan_8, R_DrawTiltedSpan_8_SSE2, 2},
+		{"R_DrawColumn_8_AVX2", R_DrawColumn_8, R_DrawColumn_8_AVX2, 0},
+		{"R_DrawTranslucentColumn_8_AVX2", R_DrawTranslucentColumn_8, R_DrawTranslucentColumn_8_AVX2, 0},
+		{"R_DrawSpan_8_AVX2", R_DrawSpan_8, R_DrawSpan_8_AVX2, 1},
+		{"R_DrawTranslucentSpan_8_AVX2", R_DrawTranslucentSpan_8, R_DrawTranslucentSpan_8_AVX2, 1},
+		{"R_DrawTiltedSpan_8_AVX2", R_DrawTiltedSpan_8, R_DrawTiltedSpan_8_AVX2, 2},
+	};
+	const size_t numchecks = sizeof (checks) / sizeof (*checks);
+	UINT8 *base, *ref, *test, *source, *tables;
+	lighttable_t *lights[MAXLIGHTSCALE];
+	UINT8 *savedylookup[CHECKHEIGHT];
+	INT32 savedcolumnofs[CHECKWIDTH];
+	viddef_t savedvid = vid;
+	UINT8 *savedscreen = screens[0], *savedtopleft = topleft;
+	lighttable_t **savedplanezlight = planezlight;
+	INT32 savedcenterx = centerx, savedcentery = centery;
+	fixed_t savedcenteryfrac = centeryfrac;
+	fixed_t savedviewx = viewx, savedviewy = viewy, savedviewz = viewz;
+	UINT32 savedmask = nflatmask, savedxshift = nflatxshift, savedyshift = nflatyshift, savedshiftup = nflatshiftup;
+	float savedzeroheight = zeroheight;
+	boolean ok = true;
+	size_t c, i, run;
+	UINT32 seed;
+
+	base = malloc(CHECKWIDTH*CHECKHEIGHT);
+	ref = malloc(CHECKWIDTH*CHECKHEIGHT);
+	test = malloc(CHECKWIDTH*CHECKHEIGHT);
+	source = malloc(65536);
+	tables = malloc(256*(MAXLIGHTSCALE + 256));
+	if (!base || !ref || !test || !source || !tables)
+		I_Error("R_CheckDrawers: No more free memory");
+
+	seed = 1;
+	for (i = 0; i < CHECKWIDTH*CHECKHEIGHT; i++)
+		base[i] = (UINT8)R_CheckRandom(&seed);
+	for (i = 0; i < 65536; i++)
+		source[i] = (UINT8)R_CheckRandom(&seed);
+	for (i = 0; i < 256*(MAXLIGHTSCALE + 256); i++)
+		tables[i] = (UINT8)R_CheckRandom(&seed);
+	for (i = 0; i < MAXLIGHTSCALE; i++)
+		lights[i] = tables + i*256;
+
+	M_Memcpy(savedylookup, ylookup, sizeof (savedylookup));
+	M_Memcpy(savedcolumnofs, columnofs, sizeof (savedcolumnofs));
+	for (i = 0; i < CHECKWIDTH; i++)
+		columnofs[i] = (INT32)i;
+	vid.width = vid.rowbytes = CHECKWIDTH;
+	vid.height = CHECKHEIGHT;
+	centerx = CHECKWIDTH/2;
+	centery = CHECKHEIGHT/2;
+	centeryfrac = centery<<FRACBITS;
+	viewx = viewy = 0;
+	viewz = 64<<FRACBITS;
+	planezlight = lights;
+
+	dc_source = ds_source = source;
+	dc_colormap = tables;
+	dc_transmap = ds_transmap = tables + 256*MAXLIGHTSCALE;
+
+	for (c = 0; c < numchecks; c++)
+	{
+		if (strstr(checks[c].name, "_SSE2") ? !R_SSE2 : !R_AVX2)
+			continue;
+
+		// tilted spans light through planezlight, offset by where ds_colormap is in colormaps
+		ds_colormap = (checks[c].kind == 2) ? colormaps : tables;
+
+		seed = 1;
+		for (run = 0; run < CHECKRUNS; run++)
+		{
+			const UINT32 runseed = seed;
+
+			R_CheckDrawerInputs(checks[c].kind, &seed);
+			M_Memcpy(ref, base, CHECKWIDTH*CHECKHEIGHT);
+			R_CheckDrawTo(ref);
+			checks[c].ref();
+
+			// again, since the tilted drawers move ds_x1 along
+			seed = runseed;
+			R_CheckDrawerInputs(checks[c].kind, &seed);
+			M_Memcpy(test, base, CHECKWIDTH*CHECKHEIGHT);
+			R_CheckDrawTo(test);
+			checks[c].test();
+
+			if (memcmp(ref, test, CHECKWIDTH*CHECKHEIGHT))
+				break;
+		}
+
+		if (run < CHECKRUNS)
+		{
+			CONS_Alert(CONS_ERROR, "Drawer check: %s differs from the C drawer on run %s\n", checks[c].name, sizeu1(run));
+			ok = false;
+		}
+		else
+			CONS_Printf("Drawer check: %s matches\n", checks[c].name);
+	}
+
+	M_Memcpy(ylookup, savedylookup, sizeof (savedylookup));
+	M_Memcpy(columnofs, savedcolumnofs, sizeof (savedcolumnofs));
+	vid = savedvid;
+	screens[0] = savedscreen;
+	topleft = savedtopleft;
+	planezlight = savedplanezlight;
+	centerx = savedcenterx;
+	centery = savedcentery;
+	centeryfrac = savedcenteryfrac;
+	viewx = savedviewx;
+	viewy = savedviewy;
+	viewz = savedviewz;
+	nflatmask = savedmask;
+	nflatxshift = savedxshift;
+	nflatyshift = savedyshift;
+	nflatshiftup = savedshiftup;
+	zeroheight = savedzeroheight;
+
+	free(base);
+	free(ref);
+	free(test);
+	free(source);
+	free(tables);
+	return ok;
+#else
+	CONS_Printf("Drawer check: no SIMD drawers in this build\n");
+	return true;
+#endif
+}
+
+#undef CHECKWIDTH
+#undef CHECKHEIGHT
+#undef CHECKRUNS
+
 // ==========================================================================
 //                   INCLUDE 16bpp DRAWING CODE HERE
 // ==========================================================================
@@ -19,62 +19,64 @@
 // -------------------------------
 // COMMON STUFF FOR 8bpp AND 16bpp
 // -------------------------------
-extern UINT8 *ylookup[MAXVIDHEIGHT*4];
+extern RENDERLOCAL UINT8 *ylookup[MAXVIDHEIGHT*4];
 extern UINT8 *ylookup1[MAXVIDHEIGHT*4];
 extern UINT8 *ylookup2[MAXVIDHEIGHT*4];
 extern UINT8 *ylookup3[MAXVIDHEIGHT*4];
 extern UINT8 *ylookup4[MAXVIDHEIGHT*4];
 extern INT32 columnofs[MAXVIDWIDTH*4];
-extern UINT8 *topleft;
+extern RENDERLOCAL UINT8 *topleft;
+extern RENDERLOCAL INT32 slicex1, slicex2; // inclusive
 
 // -------------------------
 // COLUMN DRAWING CODE STUFF
 // -------------------------
 
-extern lighttable_t *dc_colormap;
-extern INT32 dc_x, dc_yl, dc_yh;
-extern fixed_t dc_iscale, dc_texturemid;
-extern UINT8 dc_hires;
+extern RENDERLOCAL lighttable_t *dc_colormap;
+extern RENDERLOCAL INT32 dc_x, dc_yl, dc_yh;
+extern RENDERLOCAL fixed_t dc_iscale, dc_texturemid;
+extern RENDERLOCAL UINT8 dc_hires;
 
-extern UINT8 *dc_source; // first pixel in a column
+extern RENDERLOCAL UINT8 *dc_source; // first pixel in a column
 
 // translucency stuff here
 extern UINT8 *transtables; // translucency tables, should be (*transtables)[5][256][256]
-extern UINT8 *dc_transmap;
+extern RENDERLOCAL UINT8 *dc_transmap;
 
 // translation stuff here
 
-extern UINT8 *dc_translation;
+extern RENDERLOCAL UINT8 *dc_translation;
 
-extern struct r_lightlist_s *dc_lightlist;
-extern INT32 dc_numlights, dc_maxlights;
+extern RENDERLOCAL struct r_lightlist_s *dc_lightlist;
+extern RENDERLOCAL INT32 dc_numlights, dc_maxlights;
 
 //Fix TUTIFRUTI
-extern INT32 dc_texheight;
+extern RENDERLOCAL INT32 dc_texheight;
 
 // -----------------------
 // SPAN DRAWING CODE STUFF
 // -----------------------
 
-extern INT32 ds_y, ds_x1, ds_x2;
-extern lighttable_t *ds_colormap;
-extern fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
-extern UINT8 *ds_source; // start of a 64*64 tile image
-extern UINT8 *ds_transmap;
+extern RENDERLOCAL INT32 ds_y, ds_x1, ds_x2;
+extern RENDERLOCAL lighttable_t *ds_colormap;
+extern RENDERLOCAL fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+extern RENDERLOCAL UINT8 *ds_source; // start of a 64*64 tile image
+extern RENDERLOCAL UINT8 *ds_transmap;
 
 typedef struct {
 	float x, y, z;
 } floatv3_t;
 
-extern pslope_t *ds_slope; // Current slope being used
-extern floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
-extern float focallengthf, zeroheight;
+extern RENDERLOCAL pslope_t *ds_slope; // Current slope being used
+extern RENDERLOCAL floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
+extern float focallengthf;
+extern RENDERLOCAL float zeroheight;
 
 // Variable flat sizes
-extern UINT32 nflatxshift;
-extern UINT32 nflatyshift;
-extern UINT32 nflatshiftup;
-extern UINT32 nflatmask;
+extern RENDERLOCAL UINT32 nflatxshift;
+extern RENDERLOCAL UINT32 nflatyshift;
+extern RENDERLOCAL UINT32 nflatshiftup;
+extern RENDERLOCAL UINT32 nflatmask;
 
 /// \brief Top border
 #define BRDR_T 0
@@ -168,6 +170,28 @@ void R_DrawFogSpan_8(void);
 void R_DrawFogColumn_8(void);
 void R_DrawColumnShadowed_8(void);
 
+// SSE2/AVX2 drawers, picked at runtime in SCR_SetMode
+#if !defined (NOSIMD) && (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__))
+#define SIMDDRAW
+#endif
+
+#ifdef SIMDDRAW
+void R_DrawColumn_8_SSE2(void);
+void R_DrawTranslucentColumn_8_SSE2(void);
+void R_DrawSpan_8_SSE2(void);
+void R_DrawTranslucentSpan_8_SSE2(void);
+void R_DrawTiltedSpan_8_SSE2(void);
+
+void R_DrawColumn_8_AVX2(void);
+void R_DrawTranslucentColumn_8_AVX2(void);
+void R_DrawSpan_8_AVX2(void);
+void R_DrawTranslucentSpan_8_AVX2(void);
+void R_DrawTiltedSpan_8_AVX2(void);
+#endif
+
+// Runs the drawers above against the C ones and tells if they differ
+boolean R_CheckDrawers(void);
+
 // ------------------
 // 16bpp DRAWING CODE
 // ------------------
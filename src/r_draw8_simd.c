@@ -0,0 +1,401 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1998-2000 by DooM Legacy Team.
+// Copyright (C) 1999-2018 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_draw8_simd.c
+/// \brief SSE2/AVX2 versions of the busiest 8bpp drawers
+/// \note  no includes because this is included as part of r_draw.c,
+///        once for each instruction set (see SIMDISA there)
+///
+/// The texture and colormap lookups are still done one byte at a time,
+/// since gathers could read past the end of a flat. What's done in vectors
+/// is stepping through the texture and working out where each pixel reads
+/// from. These have to give exactly what the C drawers in r_draw8.c give;
+/// run with -drawercheck to compare them.
+
+#if SIMDISA == SIMD_SSE2
+#define SIMDNAME(fn) fn##_SSE2
+#define SIMDTARGET __attribute__((target("sse2")))
+#else
+#define SIMDNAME(fn) fn##_AVX2
+#define SIMDTARGET __attribute__((target("avx2")))
+#endif
+
+#define SIMDSTEP 16 // pixels worked out at once
+
+// The tilted drawer fills a whole SIMDSTEP of offsets per perspective divide
+#if SPANSIZE != SIMDSTEP
+#error "SPANSIZE in r_draw8.c must match SIMDSTEP"
+#endif
+
+// Flat offsets of the next SIMDSTEP pixels of a span,
+// ((y >> nflatyshift) & nflatmask) | (x >> nflatxshift)
+static inline SIMDTARGET void SIMDNAME(R_FlatOffsets)(UINT32 *ofs, UINT32 x, UINT32 y, UINT32 xstep, UINT32 ystep)
+{
+	INT32 i;
+#if SIMDISA == SIMD_SSE2
+	const __m128i xshift = _mm_cvtsi32_si128(nflatxshift), yshift = _mm_cvtsi32_si128(nflatyshift);
+	const __m128i mask = _mm_set1_epi32(nflatmask);
+	const __m128i xsteps = _mm_set1_epi32(4*xstep), ysteps = _mm_set1_epi32(4*ystep);
+	__m128i xv = _mm_setr_epi32(x, x + xstep, x + 2*xstep, x + 3*xstep);
+	__m128i yv = _mm_setr_epi32(y, y + ystep, y + 2*ystep, y + 3*ystep);
+
+	for (i = 0; i < SIMDSTEP; i += 4)
+	{
+		_mm_storeu_si128((__m128i *)&ofs[i],
+			_mm_or_si128(_mm_and_si128(_mm_srl_epi32(yv, yshift), mask), _mm_srl_epi32(xv, xshift)));
+		xv = _mm_add_epi32(xv, xsteps);
+		yv = _mm_add_epi32(yv, ysteps);
+	}
+#else
+	const __m128i xshift = _mm_cvtsi32_si128(nflatxshift), yshift = _mm_cvtsi32_si128(nflatyshift);
+	const __m256i mask = _mm256_set1_epi32(nflatmask);
+	const __m256i xsteps = _mm256_set1_epi32(8*xstep), ysteps = _mm256_set1_epi32(8*ystep);
+	__m256i xv = _mm256_setr_epi32(x, x + xstep, x + 2*xstep, x + 3*xstep,
+		x + 4*xstep, x + 5*xstep, x + 6*xstep, x + 7*xstep);
+	__m256i yv = _mm256_setr_epi32(y, y + ystep, y + 2*ystep, y + 3*ystep,
+		y + 4*ystep, y + 5*ystep, y + 6*ystep, y + 7*ystep);
+
+	for (i = 0; i < SIMDSTEP; i += 8)
+	{
+		_mm256_storeu_si256((__m256i *)&ofs[i],
+			_mm256_or_si256(_mm256_and_si256(_mm256_srl_epi32(yv, yshift), mask), _mm256_srl_epi32(xv, xshift)));
+		xv = _mm256_add_epi32(xv, xsteps);
+		yv = _mm256_add_epi32(yv, ysteps);
+	}
+#endif
+}
+
+// Texel rows of the next SIMDSTEP pixels of a column with a power of 2 height,
+// (frac >> FRACBITS) & heightmask
+static inline SIMDTARGET void SIMDNAME(R_ColumnOffsets)(UINT32 *ofs, fixed_t frac, fixed_t fracstep, INT32 heightmask)
+{
+	INT32 i;
+	const UINT32 f = (UINT32)frac, s = (UINT32)fracstep;
+#if SIMDISA == SIMD_SSE2
+	const __m128i mask = _mm_set1_epi32(heightmask);
+	const __m128i steps = _mm_set1_epi32(4*s);
+	__m128i fv = _mm_setr_epi32(f, f + s, f + 2*s, f + 3*s);
+
+	for (i = 0; i < SIMDSTEP; i += 4)
+	{
+		_mm_storeu_si128((__m128i *)&ofs[i], _mm_and_si128(_mm_srai_epi32(fv, FRACBITS), mask));
+		fv = _mm_add_epi32(fv, steps);
+	}
+#else
+	const __m256i mask = _mm256_set1_epi32(heightmask);
+	const __m256i steps = _mm256_set1_epi32(8*s);
+	__m256i fv = _mm256_setr_epi32(f, f + s, f + 2*s, f + 3*s, f + 4*s, f + 5*s, f + 6*s, f + 7*s);
+
+	for (i = 0; i < SIMDSTEP; i += 8)
+	{
+		_mm256_storeu_si256((__m256i *)&ofs[i], _mm256_and_si256(_mm256_srai_epi32(fv, FRACBITS), mask));
+		fv = _mm256_add_epi32(fv, steps);
+	}
+#endif
+}
+
+/**	\brief The R_DrawColumn_8 function, SIMD version
+	Only power of 2 textures are done here, the rest go to the C version.
+*/
+SIMDTARGET void SIMDNAME(R_DrawColumn_8)(void)
+{
+	INT32 count, i;
+	UINT8 *dest;
+	fixed_t frac, fracstep;
+	const UINT8 *source = dc_source;
+	const lighttable_t *colormap = dc_colormap;
+	const INT32 heightmask = dc_texheight-1;
+	const INT32 pitch = vid.width;
+	UINT32 ofs[SIMDSTEP];
+
+	if (dc_texheight & heightmask)
+	{
+		R_DrawColumn_8();
+		return;
+	}
+
+	count = dc_yh - dc_yl;
+
+	if (count < 0) // Zero length, column does not exceed a pixel.
+		return;
+
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		return;
+#endif
+
+	dest = &topleft[dc_yl*vid.width + dc_x];
+
+	count++;
+
+	fracstep = dc_iscale;
+	frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, fracstep))*(!dc_hires);
+
+	while (count >= SIMDSTEP)
+	{
+		SIMDNAME(R_ColumnOffsets)(ofs, frac, fracstep, heightmask);
+		for (i = 0; i < SIMDSTEP; i++, dest += pitch)
+			*dest = colormap[source[ofs[i]]];
+		frac = (fixed_t)((UINT32)frac + SIMDSTEP*(UINT32)fracstep);
+		count -= SIMDSTEP;
+	}
+	while (count--)
+	{
+		*dest = colormap[source[(frac>>FRACBITS) & heightmask]];
+		dest += pitch;
+		frac += fracstep;
+	}
+}
+
+/**	\brief The R_DrawTranslucentColumn_8 function, SIMD version
+	Only power of 2 textures are done here, the rest go to the C version.
+*/
+SIMDTARGET void SIMDNAME(R_DrawTranslucentColumn_8)(void)
+{
+	INT32 count, i;
+	UINT8 *dest;
+	fixed_t frac, fracstep;
+	const UINT8 *source = dc_source;
+	const UINT8 *transmap = dc_transmap;
+	const lighttable_t *colormap = dc_colormap;
+	const INT32 heightmask = dc_texheight-1;
+	const INT32 pitch = vid.width;
+	UINT32 ofs[SIMDSTEP];
+
+	if (dc_texheight & heightmask)
+	{
+		R_DrawTranslucentColumn_8();
+		return;
+	}
+
+	count = dc_yh - dc_yl + 1;
+
+	if (count <= 0) // Zero length, column does not exceed a pixel.
+		return;
+
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		I_Error("R_DrawTranslucentColumn_8: %d to %d at %d", dc_yl, dc_yh, dc_x);
+#endif
+
+	dest = &topleft[dc_yl*vid.width + dc_x];
+
+	fracstep = dc_iscale;
+	frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, fracstep))*(!dc_hires);
+
+	while (count >= SIMDSTEP)
+	{
+		SIMDNAME(R_ColumnOffsets)(ofs, frac, fracstep, heightmask);
+		for (i = 0; i < SIMDSTEP; i++, dest += pitch)
+			*dest = *(transmap + (colormap[source[ofs[i]]]<<8) + (*dest));
+		frac = (fixed_t)((UINT32)frac + SIMDSTEP*(UINT32)fracstep);
+		count -= SIMDSTEP;
+	}
+	while (count--)
+	{
+		*dest = *(transmap + (colormap[source[(frac>>FRACBITS)&heightmask]]<<8) + (*dest));
+		dest += pitch;
+		frac += fracstep;
+	}
+}
+
+/**	\brief The R_DrawSpan_8 function, SIMD version
+*/
+SIMDTARGET void SIMDNAME(R_DrawSpan_8)(void)
+{
+	UINT32 xposition, yposition;
+	UINT32 xstep, ystep;
+	const UINT8 *source = ds_source;
+	const UINT8 *colormap = ds_colormap;
+	UINT8 *dest;
+	const UINT8 *deststop = screens[0] + vid.rowbytes * vid.height;
+	size_t count;
+	UINT32 ofs[SIMDSTEP];
+	INT32 i;
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (dest+8 > deststop)
+		return;
+
+	while (count >= SIMDSTEP)
+	{
+		SIMDNAME(R_FlatOffsets)(ofs, xposition, yposition, xstep, ystep);
+		for (i = 0; i < SIMDSTEP; i++)
+			dest[i] = colormap[source[ofs[i]]];
+		xposition += SIMDSTEP*xstep;
+		yposition += SIMDSTEP*ystep;
+		dest += SIMDSTEP;
+		count -= SIMDSTEP;
+	}
+	while (count-- && dest <= deststop)
+	{
+		*dest++ = colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]];
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+/**	\brief The R_DrawTranslucentSpan_8 function, SIMD version
+*/
+SIMDTARGET void SIMDNAME(R_DrawTranslucentSpan_8)(void)
+{
+	UINT32 xposition, yposition;
+	UINT32 xstep, ystep;
+	const UINT8 *source = ds_source;
+	const UINT8 *colormap = ds_colormap;
+	const UINT8 *transmap = ds_transmap;
+	UINT8 *dest;
+	size_t count;
+	UINT32 ofs[SIMDSTEP];
+	INT32 i;
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	while (count >= SIMDSTEP)
+	{
+		SIMDNAME(R_FlatOffsets)(ofs, xposition, yposition, xstep, ystep);
+		for (i = 0; i < SIMDSTEP; i++)
+			dest[i] = *(transmap + (colormap[source[ofs[i]]] << 8) + dest[i]);
+		xposition += SIMDSTEP*xstep;
+		yposition += SIMDSTEP*ystep;
+		dest += SIMDSTEP;
+		count -= SIMDSTEP;
+	}
+	while (count--)
+	{
+		*dest = *(transmap + (colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]] << 8) + *dest);
+		dest++;
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+/**	\brief The R_DrawTiltedSpan_8 function, SIMD version
+	The perspective divide still happens every 16 pixels, same as the C version.
+*/
+SIMDTARGET void SIMDNAME(R_DrawTiltedSpan_8)(void)
+{
+	// x1, x2 = ds_x1, ds_x2
+	int width = ds_x2 - ds_x1;
+	double iz, uz, vz;
+	UINT32 u, v;
+	int i;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+
+	double startz, startu, startv;
+	double izstep, uzstep, vzstep;
+	double endz, endu, endv;
+	UINT32 stepu, stepv;
+	UINT32 ofs[SIMDSTEP];
+
+	iz = ds_sz.z + ds_sz.y*(centery-ds_y) + ds_sz.x*(ds_x1-centerx);
+
+	// Lighting is simple. It's just linear interpolation from start to end
+	{
+		float planelightfloat = BASEVIDWIDTH*BASEVIDWIDTH/vid.width / (zeroheight - FIXED_TO_FLOAT(viewz)) / 21.0f;
+		float lightstart, lightend;
+
+		lightend = (iz + ds_sz.x*width) * planelightfloat;
+		lightstart = iz * planelightfloat;
+
+		R_CalcTiltedLighting(FLOAT_TO_FIXED(lightstart), FLOAT_TO_FIXED(lightend));
+	}
+
+	uz = ds_su.z + ds_su.y*(centery-ds_y) + ds_su.x*(ds_x1-centerx);
+	vz = ds_sv.z + ds_sv.y*(centery-ds_y) + ds_sv.x*(ds_x1-centerx);
+
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	source = ds_source;
+
+	startz = 1.f/iz;
+	startu = uz*startz;
+	startv = vz*startz;
+
+	izstep = ds_sz.x * SPANSIZE;
+	uzstep = ds_su.x * SPANSIZE;
+	vzstep = ds_sv.x * SPANSIZE;
+	width++;
+
+	while (width >= SPANSIZE)
+	{
+		iz += izstep;
+		uz += uzstep;
+		vz += vzstep;
+
+		endz = 1.f/iz;
+		endu = uz*endz;
+		endv = vz*endz;
+		stepu = (INT64)((endu - startu) * INVSPAN);
+		stepv = (INT64)((endv - startv) * INVSPAN);
+		u = (INT64)(startu) + viewx;
+		v = (INT64)(startv) + viewy;
+
+		SIMDNAME(R_FlatOffsets)(ofs, u, v, stepu, stepv);
+		for (i = 0; i < SPANSIZE; i++)
+		{
+			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
+			dest[i] = colormap[source[ofs[i]]];
+		}
+		dest += SPANSIZE;
+		startu = endu;
+		startv = endv;
+		width -= SPANSIZE;
+	}
+	if (width > 0)
+	{
+		if (width == 1)
+		{
+			u = (INT64)(startu);
+			v = (INT64)(startv);
+			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
+			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
+		}
+		else
+		{
+			double left = width;
+			iz += ds_sz.x * left;
+			uz += ds_su.x * left;
+			vz += ds_sv.x * left;
+
+			endz = 1.f/iz;
+			endu = uz*endz;
+			endv = vz*endz;
+			left = 1.f/left;
+			stepu = (INT64)((endu - startu) * left);
+			stepv = (INT64)((endv - startv) * left);
+			u = (INT64)(startu) + viewx;
+			v = (INT64)(startv) + viewy;
+
+			for (; width != 0; width--)
+			{
+				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
+				*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
+				dest++;
+				u += stepu;
+				v += stepv;
+			}
+		}
+	}
+}
+
+#undef SIMDSTEP
+#undef SIMDTARGET
+#undef SIMDNAME
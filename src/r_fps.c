@@ -75,12 +75,12 @@ static viewvars_t pview_new[MAXSPLITSCREENPLAYERS];
 static viewvars_t skyview_old[MAXSPLITSCREENPLAYERS];
 static viewvars_t skyview_new[MAXSPLITSCREENPLAYERS];
 
-static viewvars_t *oldview = &pview_old[0];
+static RENDERLOCAL viewvars_t *oldview = &pview_old[0];
 static int oldview_invalid[MAXSPLITSCREENPLAYERS] = {0, 0, 0, 0};
-viewvars_t *newview = &pview_new[0];
+RENDERLOCAL viewvars_t *newview = &pview_new[0];
 
 
-enum viewcontext_e viewcontext = VIEWCONTEXT_PLAYER1;
+RENDERLOCAL enum viewcontext_e viewcontext = VIEWCONTEXT_PLAYER1;
 
 static levelinterpolator_t **levelinterpolators;
 static size_t levelinterpolators_len;
@@ -308,29 +308,6 @@ void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
 	}
 }
 
-void R_InterpolatePrecipMobjState(precipmobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
-{
-	if (frac == FRACUNIT)
-	{
-		out->x = mobj->x;
-		out->y = mobj->y;
-		out->z = mobj->z;
-		out->scale = FRACUNIT;
-		out->subsector = mobj->subsector;
-		out->angle = mobj->angle;
-		return;
-	}
-
-	out->x = R_LerpFixed(mobj->old_x, mobj->x, frac);
-	out->y = R_LerpFixed(mobj->old_y, mobj->y, frac);
-	out->z = R_LerpFixed(mobj->old_z, mobj->z, frac);
-	out->scale = FRACUNIT;
-
-	out->subsector = R_PointInSubsector(out->x, out->y);
-
-	out->angle = R_LerpAngle(mobj->old_angle, mobj->angle, frac);
-}
-
 static void AddInterpolator(levelinterpolator_t* interpolator)
 {
 	if (levelinterpolators_len >= levelinterpolators_size)
@@ -548,7 +525,7 @@ void R_ApplyLevelInterpolators(fixed_t frac)
 			{
 				interp->sectorplane.sector->floorheight = R_LerpFixed(interp->sectorplane.oldheight, interp->sectorplane.bakheight, frac);
 			}
-			interp->sectorplane.sector->moved = true;
+			P_FlagSectorMoved(interp->sectorplane.sector);
 			break;
 		case LVLINTERP_SectorScroll:
 			if (interp->sectorscroll.ceiling)
@@ -603,7 +580,7 @@ void R_RestoreLevelInterpolators(void)
 			{
 				interp->sectorplane.sector->floorheight = interp->sectorplane.bakheight;
 			}
-			interp->sectorplane.sector->moved = true;
+			P_FlagSectorMoved(interp->sectorplane.sector);
 			break;
 		case LVLINTERP_SectorScroll:
 			if (interp->sectorscroll.ceiling)
@@ -759,20 +736,3 @@ void R_ResetMobjInterpolationState(mobj_t *mobj)
 
 	mobj->resetinterp = false;
 }
-
-//
-// P_ResetPrecipitationMobjInterpolationState
-//
-// Reset the rendering interpolation state of the precipmobj.
-//
-void R_ResetPrecipitationMobjInterpolationState(precipmobj_t *mobj)
-{
-	mobj->old_x2 = mobj->old_x;
-	mobj->old_y2 = mobj->old_y;
-	mobj->old_z2 = mobj->old_z;
-	mobj->old_angle2 = mobj->old_angle;
-	mobj->old_x = mobj->x;
-	mobj->old_y = mobj->y;
-	mobj->old_z = mobj->z;
-	mobj->old_angle = mobj->angle;
-}
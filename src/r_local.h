@@ -34,7 +34,7 @@
 #include "r_things.h"
 #include "r_draw.h"
 
-extern drawseg_t *firstseg;
+extern RENDERLOCAL drawseg_t *firstseg;
 
 void SplitScreen_OnChange(void);
 
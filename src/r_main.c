@@ -32,6 +32,8 @@
 #include "m_random.h" // quake camera shake
 #include "doomstat.h" // MAXSPLITSCREENPLAYERS
 #include "r_fps.h" // Frame interpolation/uncapped
+#include "i_system.h" // I_AddExitFunc
+#include "i_threads.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -51,11 +53,13 @@ INT64 mytotal = 0;
 #define FIELDOFVIEW 2048
 
 // increment every time a check is made
-size_t validcount = 1;
+RENDERLOCAL size_t validcount = 1;
 
-INT32 centerx, centery;
+INT32 centerx;
+RENDERLOCAL INT32 centery;
 
-fixed_t centerxfrac, centeryfrac;
+fixed_t centerxfrac;
+RENDERLOCAL fixed_t centeryfrac;
 fixed_t projection;
 fixed_t projectiony; // aspect ratio
 fixed_t fovtan; // field of view
@@ -65,19 +69,19 @@ size_t framecount;
 
 size_t loopcount;
 
-fixed_t viewx, viewy, viewz;
-angle_t viewangle, aimingangle;
-UINT8 viewssnum;
-fixed_t viewcos, viewsin;
-boolean skyVisible;
+RENDERLOCAL fixed_t viewx, viewy, viewz;
+RENDERLOCAL angle_t viewangle, aimingangle;
+RENDERLOCAL UINT8 viewssnum;
+RENDERLOCAL fixed_t viewcos, viewsin;
+RENDERLOCAL boolean skyVisible;
 boolean skyVisiblePerPlayer[MAXSPLITSCREENPLAYERS]; // saved values of skyVisible for each splitscreen player
-sector_t *viewsector;
-player_t *viewplayer;
+RENDERLOCAL sector_t *viewsector;
+RENDERLOCAL player_t *viewplayer;
 
 // PORTALS!
 // You can thank and/or curse JTE for these.
-UINT8 portalrender;
-sector_t *portalcullsector;
+RENDERLOCAL UINT8 portalrender;
+RENDERLOCAL sector_t *portalcullsector;
 typedef struct portal_pair
 {
 	INT32 line1;
@@ -96,14 +100,45 @@ typedef struct portal_pair
 	INT16 *floorclip;
 	fixed_t *frontscale;
 } portal_pair;
-portal_pair *portal_base, *portal_cap;
-line_t *portalclipline;
-INT32 portalclipstart, portalclipend;
+RENDERLOCAL portal_pair *portal_base, *portal_cap;
+RENDERLOCAL line_t *portalclipline;
+RENDERLOCAL INT32 portalclipstart, portalclipend;
 
 fixed_t rendertimefrac;
 fixed_t renderdeltatics;
 boolean renderisnewtic;
 
+#ifdef PARALLELVIEWS
+#define MAXRENDERTHREADS 16
+#define MINSLICEWIDTH 64 // narrower slices aren't worth a thread
+
+boolean renderthreads;
+boolean renderslices;
+
+static I_mutex sharedmutex; // R_LockShared
+static RENDERLOCAL boolean renderworker; // this thread is one of R_RenderWorker's
+
+static void R_StartSlices(void);
+
+//
+// R_LockShared
+// Held around filling anything the splitscreen views or slices share
+// (texture, skin and translation caches), but only while
+// they're being drawn at the same time.
+//
+void R_LockShared(void)
+{
+	if (renderthreads)
+		I_lock_mutex(&sharedmutex);
+}
+
+void R_UnlockShared(void)
+{
+	if (renderthreads)
+		I_unlock_mutex(sharedmutex);
+}
+#endif
+
 //
 // precalculated math tables
 //
@@ -195,6 +230,12 @@ consvar_t cv_homremoval = {"homremoval", "Yes", CV_SAVE, homremoval_cons_t, NULL
 
 consvar_t cv_maxportals = {"maxportals", "2", CV_SAVE, maxportals_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
+#ifdef PARALLELVIEWS
+consvar_t cv_parallelviews = {"parallelviews", "On", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+static CV_PossibleValue_t renderthreads_cons_t[] = {{1, "MIN"}, {MAXRENDERTHREADS, "MAX"}, {0, NULL}};
+consvar_t cv_renderthreads = {"r_threads", "1", CV_SAVE, renderthreads_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#endif
+
 void SplitScreen_OnChange(void)
 {
 	UINT8 i;
@@ -675,6 +716,7 @@ void R_ExecuteSetViewSize(void)
 
 	// setup sky scaling
 	R_SetSkyScale();
+	R_ClearSkyCache();
 
 	// planes
 	if (rendermode == render_soft)
@@ -796,7 +838,7 @@ subsector_t *R_IsPointInSubsector(fixed_t x, fixed_t y)
 // R_SetupFrame
 //
 
-static mobj_t *viewmobj;
+static RENDERLOCAL mobj_t *viewmobj;
 
 void R_SkyboxFrame(player_t *player)
 {
@@ -1092,7 +1134,9 @@ void R_SetupFrame(player_t *player, boolean skybox)
 
 	if (chasecam && !thiscam->chase)
 	{
+		R_LockShared(); // plays with the blockmap
 		P_ResetCamera(player, thiscam);
+		R_UnlockShared();
 		thiscam->chase = true;
 	}
 	else if (!chasecam)
@@ -1303,12 +1347,8 @@ void R_AddPortal(INT32 line1, INT32 line2, INT32 x1, INT32 x2)
 // I mean, there is a win16lock() or something that lasts all the rendering,
 // so maybe we should release screen lock before each netupdate below..?
 
-void R_RenderPlayerView(player_t *player)
+static void R_DrawViewBackground(player_t *player)
 {
-	portal_pair *portal;
-	const boolean skybox = (skyboxmo[0] && cv_skybox.value);
-	UINT8 i;
-
 	// if this is display player 1
 	if (cv_homremoval.value && player == &players[displayplayers[0]])
 	{
@@ -1335,6 +1375,29 @@ void R_RenderPlayerView(player_t *player)
 #else
 	V_DrawFill(viewwidth, viewheight, viewwidth, viewheight, 31|V_NOSCALESTART);
 #endif
+}
+
+static void R_DrawViewContents(void);
+
+void R_RenderPlayerView(player_t *player)
+{
+	portal_pair *portal;
+	const boolean skybox = (skyboxmo[0] && cv_skybox.value);
+	UINT8 i;
+
+#ifdef PARALLELVIEWS
+	if (!renderthreads) // otherwise R_RenderViewsParallel did it already
+#endif
+	R_DrawViewBackground(player);
+
+	slicex1 = 0;
+	slicex2 = viewwidth - 1;
+#ifdef PARALLELVIEWS
+	if (!splitscreen)
+		R_StartSlices();
+#endif
+
+	memset(&planestats, 0, sizeof (planestats));
 
 	// load previous saved value of skyVisible for the player
 	for (i = 0; i <= splitscreen; i++)
@@ -1348,6 +1411,7 @@ void R_RenderPlayerView(player_t *player)
 
 	portalrender = 0;
 	portal_base = portal_cap = NULL;
+	R_StartSkyCacheFrame();
 
 	if (skybox && skyVisible)
 	{
@@ -1363,15 +1427,14 @@ void R_RenderPlayerView(player_t *player)
 
 		R_RenderBSPNode((INT32)numnodes - 1);
 		R_ClipSprites();
-		R_DrawPlanes();
-#ifdef FLOORSPLATS
-		R_DrawVisibleFloorSplats();
-#endif
-		R_DrawMasked();
+		R_DrawViewContents();
 	}
 
 	R_SetupFrame(player, skybox);
 	skyVisible = false;
+#ifdef PARALLELVIEWS
+	if (!renderworker) // R_RenderViewsParallel counts those
+#endif
 	framecount++;
 	validcount++;
 
@@ -1385,6 +1448,9 @@ void R_RenderPlayerView(player_t *player)
 #endif
 
 	// check for new console commands.
+#ifdef PARALLELVIEWS
+	if (!renderthreads)
+#endif
 	NetUpdate();
 
 	// The head node is the last node output.
@@ -1434,15 +1500,12 @@ void R_RenderPlayerView(player_t *player)
 	}
 	// END PORTAL RENDERING
 
-	R_DrawPlanes();
-#ifdef FLOORSPLATS
-	R_DrawVisibleFloorSplats();
-#endif
-	// draw mid texture and sprite
-	// And now 3D floors/sides!
-	R_DrawMasked();
+	R_DrawViewContents();
 
 	// Check for new console commands.
+#ifdef PARALLELVIEWS
+	if (!renderthreads)
+#endif
 	NetUpdate();
 
 	// save value to skyVisiblePerPlayer
@@ -1455,6 +1518,438 @@ void R_RenderPlayerView(player_t *player)
 			break;
 		}
 	}
+
+#ifdef PARALLELVIEWS
+	if (renderslices) // only ever set with a single view
+		renderslices = false;
+#endif
+}
+
+#ifdef PARALLELVIEWS
+// =========================================================================
+//                    PARALLEL SPLITSCREEN VIEWS AND SLICES
+// =========================================================================
+
+// Views 2-4 each get a thread of their own, kept around for the whole
+// session since their thread-local buffers (visplanes, openings, drawsegs)
+// are grown as needed and never handed back. View 1 is drawn by the
+// main thread like always.
+//
+// With a single view, the same threads draw it in vertical slices instead:
+// the main thread walks the BSP on its own, then every thread rasterizes
+// the walls, planes and masked stuff it found, clipped to its own columns.
+
+typedef struct renderjob_s renderjob_t;
+
+struct renderjob_s
+{
+	void (*draw)(renderjob_t *job); // NULL when there's nothing to do
+
+	// R_RenderViewJob
+	player_t *player;
+	INT32 windowx, windowy;
+	UINT8 **lookup; // ylookup for the window
+	UINT16 objectsdrawn; // for the HUD, once done
+
+	// R_RenderSliceJob
+	INT32 x1, x2;
+	boolean skyvisible;
+};
+
+static renderjob_t renderjobs[MAXRENDERTHREADS];
+static boolean renderspawned[MAXRENDERTHREADS];
+static UINT8 numrenderthreads, renderjobsleft;
+static boolean renderquit;
+
+static I_mutex renderjobmutex;
+static I_cond renderjobcond;
+
+static void R_RenderViewJob(renderjob_t *job)
+{
+	viewwindowx = job->windowx;
+	viewwindowy = job->windowy;
+	topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
+	M_Memcpy(ylookup, job->lookup, viewheight*sizeof (ylookup[0]));
+
+	viewssnum = (UINT8)(job - renderjobs);
+	colfunc = basecolfunc;
+	spanfunc = basespanfunc;
+	objectsdrawn = 0;
+
+	R_RenderPlayerView(job->player);
+
+	job->objectsdrawn = objectsdrawn;
+}
+
+// The main thread's view, as R_SetupFrame left it, for the slices
+static struct
+{
+	fixed_t x, y, z;
+	angle_t angle, aiming;
+	fixed_t sin, cos;
+	sector_t *sector;
+	player_t *player;
+	viewvars_t *vars;
+	UINT8 ssnum;
+	INT32 centery;
+	fixed_t centeryfrac;
+	INT32 windowx, windowy;
+	UINT8 *topleft;
+	UINT8 **lookup;
+} sliceview;
+
+static void (*slicestage)(void); // what every slice draws right now
+static UINT8 numslices;
+
+static void R_RenderSliceJob(renderjob_t *job)
+{
+	viewx = sliceview.x;
+	viewy = sliceview.y;
+	viewz = sliceview.z;
+	viewangle = sliceview.angle;
+	aimingangle = sliceview.aiming;
+	viewsin = sliceview.sin;
+	viewcos = sliceview.cos;
+	viewsector = sliceview.sector;
+	viewplayer = sliceview.player;
+	newview = sliceview.vars;
+	viewssnum = sliceview.ssnum;
+	centery = sliceview.centery;
+	centeryfrac = sliceview.centeryfrac;
+	viewwindowx = sliceview.windowx;
+	viewwindowy = sliceview.windowy;
+	topleft = sliceview.topleft;
+	M_Memcpy(ylookup, sliceview.lookup, viewheight*sizeof (ylookup[0]));
+	R_LoadSlicePlanes();
+
+	colfunc = basecolfunc;
+	spanfunc = basespanfunc;
+	skyVisible = false;
+
+	slicex1 = job->x1;
+	slicex2 = job->x2;
+	slicestage();
+
+	job->skyvisible = skyVisible;
+}
+
+static void R_RenderWorker(void *userdata)
+{
+	renderjob_t *job = userdata;
+	const UINT8 view = (UINT8)(job - renderjobs);
+
+	renderworker = true;
+	R_InitDrawNodes();
+
+	// Keep clear of the stamps the main thread leaves in spritevalidcount
+	// when this view is drawn there instead.
+	if (view < MAXSPLITSCREENPLAYERS)
+		validcount = (size_t)view << (sizeof (size_t)*8 - 2);
+
+	for (;;)
+	{
+		I_lock_mutex(&renderjobmutex);
+		while (!job->draw && !renderquit)
+			I_hold_cond(&renderjobcond, renderjobmutex);
+		I_unlock_mutex(renderjobmutex);
+
+		if (renderquit)
+			break;
+
+		job->draw(job);
+
+		I_lock_mutex(&renderjobmutex);
+		job->draw = NULL;
+		renderjobsleft--;
+		I_wake_all_cond(&renderjobcond);
+		I_unlock_mutex(renderjobmutex);
+	}
+
+	// One at a time, the zone isn't being locked anymore.
+	I_lock_mutex(&renderjobmutex);
+	R_FreeVisSpriteChunks();
+	numrenderthreads--;
+	I_wake_all_cond(&renderjobcond);
+	I_unlock_mutex(renderjobmutex);
+}
+
+static void R_StopRenderThreads(void)
+{
+	if (renderworker) // I_Error from a view, nobody's left to wait for us
+		return;
+
+	I_lock_mutex(&renderjobmutex);
+	renderquit = true;
+	I_wake_all_cond(&renderjobcond);
+	while (numrenderthreads)
+		I_hold_cond(&renderjobcond, renderjobmutex);
+	I_unlock_mutex(renderjobmutex);
+}
+
+// Starts up a job's thread if it isn't running yet.
+// Call with renderjobmutex held. Returns false if it couldn't be started.
+static boolean R_SpawnRenderThread(UINT8 i)
+{
+	if (renderspawned[i])
+		return true;
+
+	if (!I_spawn_thread("view-render", R_RenderWorker, &renderjobs[i]))
+		return false;
+
+	if (!numrenderthreads)
+		I_AddExitFunc(R_StopRenderThreads);
+	renderspawned[i] = true;
+	numrenderthreads++;
+	return true;
+}
+
+// Hands a job to its thread, which R_SpawnRenderThread has to have started.
+// Call with renderjobmutex held.
+static void R_StartRenderJob(UINT8 i, void (*draw)(renderjob_t *))
+{
+	renderjobs[i].draw = draw;
+	renderjobsleft++;
+}
+
+static void R_WaitRenderJobs(void)
+{
+	I_lock_mutex(&renderjobmutex);
+	while (renderjobsleft)
+		I_hold_cond(&renderjobcond, renderjobmutex);
+	I_unlock_mutex(renderjobmutex);
+}
+
+//
+// R_RenderViewsParallel
+// Software mode splitscreen: draws every view at the same time,
+// same as calling R_RenderPlayerView for each in turn.
+//
+void R_RenderViewsParallel(void)
+{
+	renderjob_t *job;
+	thinker_t *th;
+	UINT8 i, last = 0, numjobs = 0;
+	UINT8 unthreaded[MAXSPLITSCREENPLAYERS], numunthreaded = 0;
+	UINT16 drawn;
+
+	// Anything that can't be split up between the views goes first.
+	R_PrepMoved3DFloors();
+	P_ForEachThinker(th, THINK_MOBJ)
+	{
+		if (th->function.acp1 == (actionf_p1)P_MobjThinker && ((mobj_t *)th)->skin)
+			R_LoadSkinSprites(((mobj_t *)th)->skin);
+	}
+	for (i = 0; i <= splitscreen; i++)
+	{
+		if (players[displayplayers[i]].mo || players[displayplayers[i]].playerstate == PST_DEAD)
+			R_DrawViewBackground(&players[displayplayers[i]]);
+	}
+
+	renderthreads = true;
+
+	I_lock_mutex(&renderjobmutex);
+	for (i = 1; i <= splitscreen; i++)
+	{
+		if (!(players[displayplayers[i]].mo || players[displayplayers[i]].playerstate == PST_DEAD))
+			continue;
+
+		job = &renderjobs[i];
+		switch (i)
+		{
+			case 1:
+				if (splitscreen > 1)
+				{
+					job->windowx = viewwidth;
+					job->windowy = 0;
+				}
+				else
+				{
+					job->windowx = 0;
+					job->windowy = viewheight;
+				}
+				job->lookup = ylookup2;
+				break;
+			case 2:
+				job->windowx = 0;
+				job->windowy = viewheight;
+				job->lookup = ylookup3;
+				break;
+			default:
+				job->windowx = viewwidth;
+				job->windowy = viewheight;
+				job->lookup = ylookup4;
+				break;
+		}
+		job->player = &players[displayplayers[i]];
+		last = i;
+
+		if (!R_SpawnRenderThread(i))
+		{
+			unthreaded[numunthreaded++] = i; // drawn here after our own
+			continue;
+		}
+		R_StartRenderJob(i, R_RenderViewJob);
+		numjobs++;
+	}
+	I_wake_all_cond(&renderjobcond);
+	I_unlock_mutex(renderjobmutex);
+
+	viewwindowx = viewwindowy = 0;
+	topleft = screens[0];
+	objectsdrawn = 0;
+	if (players[displayplayers[0]].mo || players[displayplayers[0]].playerstate == PST_DEAD)
+	{
+		viewssnum = 0;
+		R_RenderPlayerView(&players[displayplayers[0]]);
+	}
+
+	// Views with no thread to draw them, one after another like D_Display.
+	if (numunthreaded)
+	{
+		drawn = objectsdrawn;
+		for (i = 0; i < numunthreaded; i++)
+			R_RenderViewJob(&renderjobs[unthreaded[i]]);
+		objectsdrawn = drawn;
+		M_Memcpy(ylookup, ylookup1, viewheight*sizeof (ylookup[0]));
+	}
+
+	R_WaitRenderJobs();
+
+	renderthreads = false;
+
+	// Leave things the way the serial loop in D_Display would have.
+	for (i = 1; i <= last; i++)
+	{
+		objectsdrawn = (UINT16)(objectsdrawn + renderjobs[i].objectsdrawn);
+		renderjobs[i].objectsdrawn = 0;
+	}
+	framecount += numjobs;
+	if (last)
+	{
+		viewssnum = last;
+		viewwindowx = renderjobs[last].windowx;
+		viewwindowy = renderjobs[last].windowy;
+		topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
+	}
+
+	NetUpdate();
+}
+
+//
+// R_StartSlices
+// Decides whether the single view about to be drawn is split up.
+//
+static void R_StartSlices(void)
+{
+	INT32 n = cv_renderthreads.value;
+	UINT8 i;
+
+	if (n > viewwidth / MINSLICEWIDTH)
+		n = viewwidth / MINSLICEWIDTH;
+	numslices = (UINT8)max(n, 1);
+
+	// No more slices than there are threads to draw them.
+	I_lock_mutex(&renderjobmutex);
+	for (i = 1; i < numslices; i++)
+		if (!R_SpawnRenderThread(i))
+			break;
+	I_unlock_mutex(renderjobmutex);
+
+	numslices = i;
+	renderslices = (numslices > 1);
+}
+
+//
+// R_DrawSlices
+// Runs a stage of the view on every slice at once,
+// the main thread drawing the leftmost one.
+//
+static void R_DrawSlices(void (*stage)(void))
+{
+	renderjob_t *job;
+	UINT8 i;
+
+	sliceview.x = viewx;
+	sliceview.y = viewy;
+	sliceview.z = viewz;
+	sliceview.angle = viewangle;
+	sliceview.aiming = aimingangle;
+	sliceview.sin = viewsin;
+	sliceview.cos = viewcos;
+	sliceview.sector = viewsector;
+	sliceview.player = viewplayer;
+	sliceview.vars = newview;
+	sliceview.ssnum = viewssnum;
+	sliceview.centery = centery;
+	sliceview.centeryfrac = centeryfrac;
+	sliceview.windowx = viewwindowx;
+	sliceview.windowy = viewwindowy;
+	sliceview.topleft = topleft;
+	sliceview.lookup = ylookup;
+	R_ShareSlicePlanes();
+	slicestage = stage;
+
+	renderthreads = true;
+
+	I_lock_mutex(&renderjobmutex);
+	for (i = 1; i < numslices; i++)
+	{
+		job = &renderjobs[i];
+		job->x1 = viewwidth*i/numslices;
+		job->x2 = viewwidth*(i+1)/numslices - 1;
+		R_StartRenderJob(i, R_RenderSliceJob);
+	}
+	I_wake_all_cond(&renderjobcond);
+	I_unlock_mutex(renderjobmutex);
+
+	slicex1 = 0;
+	slicex2 = viewwidth/numslices - 1;
+	stage();
+
+	R_WaitRenderJobs();
+
+	renderthreads = false;
+
+	slicex2 = viewwidth - 1;
+	for (i = 1; i < numslices; i++)
+		skyVisible |= renderjobs[i].skyvisible;
+}
+
+static void R_DrawSliceWallsAndPlanes(void)
+{
+	R_DrawDeferredWalls();
+	R_DrawPlanes();
+}
+#endif
+
+//
+// R_DrawViewContents
+// Everything R_RenderBSPNode found, for the view or its skybox.
+//
+static void R_DrawViewContents(void)
+{
+#ifdef PARALLELVIEWS
+	if (renderslices)
+	{
+		R_DrawSlices(R_DrawSliceWallsAndPlanes);
+		R_ClearDeferredWalls();
+#ifdef FLOORSPLATS
+		R_DrawVisibleFloorSplats();
+#endif
+		R_CreateSliceNodes();
+		R_DrawSlices(R_DrawSliceNodes);
+		R_ClearSliceNodes();
+		return;
+	}
+#endif
+
+	R_DrawPlanes();
+#ifdef FLOORSPLATS
+	R_DrawVisibleFloorSplats();
+#endif
+	// draw mid texture and sprite
+	// And now 3D floors/sides!
+	R_DrawMasked();
 }
 
 // =========================================================================
@@ -1524,6 +2019,11 @@ void R_RegisterEngineStuff(void)
 	CV_RegisterVar(&cv_translucenthud);
 
 	CV_RegisterVar(&cv_maxportals);
+	CV_RegisterVar(&cv_texturebudget);
+#ifdef PARALLELVIEWS
+	CV_RegisterVar(&cv_parallelviews);
+	CV_RegisterVar(&cv_renderthreads);
+#endif
 
 	// Default viewheight is changeable,
 	// initialized to standard viewheight
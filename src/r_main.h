@@ -20,14 +20,17 @@
 //
 // POV related.
 //
-extern fixed_t viewcos, viewsin;
+extern RENDERLOCAL fixed_t viewcos, viewsin;
 extern INT32 viewheight;
-extern INT32 centerx, centery;
+extern INT32 centerx;
+extern RENDERLOCAL INT32 centery;
 
-extern fixed_t centerxfrac, centeryfrac;
+extern fixed_t centerxfrac;
+extern RENDERLOCAL fixed_t centeryfrac;
 extern fixed_t projection, projectiony;
 
-extern size_t validcount, linecount, loopcount, framecount;
+extern RENDERLOCAL size_t validcount;
+extern size_t linecount, loopcount, framecount;
 
 // The fraction of a tic being drawn (for interpolation between two tics)
 extern fixed_t rendertimefrac;
@@ -89,6 +92,9 @@ extern consvar_t /*cv_precipdensity,*/ cv_drawdist, /*cv_drawdist_nights,*/ cv_d
 extern consvar_t cv_fov;
 extern consvar_t cv_skybox;
 extern consvar_t cv_tailspickup;
+#ifdef PARALLELVIEWS
+extern consvar_t cv_parallelviews, cv_renderthreads;
+#endif
 
 // Called by startup code.
 void R_Init(void);
@@ -106,6 +112,18 @@ void R_SetupFrame(player_t *player, boolean skybox);
 // Called by G_Drawer.
 void R_RenderPlayerView(player_t *player);
 
+#ifdef PARALLELVIEWS
+// Every splitscreen view at once, one thread each
+void R_RenderViewsParallel(void);
+
+// Around writes to anything the views share while that's going on
+void R_LockShared(void);
+void R_UnlockShared(void);
+#else
+#define R_LockShared() (void)0
+#define R_UnlockShared() (void)0
+#endif
+
 // add commands related to engine, at game startup
 void R_RegisterEngineStuff(void);
 #endif
@@ -47,49 +47,76 @@
 //#define SHITPLANESPARENCY
 
 //SoM: 3/23/2000: Use Boom visplane hashing.
-#define VISPLANEHASHBITS 9
+#define VISPLANEHASHBITS 10
 #define VISPLANEHASHMASK ((1<<VISPLANEHASHBITS)-1)
 // the last visplane list is outside of the hash table and is used for fof planes
 #define MAXVISPLANES ((1<<VISPLANEHASHBITS)+1)
 
-static visplane_t *visplanes[MAXVISPLANES];
-static visplane_t *freetail;
-static visplane_t **freehead = &freetail;
+static RENDERLOCAL visplane_t *visplanes[MAXVISPLANES];
 
-visplane_t *floorplane;
-visplane_t *ceilingplane;
-static visplane_t *currentplane;
+// Visplanes are handed out in order from a pool that only ever grows,
+// VISPLANECHUNK at a time, and is taken back whole by R_ClearPlanes.
+#define VISPLANECHUNK 32
+static RENDERLOCAL visplane_t **planechunks;
+static RENDERLOCAL size_t numplanechunks;
+static RENDERLOCAL size_t numpoolplanes; // in use since R_ClearPlanes
 
-visffloor_t ffloor[MAXFFLOORS];
-INT32 numffloors;
+RENDERLOCAL planestats_t planestats;
 
-//SoM: 3/23/2000: Boom visplane hashing routine.
-#define visplane_hash(picnum,lightlevel,height) \
-  ((unsigned)((picnum)*3+(lightlevel)+(height)*7) & VISPLANEHASHMASK)
+RENDERLOCAL visplane_t *floorplane;
+RENDERLOCAL visplane_t *ceilingplane;
+static RENDERLOCAL visplane_t *currentplane;
+
+RENDERLOCAL visffloor_t ffloor[MAXFFLOORS];
+RENDERLOCAL INT32 numffloors;
+
+// Mixes in everything R_FindPlane tells planes apart by that's likely to
+// differ between them. Heights are whole units more often than not, so
+// the high half gets folded back down at the end.
+#define PLANEHASHMIX(h, v) ((h) = ((h) ^ (UINT32)(v)) * 16777619u)
+
+static inline unsigned R_PlaneHash(fixed_t height, INT32 picnum, INT32 lightlevel,
+	fixed_t xoff, fixed_t yoff, pslope_t *slope, polyobj_t *polyobj)
+{
+	UINT32 h = 2166136261u;
+
+	PLANEHASHMIX(h, height);
+	PLANEHASHMIX(h, picnum);
+	PLANEHASHMIX(h, lightlevel);
+	PLANEHASHMIX(h, xoff);
+	PLANEHASHMIX(h, yoff);
+	PLANEHASHMIX(h, (size_t)slope);
+	PLANEHASHMIX(h, (size_t)polyobj);
+	h ^= h >> 16;
+
+	return h & VISPLANEHASHMASK;
+}
+
+#undef PLANEHASHMIX
 
 //SoM: 3/23/2000: Use boom opening limit removal
-size_t maxopenings;
-INT16 *openings, *lastopening; /// \todo free leak
+RENDERLOCAL size_t maxopenings;
+RENDERLOCAL INT16 *openings, *lastopening; /// \todo free leak
 
 //
 // Clip values are the solid pixel bounding the range.
 //  floorclip starts out SCREENHEIGHT
 //  ceilingclip starts out -1
 //
-INT16 floorclip[MAXVIDWIDTH], ceilingclip[MAXVIDWIDTH];
-fixed_t frontscale[MAXVIDWIDTH];
+RENDERLOCAL INT16 floorclip[MAXVIDWIDTH], ceilingclip[MAXVIDWIDTH];
+RENDERLOCAL fixed_t frontscale[MAXVIDWIDTH];
 
 //
 // spanstart holds the start of a plane span
 // initialized to 0 at start
 //
-static INT32 spanstart[MAXVIDHEIGHT];
+static RENDERLOCAL INT32 spanstart[MAXVIDHEIGHT];
 
 //
 // texture mapping
 //
-lighttable_t **planezlight;
-static fixed_t planeheight;
+RENDERLOCAL lighttable_t **planezlight;
+static RENDERLOCAL fixed_t planeheight;
 
 //added : 10-02-98: yslopetab is what yslope used to be,
 //                yslope points somewhere into yslopetab,
@@ -99,16 +126,16 @@ static fixed_t planeheight;
 //                (when mouselookin', yslope is moving into yslopetab)
 //                Check R_SetupFrame, R_SetViewSize for more...
 fixed_t yslopetab[MAXVIDHEIGHT*16];
-fixed_t *yslope;
+RENDERLOCAL fixed_t *yslope;
 
-fixed_t basexscale, baseyscale;
+RENDERLOCAL fixed_t basexscale, baseyscale;
 
-fixed_t cachedheight[MAXVIDHEIGHT];
-fixed_t cacheddistance[MAXVIDHEIGHT];
-fixed_t cachedxstep[MAXVIDHEIGHT];
-fixed_t cachedystep[MAXVIDHEIGHT];
+RENDERLOCAL fixed_t cachedheight[MAXVIDHEIGHT];
+RENDERLOCAL fixed_t cacheddistance[MAXVIDHEIGHT];
+RENDERLOCAL fixed_t cachedxstep[MAXVIDHEIGHT];
+RENDERLOCAL fixed_t cachedystep[MAXVIDHEIGHT];
 
-static fixed_t xoffs, yoffs;
+static RENDERLOCAL fixed_t xoffs, yoffs;
 
 //
 // R_InitPlanes
@@ -177,10 +204,10 @@ void R_PortalRestoreClipValues(INT32 start, INT32 end, INT16 *ceil, INT16 *floor
 //  viewheight
 
 #ifndef NOWATER
-static INT32 bgofs;
-static INT32 wtofs=0;
-static INT32 waterofs;
-static boolean itswater;
+static RENDERLOCAL INT32 bgofs;
+static RENDERLOCAL INT32 wtofs=0;
+static RENDERLOCAL INT32 waterofs;
+static RENDERLOCAL boolean itswater;
 #endif
 
 #ifndef NOWATER
@@ -379,12 +406,8 @@ void R_ClearPlanes(void)
 
 	numffloors = 0;
 
-	for (i = 0; i < MAXVISPLANES; i++)
-	for (*freehead = visplanes[i], visplanes[i] = NULL;
-		freehead && *freehead ;)
-	{
-		freehead = &(*freehead)->next;
-	}
+	memset(visplanes, 0, sizeof (visplanes));
+	numpoolplanes = 0;
 
 	lastopening = openings;
 
@@ -401,20 +424,22 @@ void R_ClearPlanes(void)
 
 static visplane_t *new_visplane(unsigned hash)
 {
-	visplane_t *check = freetail;
-	if (!check)
-	{
-		check = calloc(1, sizeof (*check));
-		if (check == NULL) I_Error("%s: Out of memory", "new_visplane"); // FIXME: ugly
-	}
-	else
+	visplane_t *check;
+	size_t chunk = numpoolplanes / VISPLANECHUNK;
+
+	if (chunk == numplanechunks)
 	{
-		freetail = freetail->next;
-		if (!freetail)
-			freehead = &freetail;
+		planechunks = realloc(planechunks, (numplanechunks + 1) * sizeof (*planechunks));
+		if (planechunks == NULL) I_Error("%s: Out of memory", "new_visplane"); // FIXME: ugly
+		planechunks[numplanechunks] = calloc(VISPLANECHUNK, sizeof (**planechunks));
+		if (planechunks[numplanechunks] == NULL) I_Error("%s: Out of memory", "new_visplane");
+		numplanechunks++;
 	}
+
+	check = &planechunks[chunk][numpoolplanes++ % VISPLANECHUNK];
 	check->next = visplanes[hash];
 	visplanes[hash] = check;
+	planestats.planes++;
 	return check;
 }
 
@@ -432,6 +457,7 @@ visplane_t *R_FindPlane(fixed_t height, INT32 picnum, INT32 lightlevel,
 {
 	visplane_t *check;
 	unsigned hash;
+	UINT32 chain = 0;
 
 	if (slope); else // Don't mess with this right now if a slope is involved
 	{
@@ -472,9 +498,13 @@ visplane_t *R_FindPlane(fixed_t height, INT32 picnum, INT32 lightlevel,
 
 	if (!pfloor)
 	{
-		hash = visplane_hash(picnum, lightlevel, height);
+		hash = R_PlaneHash(height, picnum, lightlevel, xoff, yoff, slope, polyobj);
+		planestats.lookups++;
 		for (check = visplanes[hash]; check; check = check->next)
 		{
+			planestats.steps++;
+			if (++chain > planestats.longestchain)
+				planestats.longestchain = chain;
 			if (polyobj != check->polyobj)
 				continue;
 			if (height == check->height && picnum == check->picnum
@@ -566,14 +596,16 @@ visplane_t *R_CheckPlane(visplane_t *pl, INT32 start, INT32 stop)
 	else /* Cannot use existing plane; create a new one */
 	{
 		visplane_t *new_pl;
+
+		planestats.splits++;
 		if (pl->ffloor)
 		{
 			new_pl = new_visplane(MAXVISPLANES - 1);
 		}
 		else
 		{
-			unsigned hash =
-				visplane_hash(pl->picnum, pl->lightlevel, pl->height);
+			unsigned hash = R_PlaneHash(pl->height, pl->picnum, pl->lightlevel,
+				pl->xoffs, pl->yoffs, pl->slope, pl->polyobj);
 			new_pl = new_visplane(hash);
 		}
 
@@ -676,17 +708,57 @@ void R_MakeSpans(INT32 x, INT32 t1, INT32 b1, INT32 t2, INT32 b2)
 		spanstart[b2--] = x;
 }
 
+#ifdef PARALLELVIEWS
+// What the slice threads need from the main thread's R_ClearPlanes and
+// R_DrawPlanes, see R_ShareSlicePlanes
+static visplane_t **slicevisplanes;
+static fixed_t *sliceyslope;
+static fixed_t slicexscale, sliceyscale;
+static INT32 slicewaterofs, slicewtofs;
+
+//
+// R_ShareSlicePlanes
+// Called on the main thread once the BSP walk is over, so that
+// R_LoadSlicePlanes can set up the slice threads to draw its planes.
+//
+void R_ShareSlicePlanes(void)
+{
+	slicevisplanes = visplanes;
+	sliceyslope = yslope;
+	slicexscale = basexscale;
+	sliceyscale = baseyscale;
+	slicewaterofs = waterofs;
+	slicewtofs = wtofs;
+}
+
+void R_LoadSlicePlanes(void)
+{
+	yslope = sliceyslope;
+	basexscale = slicexscale;
+	baseyscale = sliceyscale;
+	waterofs = slicewaterofs;
+	wtofs = slicewtofs;
+	memset(cachedheight, 0, sizeof (cachedheight));
+}
+#endif
+
 void R_DrawPlanes(void)
 {
+	visplane_t **planes = visplanes;
 	visplane_t *pl;
 	INT32 i;
 
+#ifdef PARALLELVIEWS
+	if (renderslices)
+		planes = slicevisplanes;
+#endif
+
 	spanfunc = basespanfunc;
 	wallcolfunc = walldrawerfunc;
 
 	for (i = 0; i < MAXVISPLANES; i++, pl++)
 	{
-		for (pl = visplanes[i]; pl; pl = pl->next)
+		for (pl = planes[i]; pl; pl = pl->next)
 		{
 			if (pl->ffloor != NULL || pl->polyobj != NULL)
 				continue;
@@ -700,10 +772,233 @@ void R_DrawPlanes(void)
 #endif
 }
 
+//
+// Sky cache
+// The sky only depends on the view angle and the vertical centre, so a
+// view that holds still can copy last frame's sky columns back out instead
+// of looking every pixel up again. Rows are stored relative to centery,
+// so aiming up and down reuses them as long as the fraction of centeryfrac
+// stays put; they get filled in lazily as planes ask for them.
+//
+// Building the cache costs more than drawing straight, so a view only
+// starts one once its sky has looked the same for a whole frame. Turning,
+// and portals that look somewhere else, just draw directly.
+//
+typedef struct
+{
+	angle_t viewangle;
+	fixed_t centerfrac;
+	INT32 texnum;
+	fixed_t texturemid, scale;
+	lighttable_t *colormap;
+} skykey_t;
+
+typedef struct
+{
+	UINT8 *pixels; // width columns of 2*height rows, row 0 is centery-height
+	INT16 *top, *bottom; // range of rows built so far, per column
+	INT32 width, height;
+	skykey_t key; // what's in pixels
+
+	UINT32 frame; // bumped by R_StartSkyCacheFrame
+	skykey_t seen; // the first sky drawn in seenframe
+	UINT32 seenframe;
+} skycache_t;
+
+static skycache_t skycaches[MAXSPLITSCREENPLAYERS];
+
+//
+// R_ClearSkyCache
+// Throws out every view's cached sky, for when the sky texture, the
+// colormaps or the view layout change.
+//
+void R_ClearSkyCache(void)
+{
+	INT32 i;
+
+	for (i = 0; i < MAXSPLITSCREENPLAYERS; i++)
+	{
+		if (skycaches[i].pixels)
+			Z_Free(skycaches[i].pixels);
+		memset(&skycaches[i], 0, sizeof (skycaches[i]));
+	}
+}
+
+//
+// R_StartSkyCacheFrame
+// Call once at the start of each frame of the current view.
+//
+void R_StartSkyCacheFrame(void)
+{
+	if (viewssnum < MAXSPLITSCREENPLAYERS)
+		skycaches[viewssnum].frame++;
+}
+
+static skycache_t *R_GetSkyCache(visplane_t *pl)
+{
+	skycache_t *cache;
+	skykey_t key;
+	boolean still;
+	INT32 x;
+
+#ifdef PARALLELVIEWS
+	// slices share a view between threads, so they just draw directly
+	if (renderslices)
+		return NULL;
+#endif
+	if (viewssnum >= MAXSPLITSCREENPLAYERS)
+		return NULL;
+
+	cache = &skycaches[viewssnum];
+
+	memset(&key, 0, sizeof key); // compared with memcmp
+	key.viewangle = pl->viewangle;
+	key.centerfrac = centeryfrac & (FRACUNIT-1);
+	key.texnum = texturetranslation[skytexture];
+	key.texturemid = dc_texturemid;
+	key.scale = skyscale;
+	key.colormap = dc_colormap;
+
+	if (cache->pixels && cache->width == viewwidth && cache->height == viewheight
+		&& !memcmp(&key, &cache->key, sizeof key))
+	{
+		if (cache->seenframe != cache->frame)
+		{
+			cache->seen = key;
+			cache->seenframe = cache->frame;
+		}
+		return cache;
+	}
+
+	// Only the first sky of each frame counts, so a portal doesn't
+	// knock out the main view.
+	still = (cache->seenframe != cache->frame && !memcmp(&key, &cache->seen, sizeof key));
+	if (cache->seenframe != cache->frame)
+	{
+		cache->seen = key;
+		cache->seenframe = cache->frame;
+	}
+	if (!still)
+		return NULL;
+
+	if (cache->width != viewwidth || cache->height != viewheight)
+	{
+		size_t columns = (size_t)viewwidth * viewheight * 2;
+
+		if (cache->pixels)
+			Z_Free(cache->pixels);
+		cache->pixels = Z_Malloc(columns + viewwidth * 2 * sizeof (INT16), PU_STATIC, NULL);
+		cache->top = (INT16 *)(cache->pixels + columns);
+		cache->bottom = cache->top + viewwidth;
+		cache->width = viewwidth;
+		cache->height = viewheight;
+	}
+
+	for (x = 0; x < cache->width; x++)
+	{
+		cache->top[x] = INT16_MAX;
+		cache->bottom[x] = INT16_MIN;
+	}
+	cache->key = key;
+
+	return cache;
+}
+
+// Fills in rows top to bottom of a cached column. Each row is stepped on
+// from row 0, the way R_DrawColumn_8 steps down from dc_yl, so pieces
+// built at different times line up. Like two direct draws starting at
+// different dc_yl, a row can still come out a texel off from a direct draw.
+static void R_BuildSkyRows(skycache_t *cache, UINT8 *column, INT32 top, INT32 bottom)
+{
+	const UINT8 *source = dc_source;
+	const lighttable_t *colormap = dc_colormap;
+	fixed_t fracstep = dc_iscale;
+	INT64 start = dc_texturemid + FixedMul(-cache->height*FRACUNIT - cache->key.centerfrac, fracstep)
+		+ (INT64)top*fracstep;
+	fixed_t frac;
+	INT32 heightmask = dc_texheight-1;
+	INT32 y;
+
+	if (dc_texheight & heightmask) // not a power of 2
+	{
+		heightmask++;
+		heightmask <<= FRACBITS;
+
+		start %= heightmask;
+		if (start < 0)
+			start += heightmask;
+		frac = (fixed_t)start;
+
+		for (y = top; y <= bottom; y++)
+		{
+			column[y] = colormap[source[frac>>FRACBITS]];
+
+			if (fracstep > 0x7FFFFFFF - frac)
+				frac += fracstep - heightmask;
+			else
+				frac += fracstep;
+
+			while (frac >= heightmask)
+				frac -= heightmask;
+		}
+	}
+	else
+	{
+		frac = (fixed_t)(UINT32)start; // only the texel bits matter
+		for (y = top; y <= bottom; y++, frac += fracstep)
+			column[y] = colormap[source[(frac>>FRACBITS) & heightmask]];
+	}
+}
+
+// Draws dc_yl to dc_yh of column dc_x out of the cache, building whatever
+// rows it doesn't have yet. Returns false if they're out of its reach.
+static boolean R_DrawCachedSkyColumn(skycache_t *cache, INT32 angle)
+{
+	INT32 top = dc_yl - (centeryfrac>>FRACBITS) + cache->height;
+	INT32 bottom = dc_yh - (centeryfrac>>FRACBITS) + cache->height;
+	UINT8 *column, *dest;
+	INT32 count;
+
+	if (dc_x >= cache->width || top < 0 || bottom >= cache->height*2)
+		return false;
+
+	column = cache->pixels + (size_t)dc_x * cache->height * 2;
+
+	if (top < cache->top[dc_x] || bottom > cache->bottom[dc_x])
+	{
+		dc_source = R_GetColumn(cache->key.texnum, angle);
+
+		if (cache->top[dc_x] > cache->bottom[dc_x]) // nothing built yet
+			R_BuildSkyRows(cache, column, top, bottom);
+		else
+		{
+			// keep the built rows in one piece
+			if (top < cache->top[dc_x])
+				R_BuildSkyRows(cache, column, top, cache->top[dc_x] - 1);
+			if (bottom > cache->bottom[dc_x])
+				R_BuildSkyRows(cache, column, cache->bottom[dc_x] + 1, bottom);
+			top = min(top, cache->top[dc_x]);
+			bottom = max(bottom, cache->bottom[dc_x]);
+		}
+
+		cache->top[dc_x] = (INT16)top;
+		cache->bottom[dc_x] = (INT16)bottom;
+		top = dc_yl - (centeryfrac>>FRACBITS) + cache->height;
+	}
+
+	dest = &topleft[dc_yl*vid.width + dc_x];
+	column += top;
+	for (count = dc_yh - dc_yl + 1; count--; dest += vid.width)
+		*dest = *column++;
+
+	return true;
+}
+
 static void R_DrawSkyPlane(visplane_t *pl)
 {
 	INT32 x;
 	INT32 angle;
+	skycache_t *cache;
 
 	if (!newview->sky)
 	{
@@ -725,7 +1020,8 @@ static void R_DrawSkyPlane(visplane_t *pl)
 	dc_texturemid = skytexturemid;
 	dc_texheight = textureheight[skytexture]
 		>>FRACBITS;
-	for (x = pl->minx; x <= pl->maxx; x++)
+	cache = R_GetSkyCache(pl);
+	for (x = max(pl->minx, slicex1); x <= pl->maxx && x <= slicex2; x++)
 	{
 		dc_yl = pl->top[x];
 		dc_yh = pl->bottom[x];
@@ -734,6 +1030,8 @@ static void R_DrawSkyPlane(visplane_t *pl)
 			angle = (pl->viewangle + xtoviewangle[x])>>ANGLETOSKYSHIFT;
 			dc_iscale = FixedMul(skyscale, FINECOSINE(xtoviewangle[x]>>ANGLETOFINESHIFT));
 			dc_x = x;
+			if (cache && R_DrawCachedSkyColumn(cache, angle))
+				continue;
 			dc_source =
 				R_GetColumn(texturetranslation[skytexture],
 					angle);
@@ -742,17 +1040,39 @@ static void R_DrawSkyPlane(visplane_t *pl)
 	}
 }
 
+//
+// R_PlaneSpans
+// R_MakeSpans for every column of the plane in this thread's slice,
+// with the columns either side of it counting as empty.
+//
+static void R_PlaneSpans(visplane_t *pl)
+{
+	const INT32 x1 = max(pl->minx, slicex1);
+	const INT32 x2 = min(pl->maxx, slicex2);
+	INT32 x;
+
+	R_MakeSpans(x1, 0xffff, 0x0000, pl->top[x1], pl->bottom[x1]);
+	for (x = x1 + 1; x <= x2; x++)
+	{
+		R_MakeSpans(x, pl->top[x-1], pl->bottom[x-1],
+			pl->top[x], pl->bottom[x]);
+	}
+	R_MakeSpans(x2 + 1, pl->top[x2], pl->bottom[x2], 0xffff, 0x0000);
+}
+
 void R_DrawSinglePlane(visplane_t *pl)
 {
 	INT32 light = 0;
-	INT32 x;
-	INT32 stop, angle;
+	INT32 angle;
 	size_t size;
 	ffloor_t *rover;
 
 	if (!(pl->minx <= pl->maxx))
 		return;
 
+	if (pl->maxx < slicex1 || pl->minx > slicex2) // all in other slices
+		return;
+
 	// sky flat
 	if (pl->picnum == skyflatnum)
 	{
@@ -766,7 +1086,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 	spanfunc = basespanfunc;
 
 	if (pl->polyobj && pl->polyobj->translucency != 0) {
-		spanfunc = R_DrawTranslucentSpan_8;
+		spanfunc = transspanfunc;
 
 		// Hacked up support for alpha value in software mode Tails 09-24-2002 (sidenote: ported to polys 10-15-2014, there was no time travel involved -Red)
 		if (pl->polyobj->translucency >= 10)
@@ -807,7 +1127,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 
 		if (pl->ffloor->flags & FF_TRANSLUCENT)
 		{
-			spanfunc = R_DrawTranslucentSpan_8;
+			spanfunc = transspanfunc;
 
 			// Hacked up support for alpha value in software mode Tails 09-24-2002
 			if (pl->ffloor->alpha < 12)
@@ -858,7 +1178,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 			UINT8 *scr;
 
 			itswater = true;
-			if (spanfunc == R_DrawTranslucentSpan_8)
+			if (spanfunc == transspanfunc)
 			{
 				spanfunc = R_DrawTranslucentWaterSpan_8;
 
@@ -881,6 +1201,13 @@ void R_DrawSinglePlane(visplane_t *pl)
 				else
 					scr = (screens[0] + ((top)*vid.width));
 
+#ifdef PARALLELVIEWS
+				if (renderslices) // the rest of the screen is still being drawn to
+					VID_BlitLinearScreen(scr + slicex1, screens[1]+((top)*vid.width) + slicex1,
+					                     slicex2 - slicex1 + 1, bottom-top,
+					                     vid.width, vid.width);
+				else
+#endif
 				VID_BlitLinearScreen(scr, screens[1]+((top)*vid.width),
 				                     vid.width, bottom-top,
 				                     vid.width, vid.width);
@@ -1094,26 +1421,18 @@ void R_DrawSinglePlane(visplane_t *pl)
 		ds_sv.z *= SFMULT;
 #undef SFMULT
 
-		if (spanfunc == R_DrawTranslucentSpan_8)
+		if (spanfunc == transspanfunc)
 			spanfunc = R_DrawTiltedTranslucentSpan_8;
 		else if (spanfunc == splatfunc)
 			spanfunc = R_DrawTiltedSplat_8;
 		else
-			spanfunc = R_DrawTiltedSpan_8;
+			spanfunc = tiltedspanfunc;
 
 		planezlight = scalelight[light];
 	} else
 
 	planezlight = zlight[light];
 
-	// set the maximum value for unsigned
-	pl->top[pl->maxx+1] = 0xffff;
-	pl->top[pl->minx-1] = 0xffff;
-	pl->bottom[pl->maxx+1] = 0x0000;
-	pl->bottom[pl->minx-1] = 0x0000;
-
-	stop = pl->maxx + 1;
-
 	if (viewx != pl->viewx || viewy != pl->viewy)
 	{
 		viewx = pl->viewx;
@@ -1122,11 +1441,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 	if (viewz != pl->viewz)
 		viewz = pl->viewz;
 
-	for (x = pl->minx; x <= stop; x++)
-	{
-		R_MakeSpans(x, pl->top[x-1], pl->bottom[x-1],
-			pl->top[x], pl->bottom[x]);
-	}
+	R_PlaneSpans(pl);
 
 /*
 QUINCUNX anti-aliasing technique (sort of)
@@ -1145,11 +1460,11 @@ a 'smoothing' of the texture while
 using the palette colors.
 */
 #ifdef QUINCUNX
-	if (spanfunc == R_DrawSpan_8)
+	if (spanfunc == basespanfunc)
 	{
 		INT32 i;
 		ds_transmap = transtables + ((tr_trans50-1)<<FF_TRANSSHIFT);
-		spanfunc = R_DrawTranslucentSpan_8;
+		spanfunc = transspanfunc;
 		for (i=0; i<4; i++)
 		{
 			xoffs = pl->xoffs;
@@ -1184,17 +1499,7 @@ using the palette colors.
 
 			planezlight = zlight[light];
 
-			// set the maximum value for unsigned
-			pl->top[pl->maxx+1] = 0xffff;
-			pl->top[pl->minx-1] = 0xffff;
-			pl->bottom[pl->maxx+1] = 0x0000;
-			pl->bottom[pl->minx-1] = 0x0000;
-
-			stop = pl->maxx + 1;
-
-			for (x = pl->minx; x <= stop; x++)
-				R_MakeSpans(x, pl->top[x-1], pl->bottom[x-1],
-					pl->top[x], pl->bottom[x]);
+			R_PlaneSpans(pl);
 		}
 	}
 #endif
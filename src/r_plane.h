@@ -51,23 +51,36 @@ typedef struct visplane_s
 	boolean noencore;
 } visplane_t;
 
-extern visplane_t *floorplane;
-extern visplane_t *ceilingplane;
+extern RENDERLOCAL visplane_t *floorplane;
+extern RENDERLOCAL visplane_t *ceilingplane;
+
+// What R_FindPlane and R_CheckPlane got up to for the last view,
+// shown on the HUD with the DBG_RENDER devmode flag
+typedef struct
+{
+	UINT32 planes; // visplanes made
+	UINT32 lookups, steps; // R_FindPlane searches, and chain links walked for them
+	UINT32 longestchain;
+	UINT32 splits; // R_CheckPlane couldn't extend a plane and made another
+} planestats_t;
+
+extern RENDERLOCAL planestats_t planestats;
 
 // Visplane related.
-extern INT16 *lastopening, *openings;
-extern size_t maxopenings;
+extern RENDERLOCAL INT16 *lastopening, *openings;
+extern RENDERLOCAL size_t maxopenings;
 
-extern INT16 floorclip[MAXVIDWIDTH], ceilingclip[MAXVIDWIDTH];
-extern fixed_t frontscale[MAXVIDWIDTH], yslopetab[MAXVIDHEIGHT*16];
-extern fixed_t cachedheight[MAXVIDHEIGHT];
-extern fixed_t cacheddistance[MAXVIDHEIGHT];
-extern fixed_t cachedxstep[MAXVIDHEIGHT];
-extern fixed_t cachedystep[MAXVIDHEIGHT];
-extern fixed_t basexscale, baseyscale;
+extern RENDERLOCAL INT16 floorclip[MAXVIDWIDTH], ceilingclip[MAXVIDWIDTH];
+extern RENDERLOCAL fixed_t frontscale[MAXVIDWIDTH];
+extern fixed_t yslopetab[MAXVIDHEIGHT*16];
+extern RENDERLOCAL fixed_t cachedheight[MAXVIDHEIGHT];
+extern RENDERLOCAL fixed_t cacheddistance[MAXVIDHEIGHT];
+extern RENDERLOCAL fixed_t cachedxstep[MAXVIDHEIGHT];
+extern RENDERLOCAL fixed_t cachedystep[MAXVIDHEIGHT];
+extern RENDERLOCAL fixed_t basexscale, baseyscale;
 
-extern fixed_t *yslope;
-extern lighttable_t **planezlight;
+extern RENDERLOCAL fixed_t *yslope;
+extern RENDERLOCAL lighttable_t **planezlight;
 
 void R_InitPlanes(void);
 void R_PortalStoreClipValues(INT32 start, INT32 end, INT16 *ceil, INT16 *floor, fixed_t *scale);
@@ -77,6 +90,12 @@ void R_ClearPlanes(void);
 void R_MapPlane(INT32 y, INT32 x1, INT32 x2);
 void R_MakeSpans(INT32 x, INT32 t1, INT32 b1, INT32 t2, INT32 b2);
 void R_DrawPlanes(void);
+void R_ClearSkyCache(void);
+void R_StartSkyCacheFrame(void);
+#ifdef PARALLELVIEWS
+void R_ShareSlicePlanes(void);
+void R_LoadSlicePlanes(void);
+#endif
 visplane_t *R_FindPlane(fixed_t height, INT32 picnum, INT32 lightlevel, fixed_t xoff, fixed_t yoff, angle_t plangle,
 	extracolormap_t *planecolormap, ffloor_t *ffloor
 	, polyobj_t *polyobj
@@ -110,6 +129,6 @@ typedef struct planemgr_s
 	polyobj_t *polyobj;
 } visffloor_t;
 
-extern visffloor_t ffloor[MAXFFLOORS];
-extern INT32 numffloors;
+extern RENDERLOCAL visffloor_t ffloor[MAXFFLOORS];
+extern RENDERLOCAL INT32 numffloors;
 #endif
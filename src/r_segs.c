@@ -28,47 +28,47 @@
 // OPTIMIZE: closed two sided lines as single sided
 
 // True if any of the segs textures might be visible.
-static boolean segtextured;
-static boolean markfloor; // False if the back side is the same plane.
-static boolean markceiling;
+static RENDERLOCAL boolean segtextured;
+static RENDERLOCAL boolean markfloor; // False if the back side is the same plane.
+static RENDERLOCAL boolean markceiling;
 
-static boolean maskedtexture;
-static INT32 toptexture, bottomtexture, midtexture;
-static INT32 numthicksides, numbackffloors;
+static RENDERLOCAL boolean maskedtexture;
+static RENDERLOCAL INT32 toptexture, bottomtexture, midtexture;
+static RENDERLOCAL INT32 numthicksides, numbackffloors;
 
-angle_t rw_normalangle;
+RENDERLOCAL angle_t rw_normalangle;
 // angle to line origin
-angle_t rw_angle1;
-fixed_t rw_distance;
+RENDERLOCAL angle_t rw_angle1;
+RENDERLOCAL fixed_t rw_distance;
 
 //
 // regular wall
 //
-static INT32 rw_x, rw_stopx;
-static angle_t rw_centerangle;
-static fixed_t rw_offset;
-static fixed_t rw_offset2; // for splats
-static fixed_t rw_scale, rw_scalestep;
-static fixed_t rw_midtexturemid, rw_toptexturemid, rw_bottomtexturemid;
-static INT32 worldtop, worldbottom, worldhigh, worldlow;
-static INT32 worldtopslope, worldbottomslope, worldhighslope, worldlowslope; // worldtop/bottom at end of slope
-static fixed_t rw_toptextureslide, rw_midtextureslide, rw_bottomtextureslide; // Defines how to adjust Y offsets along the wall for slopes
-static fixed_t rw_midtextureback, rw_midtexturebackslide; // Values for masked midtexture height calculation
-static fixed_t pixhigh, pixlow, pixhighstep, pixlowstep;
-static fixed_t topfrac, topstep;
-static fixed_t bottomfrac, bottomstep;
-
-static lighttable_t **walllights;
-static INT16 *maskedtexturecol;
-static fixed_t *maskedtextureheight = NULL;
+static RENDERLOCAL INT32 rw_x, rw_stopx;
+static RENDERLOCAL angle_t rw_centerangle;
+static RENDERLOCAL fixed_t rw_offset;
+static RENDERLOCAL fixed_t rw_offset2; // for splats
+static RENDERLOCAL fixed_t rw_scale, rw_scalestep;
+static RENDERLOCAL fixed_t rw_midtexturemid, rw_toptexturemid, rw_bottomtexturemid;
+static RENDERLOCAL INT32 worldtop, worldbottom, worldhigh, worldlow;
+static RENDERLOCAL INT32 worldtopslope, worldbottomslope, worldhighslope, worldlowslope; // worldtop/bottom at end of slope
+static RENDERLOCAL fixed_t rw_toptextureslide, rw_midtextureslide, rw_bottomtextureslide; // Defines how to adjust Y offsets along the wall for slopes
+static RENDERLOCAL fixed_t rw_midtextureback, rw_midtexturebackslide; // Values for masked midtexture height calculation
+static RENDERLOCAL fixed_t pixhigh, pixlow, pixhighstep, pixlowstep;
+static RENDERLOCAL fixed_t topfrac, topstep;
+static RENDERLOCAL fixed_t bottomfrac, bottomstep;
+
+static RENDERLOCAL lighttable_t **walllights;
+static RENDERLOCAL INT16 *maskedtexturecol;
+static RENDERLOCAL fixed_t *maskedtextureheight = NULL;
 
 // ==========================================================================
 // R_Splats Wall Splats Drawer
 // ==========================================================================
 
 #ifdef WALLSPLATS
-static INT16 last_ceilingclip[MAXVIDWIDTH];
-static INT16 last_floorclip[MAXVIDWIDTH];
+static RENDERLOCAL INT16 last_ceilingclip[MAXVIDWIDTH];
+static RENDERLOCAL INT16 last_floorclip[MAXVIDWIDTH];
 
 static void R_DrawSplatColumn(column_t *column)
 {
@@ -237,12 +237,15 @@ static void R_DrawWallSplats(void)
 //  way we don't have to store extra post_t info with each column for
 //  multi-patch textures. They are not normally needed as multi-patch
 //  textures don't have holes in it. At least not for now.
-static INT32 column2s_length; // column->length : for multi-patch on 2sided wall = texture->height
+static RENDERLOCAL INT32 column2s_length; // column->length : for multi-patch on 2sided wall = texture->height
 
 static void R_Render2sidedMultiPatchColumn(column_t *column)
 {
 	INT32 topscreen, bottomscreen;
 
+	if (dc_x < slicex1) // another thread's column
+		return;
+
 	topscreen = sprtopscreen; // + spryscale*column->topdelta;  topdelta is 0 for the wall
 	bottomscreen = topscreen + spryscale * column2s_length;
 
@@ -291,6 +294,13 @@ void R_RenderMaskedSegRange(drawseg_t *ds, INT32 x1, INT32 x2)
 	INT64 overflow_test;
 	INT32 range;
 
+	// Columns left of the slice still have to be stepped through, the
+	// lighting and scale carry over from one drawn column to the next.
+	if (x1 > slicex2)
+		return;
+	if (x2 > slicex2)
+		x2 = slicex2;
+
 	// Calculate light table.
 	// Use different light tables
 	//   for horizontal / vertical / diagonal. Diagonal?
@@ -679,6 +689,9 @@ void R_RenderMaskedSegRange(drawseg_t *ds, INT32 x1, INT32 x2)
 // Loop through R_DrawMaskedColumn calls
 static void R_DrawRepeatMaskedColumn(column_t *col)
 {
+	if (dc_x < slicex1)
+		return;
+
 	while (sprtopscreen < sprbotscreen) {
 		R_DrawMaskedColumn(col);
 		if (sprtopscreen + (INT64)dc_texheight*spryscale > (INT64)INT32_MAX) // prevent overflow
@@ -719,6 +732,12 @@ void R_RenderThickSideRange(drawseg_t *ds, INT32 x1, INT32 x2, ffloor_t *pfloor)
 
 	void (*colfunc_2s) (column_t *);
 
+	// same as R_RenderMaskedSegRange
+	if (x1 > slicex2)
+		return;
+	if (x2 > slicex2)
+		x2 = slicex2;
+
 	// Calculate light table.
 	// Use different light tables
 	//   for horizontal / vertical / diagonal. Diagonal?
@@ -1230,6 +1249,198 @@ UINT32 nombre = 100000;
 #endif
 //profile stuff ---------------------------------------------------------
 
+//
+// Batched wall columns
+//
+// Drawing a wall one column at a time walks down the screen at a stride of
+// vid.width, touching a new cache line on every pixel. When the plain wall
+// drawer is in use, columns are queued per wall tier instead and drawn
+// WALLBATCH at a time, row by row, which gives the same pixels as
+// R_DrawColumn_8 would.
+//
+#define WALLBATCH 8
+
+typedef struct
+{
+	INT32 x, yl, yh;
+	fixed_t frac, fracstep;
+	boolean pow2; // texture height is a power of 2
+	INT32 heightmask; // texture height - 1, or in fixed point if not pow2
+	const UINT8 *source;
+	const lighttable_t *colormap;
+} wallcolumn_t;
+
+typedef struct
+{
+	wallcolumn_t cols[WALLBATCH];
+	INT32 count;
+} wallbatch_t;
+
+enum {WALL_TOP, WALL_MID, WALL_BOTTOM, NUMWALLTIERS};
+
+static RENDERLOCAL wallbatch_t wallbatches[NUMWALLTIERS];
+static RENDERLOCAL boolean batchwalls;
+
+static void R_DrawWallBatch(wallbatch_t *batch)
+{
+	wallcolumn_t *col;
+	UINT8 *dest;
+	INT32 y, ymin, ymax, i;
+
+	if (!batch->count)
+		return;
+
+	ymin = batch->cols[0].yl;
+	ymax = batch->cols[0].yh;
+	for (i = 1; i < batch->count; i++)
+	{
+		if (batch->cols[i].yl < ymin)
+			ymin = batch->cols[i].yl;
+		if (batch->cols[i].yh > ymax)
+			ymax = batch->cols[i].yh;
+	}
+
+	for (y = ymin; y <= ymax; y++)
+	{
+		dest = &topleft[y*vid.width];
+		for (i = 0, col = batch->cols; i < batch->count; i++, col++)
+		{
+			if (y < col->yl || y > col->yh)
+				continue;
+
+			if (col->pow2)
+			{
+				dest[col->x] = col->colormap[col->source[(col->frac>>FRACBITS) & col->heightmask]];
+				col->frac += col->fracstep;
+			}
+			else
+			{
+				// same Tutti-Frutti stepping as R_DrawColumn_8
+				dest[col->x] = col->colormap[col->source[col->frac>>FRACBITS]];
+				if (col->fracstep > 0x7FFFFFFF - col->frac)
+					col->frac += col->fracstep - col->heightmask;
+				else
+					col->frac += col->fracstep;
+				while (col->frac >= col->heightmask)
+					col->frac -= col->heightmask;
+			}
+		}
+	}
+
+	batch->count = 0;
+}
+
+// Queues a column behind its neighbours, or draws them first if it isn't one
+static void R_BatchWallColumn(INT32 tier, const wallcolumn_t *col)
+{
+	wallbatch_t *batch = &wallbatches[tier];
+
+	if (batch->count && batch->cols[batch->count-1].x != col->x - 1)
+		R_DrawWallBatch(batch);
+
+	batch->cols[batch->count++] = *col;
+
+	if (batch->count == WALLBATCH)
+		R_DrawWallBatch(batch);
+}
+
+#ifdef PARALLELVIEWS
+// While a view is drawn in slices, the batched columns are only written
+// down during the BSP walk. Each slice then draws its own share of them
+// in R_DrawDeferredWalls.
+typedef struct
+{
+	wallcolumn_t col;
+	INT32 tier;
+} deferredwall_t;
+
+static deferredwall_t *deferredwalls;
+static size_t numdeferredwalls, maxdeferredwalls;
+
+static void R_DeferWallColumn(INT32 tier, const wallcolumn_t *col)
+{
+	if (numdeferredwalls == maxdeferredwalls)
+	{
+		maxdeferredwalls = maxdeferredwalls ? maxdeferredwalls*2 : 1024;
+		deferredwalls = Z_Realloc(deferredwalls, maxdeferredwalls * sizeof (*deferredwalls), PU_STATIC, NULL);
+	}
+	deferredwalls[numdeferredwalls].col = *col;
+	deferredwalls[numdeferredwalls].tier = tier;
+	numdeferredwalls++;
+}
+
+//
+// R_DrawDeferredWalls
+// Draws the deferred columns that fall in this thread's slice.
+//
+void R_DrawDeferredWalls(void)
+{
+	const deferredwall_t *wall, *end = deferredwalls + numdeferredwalls;
+	INT32 i;
+
+	for (wall = deferredwalls; wall < end; wall++)
+	{
+		if (wall->col.x >= slicex1 && wall->col.x <= slicex2)
+			R_BatchWallColumn(wall->tier, &wall->col);
+	}
+	for (i = 0; i < NUMWALLTIERS; i++)
+		R_DrawWallBatch(&wallbatches[i]);
+}
+
+void R_ClearDeferredWalls(void)
+{
+	numdeferredwalls = 0;
+}
+#endif
+
+// Draws the column set up in dc_*, now or with its neighbours
+static void R_DrawWallColumn(INT32 tier)
+{
+	wallcolumn_t col;
+
+	if (!batchwalls)
+	{
+		colfunc();
+		return;
+	}
+
+	if (dc_yh < dc_yl)
+		return;
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		return;
+#endif
+
+	col.x = dc_x;
+	col.yl = dc_yl;
+	col.yh = dc_yh;
+	col.source = dc_source;
+	col.colormap = dc_colormap;
+	col.fracstep = dc_iscale;
+	col.frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, dc_iscale))*(!dc_hires);
+
+	col.pow2 = !(dc_texheight & (dc_texheight - 1));
+	if (col.pow2)
+		col.heightmask = dc_texheight - 1;
+	else
+	{
+		col.heightmask = dc_texheight<<FRACBITS;
+		if (col.frac < 0)
+			while ((col.frac += col.heightmask) < 0);
+		else
+			while (col.frac >= col.heightmask)
+				col.frac -= col.heightmask;
+	}
+
+#ifdef PARALLELVIEWS
+	if (renderslices)
+	{
+		R_DeferWallColumn(tier, &col);
+		return;
+	}
+#endif
+	R_BatchWallColumn(tier, &col);
+}
 
 static void R_RenderSegLoop (void)
 {
@@ -1245,6 +1456,24 @@ static void R_RenderSegLoop (void)
 	INT32     bottom;
 	INT32     i;
 
+	batchwalls = (!dc_numlights && (colfunc == R_DrawColumn_8
+#ifdef SIMDDRAW
+		|| colfunc == R_DrawColumn_8_SSE2 || colfunc == R_DrawColumn_8_AVX2
+#endif
+		));
+
+	if (batchwalls)
+	{
+		// composite the textures now, so none get made (or purged) while
+		// their columns are still waiting in a batch
+		if (midtexture)
+			R_GetColumn(midtexture, 0);
+		if (toptexture)
+			R_GetColumn(toptexture, 0);
+		if (bottomtexture)
+			R_GetColumn(bottomtexture, 0);
+	}
+
 	for (; rw_x < rw_stopx; rw_x++)
 	{
 		// mark floor / ceiling areas
@@ -1443,7 +1672,7 @@ static void R_RenderSegLoop (void)
 #ifdef TIMING
 				ProfZeroTimer();
 #endif
-				colfunc();
+				R_DrawWallColumn(WALL_MID);
 #ifdef TIMING
 				RDMSR(0x10,&mycount);
 				mytotal += mycount;      //64bit add
@@ -1491,7 +1720,7 @@ static void R_RenderSegLoop (void)
 						dc_texturemid = rw_toptexturemid;
 						dc_source = R_GetColumn(toptexture,texturecolumn);
 						dc_texheight = textureheight[toptexture]>>FRACBITS;
-						colfunc();
+						R_DrawWallColumn(WALL_TOP);
 						ceilingclip[rw_x] = (INT16)mid;
 					}
 					else // entirely off top of screen
@@ -1525,7 +1754,7 @@ static void R_RenderSegLoop (void)
 						dc_source = R_GetColumn(bottomtexture,
 							texturecolumn);
 						dc_texheight = textureheight[bottomtexture]>>FRACBITS;
-						colfunc();
+						R_DrawWallColumn(WALL_BOTTOM);
 						floorclip[rw_x] = (INT16)mid;
 					}
 					else  // entirely off bottom of screen
@@ -1574,6 +1803,8 @@ static void R_RenderSegLoop (void)
 		topfrac += topstep;
 		bottomfrac += bottomstep;
 	}
+	for (i = 0; i < NUMWALLTIERS; i++)
+		R_DrawWallBatch(&wallbatches[i]);
 }
 
 // Uses precalculated seg->length
@@ -1611,7 +1842,7 @@ void R_StoreWallRange(INT32 start, INT32 stop)
 	INT32 range;
 	vertex_t segleft, segright;
 	fixed_t ceilingfrontslide, floorfrontslide, ceilingbackslide, floorbackslide;
-	static size_t maxdrawsegs = 0;
+	static RENDERLOCAL size_t maxdrawsegs = 0;
 
 	maskedtextureheight = NULL;
 	//initialize segleft and segright
@@ -21,5 +21,9 @@
 void R_RenderMaskedSegRange(drawseg_t *ds, INT32 x1, INT32 x2);
 void R_RenderThickSideRange(drawseg_t *ds, INT32 x1, INT32 x2, ffloor_t *pffloor);
 void R_StoreWallRange(INT32 start, INT32 stop);
+#ifdef PARALLELVIEWS
+void R_DrawDeferredWalls(void);
+void R_ClearDeferredWalls(void);
+#endif
 
 #endif
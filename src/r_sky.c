@@ -69,6 +69,7 @@ void R_SetupSkyDraw(void)
 	wallcolfunc = walldrawerfunc;
 
 	R_SetSkyScale();
+	R_ClearSkyCache();
 }
 
 /**	\brief	The R_SetSkyScale function
@@ -38,7 +38,7 @@ struct rastery_s
 	fixed_t tx1, ty1;
 	fixed_t tx2, ty2; // start/end points in texture at this line
 };
-static struct rastery_s rastertab[MAXVIDHEIGHT];
+static RENDERLOCAL struct rastery_s rastertab[MAXVIDHEIGHT];
 
 static void prepare_rastertab(void);
 #endif
@@ -303,7 +303,7 @@ void R_AddFloorSplat(subsector_t *subsec, mobj_t *mobj, const char *picname, fix
 // --------------------------------------------------------------------------
 // Before each frame being rendered, clear the visible floorsplats list
 // --------------------------------------------------------------------------
-static floorsplat_t *visfloorsplats;
+static RENDERLOCAL floorsplat_t *visfloorsplats;
 
 void R_ClearVisibleFloorSplats(void)
 {
@@ -87,17 +87,18 @@ extern side_t *sides;
 //
 // POV data.
 //
-extern fixed_t viewx, viewy, viewz;
-extern angle_t viewangle, aimingangle;
-extern UINT8 viewssnum; // splitscreen view number
-extern boolean viewsky, skyVisible;
+extern RENDERLOCAL fixed_t viewx, viewy, viewz;
+extern RENDERLOCAL angle_t viewangle, aimingangle;
+extern RENDERLOCAL UINT8 viewssnum; // splitscreen view number
+extern boolean viewsky;
+extern RENDERLOCAL boolean skyVisible;
 extern boolean skyVisiblePerPlayer[MAXSPLITSCREENPLAYERS]; // saved values of skyVisible of each splitscreen player
-extern sector_t *viewsector;
-extern player_t *viewplayer;
-extern UINT8 portalrender;
-extern sector_t *portalcullsector;
-extern line_t *portalclipline;
-extern INT32 portalclipstart, portalclipend;
+extern RENDERLOCAL sector_t *viewsector;
+extern RENDERLOCAL player_t *viewplayer;
+extern RENDERLOCAL UINT8 portalrender;
+extern RENDERLOCAL sector_t *portalcullsector;
+extern RENDERLOCAL line_t *portalclipline;
+extern RENDERLOCAL INT32 portalclipstart, portalclipend;
 
 extern consvar_t cv_allowmlook;
 extern consvar_t cv_maxportals;
@@ -108,10 +109,10 @@ extern angle_t doubleclipangle;
 extern INT32 viewangletox[FINEANGLES/2];
 extern angle_t xtoviewangle[MAXVIDWIDTH+1];
 
-extern fixed_t rw_distance;
-extern angle_t rw_normalangle;
+extern RENDERLOCAL fixed_t rw_distance;
+extern RENDERLOCAL angle_t rw_normalangle;
 
 // angle to line origin
-extern angle_t rw_angle1;
+extern RENDERLOCAL angle_t rw_angle1;
 
 #endif
@@ -29,7 +29,9 @@
 #include "dehacked.h" // get_number (for thok)
 #include "d_netfil.h" // blargh. for nameonly().
 #include "m_cheat.h" // objectplace
+#include "d_main.h" // D_StartupProfileBegin
 #include "k_kart.h" // SRB2kart
+#include "m_random.h" // M_RandomizedSeed
 #include "p_local.h" // stplyr
 #ifdef HWRENDER
 #include "hardware/hw_md2.h"
@@ -62,7 +64,7 @@ typedef struct
 //  which increases counter clockwise (protractor).
 // There was a lot of stuff grabbed wrong, so I changed it...
 //
-static lighttable_t **spritelights;
+static RENDERLOCAL lighttable_t **spritelights;
 
 // constant arrays used for psprite clipping and initializing clipping
 INT16 negonearray[MAXVIDWIDTH];
@@ -91,6 +93,7 @@ static const char *spritename;
 typedef struct drawseg_xrange_item_s
 {
 	INT16 x1, x2;
+	fixed_t scale; // nearest end, sprites further than this are in front
 	drawseg_t *user;
 } drawseg_xrange_item_t;
 
@@ -100,12 +103,17 @@ typedef struct drawsegs_xrange_s
 	INT32 count;
 } drawsegs_xrange_t;
 
-#define DS_RANGES_COUNT 3
-static drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
+// The screen is cut in halves, quarters, eighths and sixteenths, and each
+// piece lists the drawsegs that overlap it, in the same order as the whole.
+// A sprite uses the smallest piece it fits in. Piece k of level l is
+// drawsegs_xranges[(1<<l) - 1 + k]; level 0 is the whole screen.
+#define DS_RANGE_LEVELS 5
+#define DS_RANGES_COUNT ((1<<DS_RANGE_LEVELS) - 1)
+static RENDERLOCAL drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
 
-static drawseg_xrange_item_t *drawsegs_xrange;
-static size_t drawsegs_xrange_size = 0;
-static INT32 drawsegs_xrange_count = 0;
+static RENDERLOCAL drawseg_xrange_item_t *drawsegs_xrange;
+static RENDERLOCAL size_t drawsegs_xrange_size = 0;
+static RENDERLOCAL INT32 drawsegs_xrange_count = 0;
 
 // ==========================================================================
 //
@@ -218,6 +226,47 @@ static void R_InstallSpriteLump(UINT16 wad,            // graphics patch
 		sprtemp[frame].flip &= ~(1<<rotation);
 }
 
+//
+//  some checks to help development, on the maxframe frames in sprtemp
+//
+static void R_CheckSpriteFrames(const char *sprname)
+{
+	UINT8 frame;
+	UINT8 rotation;
+
+	for (frame = 0; frame < maxframe; frame++)
+	{
+		switch (sprtemp[frame].rotate)
+		{
+			case SRF_NONE:
+			// no rotations were found for that frame at all
+			I_Error("R_AddSingleSpriteDef: No patches found for %.4s frame %c", sprname, R_Frame2Char(frame));
+			break;
+
+			case SRF_SINGLE:
+			// only the first rotation is needed
+			break;
+
+			case SRF_2D: // both Left and Right rotations
+				// we test to see whether the left and right slots are present
+				if ((sprtemp[frame].lumppat[2] == LUMPERROR) || (sprtemp[frame].lumppat[6] == LUMPERROR))
+					I_Error("R_AddSingleSpriteDef: Sprite %s frame %c is missing rotations",
+					        sprname, R_Frame2Char(frame));
+			break;
+
+			default:
+			// must have all 8 frames
+			for (rotation = 0; rotation < 8; rotation++)
+				// we test the patch lump, or the id lump whatever
+				// if it was not loaded the two are LUMPERROR
+				if (sprtemp[frame].lumppat[rotation] == LUMPERROR)
+					I_Error("R_AddSingleSpriteDef: Sprite %.4s frame %c is missing rotations",
+					        sprname, R_Frame2Char(frame));
+			break;
+		}
+	}
+}
+
 // Install a single sprite, given its identifying name (4 chars)
 //
 // (originally part of R_AddSpriteDefs)
@@ -343,40 +392,7 @@ static boolean R_AddSingleSpriteDef(const char *sprname, spritedef_t *spritedef,
 
 	maxframe++;
 
-	//
-	//  some checks to help development
-	//
-	for (frame = 0; frame < maxframe; frame++)
-	{
-		switch (sprtemp[frame].rotate)
-		{
-			case SRF_NONE:
-			// no rotations were found for that frame at all
-			I_Error("R_AddSingleSpriteDef: No patches found for %.4s frame %c", sprname, R_Frame2Char(frame));
-			break;
-
-			case SRF_SINGLE:
-			// only the first rotation is needed
-			break;
-
-			case SRF_2D: // both Left and Right rotations
-				// we test to see whether the left and right slots are present
-				if ((sprtemp[frame].lumppat[2] == LUMPERROR) || (sprtemp[frame].lumppat[6] == LUMPERROR))
-					I_Error("R_AddSingleSpriteDef: Sprite %s frame %c is missing rotations",
-					        sprname, R_Frame2Char(frame));
-			break;
-
-			default:
-			// must have all 8 frames
-			for (rotation = 0; rotation < 8; rotation++)
-				// we test the patch lump, or the id lump whatever
-				// if it was not loaded the two are LUMPERROR
-				if (sprtemp[frame].lumppat[rotation] == LUMPERROR)
-					I_Error("R_AddSingleSpriteDef: Sprite %.4s frame %c is missing rotations",
-					        sprname, R_Frame2Char(frame));
-			break;
-		}
-	}
+	R_CheckSpriteFrames(sprname);
 
 	// allocate space for the frames present and copy sprtemp to it
 	if (spritedef->numframes &&             // has been allocated
@@ -397,6 +413,61 @@ static boolean R_AddSingleSpriteDef(const char *sprname, spritedef_t *spritedef,
 	return true;
 }
 
+//
+// How many frames R_AddSingleSpriteDef would give a new sprite, going
+// by the lump names alone. Nothing is read from the patches, but the
+// frames get the same checks, so a skin that's missing some is turned
+// away when it's added rather than the first time it's drawn.
+//
+static size_t R_CountSpriteFrames(const char *sprname, UINT16 wadnum, UINT16 startlump, UINT16 endlump)
+{
+	lumpinfo_t *lumpinfo = wadfiles[wadnum]->lumpinfo;
+	UINT8 frame;
+	UINT8 rotation;
+	UINT16 l;
+
+	memset(sprtemp,0xFF, sizeof (sprtemp));
+	maxframe = (size_t)-1;
+
+	if (endlump > wadfiles[wadnum]->numlumps)
+		endlump = wadfiles[wadnum]->numlumps;
+
+	for (l = startlump; l < endlump; l++)
+	{
+		if (memcmp(lumpinfo[l].name,sprname,4) != 0)
+			continue;
+
+		frame = R_Char2Frame(lumpinfo[l].name[4]);
+		rotation = (UINT8)(lumpinfo[l].name[5] - '0');
+		if (frame >= 64 || !(R_ValidSpriteAngle(rotation)))
+		{
+			CONS_Alert(CONS_WARNING, M_GetText("Bad sprite name: %s\n"), W_CheckNameForNumPwad(wadnum,l));
+			continue;
+		}
+
+		if (W_LumpLengthPwad(wadnum,l)<=8)
+			continue;
+
+		// no lumpid yet, spritecachedinfo is filled in when it's built
+		R_InstallSpriteLump(wadnum, l, 0, frame, rotation, 0);
+
+		if (lumpinfo[l].name[6])
+		{
+			frame = R_Char2Frame(lumpinfo[l].name[6]);
+			rotation = (UINT8)(lumpinfo[l].name[7] - '0');
+			R_InstallSpriteLump(wadnum, l, 0, frame, rotation, 1);
+		}
+	}
+
+	if (maxframe == (size_t)-1)
+		return 0;
+
+	maxframe++;
+	R_CheckSpriteFrames(sprname);
+
+	return maxframe;
+}
+
 //
 // Search for sprites replacements in a wad whose names are in namelist
 //
@@ -575,9 +646,9 @@ void R_DelSpriteDefs(UINT16 wadnum)
 //
 // GAME FUNCTIONS
 //
-UINT32 visspritecount;
-static UINT32 clippedvissprites;
-static vissprite_t *visspritechunks[MAXVISSPRITES >> VISSPRITECHUNKBITS] = {NULL};
+RENDERLOCAL UINT32 visspritecount;
+static RENDERLOCAL UINT32 clippedvissprites;
+static RENDERLOCAL vissprite_t *visspritechunks[MAXVISSPRITES >> VISSPRITECHUNKBITS] = {NULL};
 
 
 //
@@ -607,7 +678,11 @@ void R_InitSprites(void)
 
 	// find sprites in each -file added pwad
 	for (i = 0; i < numwadfiles; i++)
+	{
+		D_StartupProfileBegin("R_AddSpriteDefs", wadfiles[i]->filename, NULL);
 		R_AddSpriteDefs((UINT16)i);
+		D_StartupProfileEnd();
+	}
 
 	//
 	// now check for skins
@@ -616,7 +691,11 @@ void R_InitSprites(void)
 	// it can be is do before loading config for skin cvar possible value
 	R_InitSkins();
 	for (i = 0; i < numwadfiles; i++)
+	{
+		D_StartupProfileBegin("R_AddSkins", wadfiles[i]->filename, NULL);
 		R_AddSkins((UINT16)i);
+		D_StartupProfileEnd();
+	}
 
 	//
 	// check if all sprites have frames
@@ -637,10 +716,26 @@ void R_ClearSprites(void)
 	visspritecount = clippedvissprites = 0;
 }
 
+#ifdef PARALLELVIEWS
+//
+// R_FreeVisSpriteChunks
+// Called by a render thread before it exits, since the
+// chunks' user pointers go away with the thread.
+//
+void R_FreeVisSpriteChunks(void)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof (visspritechunks) / sizeof (visspritechunks[0]); i++)
+		if (visspritechunks[i])
+			Z_Free(visspritechunks[i]);
+}
+#endif
+
 //
 // R_NewVisSprite
 //
-static vissprite_t overflowsprite;
+static RENDERLOCAL vissprite_t overflowsprite;
 
 static vissprite_t *R_GetVisSprite(UINT32 num)
 {
@@ -667,11 +762,11 @@ static vissprite_t *R_NewVisSprite(void)
 // Masked means: partly transparent, i.e. stored
 //  in posts/runs of opaque pixels.
 //
-INT16 *mfloorclip;
-INT16 *mceilingclip;
+RENDERLOCAL INT16 *mfloorclip;
+RENDERLOCAL INT16 *mceilingclip;
 
-fixed_t spryscale = 0, sprtopscreen = 0, sprbotscreen = 0;
-fixed_t windowtop = 0, windowbottom = 0;
+RENDERLOCAL fixed_t spryscale = 0, sprtopscreen = 0, sprbotscreen = 0;
+RENDERLOCAL fixed_t windowtop = 0, windowbottom = 0;
 
 void R_DrawMaskedColumn(column_t *column)
 {
@@ -680,6 +775,9 @@ void R_DrawMaskedColumn(column_t *column)
 	fixed_t basetexturemid;
 	INT32 topdelta, prevdelta = 0;
 
+	if (dc_x < slicex1) // another thread's column, see R_RenderMaskedSegRange
+		return;
+
 	basetexturemid = dc_texturemid;
 
 	for (; column->topdelta != 0xff ;)
@@ -739,6 +837,9 @@ static void R_DrawFlippedMaskedColumn(column_t *column, INT32 texheight)
 	INT32 topdelta, prevdelta = -1;
 	UINT8 *d,*s;
 
+	if (dc_x < slicex1)
+		return;
+
 	for (; column->topdelta != 0xff ;)
 	{
 		// calculate unclipped screen coordinates
@@ -803,6 +904,7 @@ static void R_DrawVisSprite(vissprite_t *vis)
 	fixed_t frac;
 	patch_t *patch = W_CacheLumpNum(vis->patch, PU_CACHE);
 	fixed_t this_scale = vis->thingscale;
+	fixed_t scale = vis->scale, scalestep = vis->scalestep, xiscale = vis->xiscale;
 	INT32 x1, x2;
 	INT64 overflow_test;
 
@@ -898,51 +1000,57 @@ static void R_DrawVisSprite(vissprite_t *vis)
 		this_scale = FixedMul(this_scale, ((skin_t *)vis->mobj->skin)->highresscale);
 	if (this_scale <= 0)
 		this_scale = 1;
+	// Scaled here rather than in vis, other slices may be drawing it too
 	if (this_scale != FRACUNIT)
 	{
-		if (!vis->isScaled)
-		{
-			vis->scale = FixedMul(vis->scale, this_scale);
-			vis->scalestep = FixedMul(vis->scalestep, this_scale);
-			vis->xiscale = FixedDiv(vis->xiscale,this_scale);
-			vis->isScaled = true;
-		}
+		scale = FixedMul(scale, this_scale);
+		scalestep = FixedMul(scalestep, this_scale);
+		xiscale = FixedDiv(xiscale, this_scale);
 		dc_texturemid = FixedDiv(dc_texturemid,this_scale);
 	}
 
-	spryscale = vis->scale;
+	spryscale = scale;
 
-	if (!(vis->scalestep))
+	if (!scalestep)
 	{
 		sprtopscreen = centeryfrac - FixedMul(dc_texturemid, spryscale);
-		dc_iscale = FixedDiv(FRACUNIT, vis->scale);
+		dc_iscale = FixedDiv(FRACUNIT, scale);
 	}
 
 	x1 = vis->x1;
 	x2 = vis->x2;
 
-	if (vis->x1 < 0)
+	if (x1 < 0)
 	{
-		spryscale += vis->scalestep*(-vis->x1);
-		vis->x1 = 0;
+		spryscale += scalestep*(-x1);
+		x1 = 0;
 	}
 
-	if (vis->x2 >= vid.width)
-		vis->x2 = vid.width-1;
+	if (x2 >= vid.width)
+		x2 = vid.width-1;
 
 #if 1
 	// Something is occasionally setting 1px-wide sprites whose frac is exactly the width of the sprite, causing crashes due to
 	// accessing invalid column info. Until the cause is found, let's try to correct those manually...
 	{
-		fixed_t temp = ((frac + vis->xiscale*(vis->x2-vis->x1))>>FRACBITS) - SHORT(patch->width);
+		fixed_t temp = ((frac + xiscale*(x2-x1))>>FRACBITS) - SHORT(patch->width);
 		if (temp > 0)
-			vis->x2 -= temp;
+			x2 -= temp;
 	}
 #endif
 
-	for (dc_x = vis->x1; dc_x <= vis->x2; dc_x++, frac += vis->xiscale)
+	if (x1 < slicex1)
+	{
+		frac += xiscale*(slicex1 - x1);
+		spryscale += scalestep*(slicex1 - x1);
+		x1 = slicex1;
+	}
+	if (x2 > slicex2)
+		x2 = slicex2;
+
+	for (dc_x = x1; dc_x <= x2; dc_x++, frac += xiscale)
 	{
-		if (vis->scalestep) // currently papersprites only
+		if (scalestep) // currently papersprites only
 		{
 #ifndef RANGECHECK
 			if ((frac>>FRACBITS) < 0 || (frac>>FRACBITS) >= SHORT(patch->width)) // if this doesn't work i'm removing papersprites
@@ -950,7 +1058,7 @@ static void R_DrawVisSprite(vissprite_t *vis)
 #endif
 			sprtopscreen = (centeryfrac - FixedMul(dc_texturemid, spryscale));
 			dc_iscale = (0xffffffffu / (unsigned)spryscale);
-			spryscale += vis->scalestep;
+			spryscale += scalestep;
 		}
 #ifdef RANGECHECK
 		texturecolumn = frac>>FRACBITS;
@@ -969,9 +1077,6 @@ static void R_DrawVisSprite(vissprite_t *vis)
 
 	colfunc = basecolfunc;
 	dc_hires = 0;
-
-	vis->x1 = x1;
-	vis->x2 = x2;
 }
 
 // Special precipitation drawer Tails 08-18-2002
@@ -983,6 +1088,7 @@ static void R_DrawPrecipitationVisSprite(vissprite_t *vis)
 #endif
 	fixed_t frac;
 	patch_t *patch;
+	INT32 x1, x2;
 	INT64 overflow_test;
 
 	//Fab : R_InitSprites now sets a wad lump number
@@ -1014,13 +1120,24 @@ static void R_DrawPrecipitationVisSprite(vissprite_t *vis)
 	sprtopscreen = centeryfrac - FixedMul(dc_texturemid,spryscale);
 	windowtop = windowbottom = sprbotscreen = INT32_MAX;
 
-	if (vis->x1 < 0)
-		vis->x1 = 0;
+	x1 = vis->x1;
+	x2 = vis->x2;
+
+	if (x1 < 0)
+		x1 = 0;
+
+	if (x2 >= vid.width)
+		x2 = vid.width-1;
 
-	if (vis->x2 >= vid.width)
-		vis->x2 = vid.width-1;
+	if (x1 < slicex1)
+	{
+		frac += vis->xiscale*(slicex1 - x1);
+		x1 = slicex1;
+	}
+	if (x2 > slicex2)
+		x2 = slicex2;
 
-	for (dc_x = vis->x1; dc_x <= vis->x2; dc_x++, frac += vis->xiscale)
+	for (dc_x = x1; dc_x <= x2; dc_x++, frac += vis->xiscale)
 	{
 #ifdef RANGECHECK
 		texturecolumn = frac>>FRACBITS;
@@ -1218,6 +1335,7 @@ static void R_ProjectSprite(mobj_t *thing)
 	//Fab : 02-08-98: 'skin' override spritedef currently used for skin
 	if (thing->skin && thing->sprite == SPR_PLAY)
 	{
+		R_LoadSkinSprites(thing->skin);
 		sprdef = &((skin_t *)thing->skin)->spritedef;
 		if (rot >= sprdef->numframes)
 			sprdef = &sprites[thing->sprite];
@@ -1529,8 +1647,6 @@ static void R_ProjectSprite(mobj_t *thing)
 	else
 		vis->vflip = false;
 
-	vis->isScaled = false;
-
 	if (thing->subsector->sector->numlights)
 		R_SplitSprite(vis, thing);
 
@@ -1538,132 +1654,398 @@ static void R_ProjectSprite(mobj_t *thing)
 	++objectsdrawn;
 }
 
-static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
+//
+// PRECIPITATION
+// Weather is only for show, so none of it is in the playsim: every
+// blockmap cell that's under the sky gets one drop somewhere in it,
+// picked from precipseed, and how far along its fall each drop is gets
+// worked out every frame from the time and its sector's heights. The
+// drops are sorted by sector, see firstprecip and numprecip.
+//
+static fixed_t *precipx, *precipy;
+static UINT32 *precipphase; // where in its fall each drop starts out
+static UINT32 precipseed;
+static tic_t precipsplashtics; // how long rain splashes for, see R_SplashState
+
+static RENDERLOCAL precipdrop_t *precipbuf = NULL;
+static RENDERLOCAL size_t precipbufsize = 0;
+
+static inline UINT32 R_PrecipHash(UINT32 x)
 {
-	fixed_t tr_x, tr_y;
-	fixed_t gxt, gyt;
-	fixed_t tx, tz;
-	fixed_t xscale, yscale; //added : 02-02-98 : aaargll..if I were a math-guy!!!
+	x ^= x >> 16;
+	x *= 0x7feb352dU;
+	x ^= x >> 15;
+	x *= 0x846ca68bU;
+	x ^= x >> 16;
+	return x;
+}
 
-	INT32 x1, x2;
+// The splash state tics in, or the one splashes count up to when
+// tics is precipsplashtics. Stops short of S_RAINRETURN, which just
+// sends the drop back up.
+static state_t *R_SplashState(tic_t *tics)
+{
+	state_t *st = &states[S_SPLASH1];
+	INT32 i;
 
-	spritedef_t *sprdef;
-	spriteframe_t *sprframe;
-	size_t lump;
+	for (i = 0; i < 16 && st->tics > 0 && *tics >= (tic_t)st->tics; i++)
+	{
+		if (st->nextstate == S_RAINRETURN || st->nextstate == S_NULL)
+			break;
+		*tics -= st->tics;
+		st = &states[st->nextstate];
+	}
 
-	vissprite_t *vis;
+	return st;
+}
 
-	fixed_t iscale;
+//
+// R_SetupPrecipitation
+// Scatters the drops over the level. Done whatever the weather, since
+// it can change at any time.
+//
+void R_SetupPrecipitation(void)
+{
+	size_t numblocks = (size_t)bmapwidth * bmapheight;
+	fixed_t *tempx, *tempy;
+	UINT32 *tempphase;
+	size_t *tempsector;
+	size_t i, numdrops = 0;
+	sector_t *sec;
+	state_t *st;
+	tic_t tics;
+
+	for (i = 0; i < numsectors; i++)
+		sectors[i].firstprecip = sectors[i].numprecip = 0;
+	precipx = precipy = NULL;
+	precipphase = NULL;
+
+	if (dedicated || !numblocks)
+		return;
 
-	//SoM: 3/17/2000
-	fixed_t gz ,gzt;
+	tics = UINT32_MAX;
+	st = R_SplashState(&tics);
+	precipsplashtics = UINT32_MAX - tics + max(st->tics, 0);
 
-	// uncapped/interpolation
-	interpmobjstate_t interp = {0};
+	precipseed = M_RandomizedSeed();
 
-	// do interpolation
-	if (R_UsingFrameInterpolation() && !paused)
-	{
-		R_InterpolatePrecipMobjState(thing, rendertimefrac, &interp);
-	}
-	else
+	tempx = Z_Malloc(numblocks * (sizeof (*tempx) + sizeof (*tempy) + sizeof (*tempphase) + sizeof (*tempsector)), PU_STATIC, NULL);
+	tempy = tempx + numblocks;
+	tempphase = (UINT32 *)(tempy + numblocks);
+	tempsector = (size_t *)(tempphase + numblocks);
+
+	for (i = 0; i < numblocks; i++)
 	{
-		R_InterpolatePrecipMobjState(thing, FRACUNIT, &interp);
+		UINT32 hash = R_PrecipHash(precipseed + (UINT32)i*0x9e3779b9U);
+		fixed_t x = bmaporgx + (fixed_t)(i % bmapwidth) * MAPBLOCKSIZE + (fixed_t)(hash & 0xFFFF) * MAPBLOCKUNITS;
+		fixed_t y = bmaporgy + (fixed_t)(i / bmapwidth) * MAPBLOCKSIZE + (fixed_t)(hash >> 16) * MAPBLOCKUNITS;
+		subsector_t *ss = R_IsPointInSubsector(x, y);
+
+		// No sector? Move on to the next entry in the blockmap
+		if (!ss)
+			continue;
+
+		sec = ss->sector;
+
+		// Not in a sector with visible sky?
+		if (sec->ceilingpic != skyflatnum)
+			continue;
+
+		// Exists, but is too small for reasonable precipitation.
+		if (sec->floorheight > sec->ceilingheight - (32<<FRACBITS))
+			continue;
+
+		tempx[numdrops] = x;
+		tempy[numdrops] = y;
+		tempphase[numdrops] = R_PrecipHash(hash);
+		tempsector[numdrops] = sec - sectors;
+		sec->numprecip++;
+		numdrops++;
 	}
 
-	// transform the origin point
-	tr_x = interp.x - viewx;
-	tr_y = interp.y - viewy;
+	if (numdrops)
+	{
+		size_t first = 0;
 
-	gxt = FixedMul(tr_x, viewcos);
-	gyt = -FixedMul(tr_y, viewsin);
+		precipx = Z_Malloc(numdrops * sizeof (*precipx), PU_LEVEL, NULL);
+		precipy = Z_Malloc(numdrops * sizeof (*precipy), PU_LEVEL, NULL);
+		precipphase = Z_Malloc(numdrops * sizeof (*precipphase), PU_LEVEL, NULL);
 
-	tz = gxt - gyt;
+		for (i = 0; i < numsectors; i++)
+		{
+			sectors[i].firstprecip = first;
+			first += sectors[i].numprecip;
+			sectors[i].numprecip = 0;
+		}
 
-	// thing is behind view plane?
-	if (tz < MINZ)
-		return;
+		for (i = 0; i < numdrops; i++)
+		{
+			size_t j;
 
-	gxt = -FixedMul(tr_x, viewsin);
-	gyt = FixedMul(tr_y, viewcos);
-	tx = -(gyt + gxt);
+			sec = &sectors[tempsector[i]];
+			j = sec->firstprecip + sec->numprecip++;
+			precipx[j] = tempx[i];
+			precipy[j] = tempy[i];
+			precipphase[j] = tempphase[i];
+		}
+	}
 
-	// too far off the side?
-	if (abs(tx) > tz<<2)
-		return;
+	Z_Free(tempx);
+}
 
-	// aspect ratio stuff :
-	xscale = FixedDiv(projection, tz);
-	yscale = FixedDiv(projectiony, tz);
+// The frame a looping state is on tics into it
+static UINT32 R_PrecipFrame(const state_t *st, tic_t tics)
+{
+	if (!(st->frame & FF_ANIMATE) || st->var1 < 0 || st->var2 <= 0)
+		return st->frame;
+	return st->frame + (tics / st->var2) % (st->var1 + 1);
+}
 
-	// decide which patch to use for sprite relative to player
-#ifdef RANGECHECK
-	if ((unsigned)thing->sprite >= numsprites)
-		I_Error("R_ProjectPrecipitationSprite: invalid sprite number %d ",
-			thing->sprite);
-#endif
+// Works out the height and look of a drop at the given time. Returns
+// false if there's no room for it to fall.
+static boolean R_AnimatePrecipDrop(precipdrop_t *drop, INT64 time, boolean rain, boolean pit)
+{
+	const sector_t *sec = drop->sector;
+	const mobjinfo_t *info = &mobjinfo[rain ? MT_RAIN : MT_SNOWFLAKE];
+	fixed_t speed = abs(info->speed);
+	fixed_t floorz, basefloorz, ceilingz;
+	state_t *st = &states[info->spawnstate];
+	INT64 cycle, pos;
+	tic_t tics;
+	ffloor_t *rover;
 
-	sprdef = &sprites[thing->sprite];
+	floorz = basefloorz = sec->f_slope ? P_GetZAt(sec->f_slope, drop->x, drop->y) : sec->floorheight;
+	ceilingz = sec->c_slope ? P_GetZAt(sec->c_slope, drop->x, drop->y) : sec->ceilingheight;
 
-#ifdef RANGECHECK
-	if ((UINT8)(thing->frame&FF_FRAMEMASK) >= sprdef->numframes)
-		I_Error("R_ProjectPrecipitationSprite: invalid sprite frame %d : %d for %s",
-			thing->sprite, thing->frame, sprnames[thing->sprite]);
-#endif
+	for (rover = sec->ffloors; rover; rover = rover->next)
+	{
+		fixed_t topheight;
 
-	sprframe = &sprdef->spriteframes[thing->frame & FF_FRAMEMASK];
+		// If it exists, it'll get rained on.
+		if (!(rover->flags & FF_EXISTS))
+			continue;
 
-#ifdef PARANOIA
-	if (!sprframe)
-		I_Error("R_ProjectPrecipitationSprite: sprframes NULL for sprite %d\n", thing->sprite);
-#endif
+		if (!(rover->flags & FF_BLOCKOTHERS) && !(rover->flags & FF_SWIMMABLE))
+			continue;
 
-	// use single rotation for all views
-	lump = sprframe->lumpid[0];     //Fab: see note above
+		topheight = *rover->t_slope ? P_GetZAt(*rover->t_slope, drop->x, drop->y) : *rover->topheight;
+		if (topheight > floorz)
+			floorz = topheight;
+	}
 
-	// calculate edges of the shape
-	tx -= spritecachedinfo[lump].offset;
-	x1 = (centerxfrac + FixedMul (tx,xscale)) >>FRACBITS;
+	if (ceilingz <= floorz)
+		return false;
 
-	// off the right side?
-	if (x1 > viewwidth)
-		return;
+	// no splashes on sky or bottomless pits, but FOFs over them are fine
+	if (floorz != basefloorz)
+		pit = false;
 
-	tx += spritecachedinfo[lump].width;
-	x2 = ((centerxfrac + FixedMul (tx,xscale)) >>FRACBITS) - 1;
+	cycle = ceilingz - floorz;
+	if (rain && !pit)
+		cycle += (INT64)precipsplashtics * speed;
 
-	// off the left side
-	if (x2 < 0)
-		return;
+	pos = (((time * speed) >> FRACBITS) + (((INT64)drop->phase * cycle) >> 32)) % cycle;
+	if (pos < 0)
+		pos += cycle;
 
-	// PORTAL SPRITE CLIPPING
-	if (portalrender)
+	if (pos < ceilingz - floorz)
 	{
-		if (x2 < portalclipstart || x1 > portalclipend)
-			return;
+		drop->z = ceilingz - (fixed_t)pos;
+		tics = (tic_t)(time >> FRACBITS);
 
-		if (P_PointOnLineSide(interp.x, interp.y, portalclipline) != 0)
-			return;
-	}
+		if (!rain)
+		{
+			UINT8 look = (UINT8)(drop->phase >> 24);
 
-	// okay, we can't return now except for vertical clipping... this is a hack, but weather isn't networked, so it should be ok
-	if (!(thing->precipflags & PCF_THUNK))
+			if (look < 64)
+				st += 2;
+			else if (look < 144)
+				st++;
+		}
+	}
+	else
 	{
-		if (thing->precipflags & PCF_RAIN)
-			P_RainThinker(thing);
-		else
-			P_SnowThinker(thing);
-		thing->precipflags |= PCF_THUNK;
+		drop->z = floorz;
+		tics = (tic_t)((pos - (ceilingz - floorz)) / speed);
+		st = R_SplashState(&tics);
 	}
 
+	drop->sprite = st->sprite;
+	drop->frame = R_PrecipFrame(st, tics);
+	return true;
+}
 
-	//SoM: 3/17/2000: Disregard sprites that are out of view..
-	gzt = interp.z + spritecachedinfo[lump].topoffset;
-	gz = gzt - spritecachedinfo[lump].height;
+//
+// R_GatherPrecipitation
+// Finds the drops in a sector that are close enough and in front of the
+// view, and where they all are this frame. Returns how many there are.
+//
+size_t R_GatherPrecipitation(sector_t *sec, precipdrop_t **drops)
+{
+	const boolean rain = (curWeather == PRECIP_RAIN || curWeather == PRECIP_STORM || curWeather == PRECIP_STORM_NOSTRIKES);
+	const fixed_t limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS;
+	const size_t last = sec->firstprecip + sec->numprecip;
+	fixed_t tr_x, tr_y;
+	boolean pit;
+	INT64 time;
+	size_t i, count = 0, kept = 0;
 
-	if (thing->subsector->sector->cullheight)
+	*drops = precipbuf;
+
+	// no, no infinite draw distance for precipitation. this option at zero is supposed to turn it off
+	if (!sec->numprecip || !limit_dist || (!rain && curWeather != PRECIP_SNOW))
+		return 0;
+
+	if (precipbufsize < sec->numprecip)
 	{
-		if (R_DoCulling(thing->subsector->sector->cullheight, viewsector->cullheight, viewz, gz, gzt))
+		precipbufsize = sec->numprecip;
+		precipbuf = realloc(precipbuf, precipbufsize * sizeof (*precipbuf));
+		if (!precipbuf)
+			I_Error("R_GatherPrecipitation: No more free memory");
+		*drops = precipbuf;
+	}
+
+	// throw out everything too far away or behind the view first
+	for (i = sec->firstprecip; i < last; i++)
+	{
+		tr_x = precipx[i] - viewx;
+		tr_y = precipy[i] - viewy;
+
+		if (P_AproxDistance(tr_x, tr_y) > limit_dist
+			|| FixedMul(tr_x, viewcos) + FixedMul(tr_y, viewsin) < MINZ)
+			continue;
+
+		precipbuf[count].x = precipx[i];
+		precipbuf[count].y = precipy[i];
+		precipbuf[count].phase = precipphase[i];
+		count++;
+	}
+
+	if (!count)
+		return 0;
+
+	if (R_UsingFrameInterpolation() && !paused)
+		time = (INT64)leveltime * FRACUNIT - FRACUNIT + rendertimefrac;
+	else
+		time = (INT64)leveltime * FRACUNIT;
+
+	pit = (GETSECSPECIAL(sec->special, 1) == 7
+		|| GETSECSPECIAL(sec->special, 1) == 6
+		|| sec->floorpic == skyflatnum);
+
+	for (i = 0; i < count; i++)
+	{
+		precipbuf[kept] = precipbuf[i];
+		precipbuf[kept].sector = sec;
+		if (R_AnimatePrecipDrop(&precipbuf[kept], time, rain, pit))
+			kept++;
+	}
+
+	return kept;
+}
+
+static void R_ProjectPrecipitationSprite(const precipdrop_t *drop)
+{
+	fixed_t tr_x, tr_y;
+	fixed_t gxt, gyt;
+	fixed_t tx, tz;
+	fixed_t xscale, yscale; //added : 02-02-98 : aaargll..if I were a math-guy!!!
+
+	INT32 x1, x2;
+
+	spritedef_t *sprdef;
+	spriteframe_t *sprframe;
+	size_t lump;
+
+	vissprite_t *vis;
+
+	fixed_t iscale;
+
+	//SoM: 3/17/2000
+	fixed_t gz ,gzt;
+
+	// transform the origin point
+	tr_x = drop->x - viewx;
+	tr_y = drop->y - viewy;
+
+	gxt = FixedMul(tr_x, viewcos);
+	gyt = -FixedMul(tr_y, viewsin);
+
+	tz = gxt - gyt;
+
+	// thing is behind view plane?
+	if (tz < MINZ)
+		return;
+
+	gxt = -FixedMul(tr_x, viewsin);
+	gyt = FixedMul(tr_y, viewcos);
+	tx = -(gyt + gxt);
+
+	// too far off the side?
+	if (abs(tx) > tz<<2)
+		return;
+
+	// aspect ratio stuff :
+	xscale = FixedDiv(projection, tz);
+	yscale = FixedDiv(projectiony, tz);
+
+	// decide which patch to use for sprite relative to player
+#ifdef RANGECHECK
+	if ((unsigned)drop->sprite >= numsprites)
+		I_Error("R_ProjectPrecipitationSprite: invalid sprite number %d ",
+			drop->sprite);
+#endif
+
+	sprdef = &sprites[drop->sprite];
+
+#ifdef RANGECHECK
+	if ((UINT8)(drop->frame&FF_FRAMEMASK) >= sprdef->numframes)
+		I_Error("R_ProjectPrecipitationSprite: invalid sprite frame %d : %d for %s",
+			drop->sprite, drop->frame, sprnames[drop->sprite]);
+#endif
+
+	sprframe = &sprdef->spriteframes[drop->frame & FF_FRAMEMASK];
+
+#ifdef PARANOIA
+	if (!sprframe)
+		I_Error("R_ProjectPrecipitationSprite: sprframes NULL for sprite %d\n", drop->sprite);
+#endif
+
+	// use single rotation for all views
+	lump = sprframe->lumpid[0];     //Fab: see note above
+
+	// calculate edges of the shape
+	tx -= spritecachedinfo[lump].offset;
+	x1 = (centerxfrac + FixedMul (tx,xscale)) >>FRACBITS;
+
+	// off the right side?
+	if (x1 > viewwidth)
+		return;
+
+	tx += spritecachedinfo[lump].width;
+	x2 = ((centerxfrac + FixedMul (tx,xscale)) >>FRACBITS) - 1;
+
+	// off the left side
+	if (x2 < 0)
+		return;
+
+	// PORTAL SPRITE CLIPPING
+	if (portalrender)
+	{
+		if (x2 < portalclipstart || x1 > portalclipend)
+			return;
+
+		if (P_PointOnLineSide(drop->x, drop->y, portalclipline) != 0)
+			return;
+	}
+
+	//SoM: 3/17/2000: Disregard sprites that are out of view..
+	gzt = drop->z + spritecachedinfo[lump].topoffset;
+	gz = gzt - spritecachedinfo[lump].height;
+
+	if (drop->sector->cullheight)
+	{
+		if (R_DoCulling(drop->sector->cullheight, viewsector->cullheight, viewz, gz, gzt))
 			return;
 	}
 
@@ -1671,12 +2053,12 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis = R_NewVisSprite();
 	vis->scale = vis->sortscale = yscale; //<<detailshift;
 	vis->dispoffset = 0; // Monster Iestyn: 23/11/15
-	vis->gx = interp.x;
-	vis->gy = interp.y;
+	vis->gx = drop->x;
+	vis->gy = drop->y;
 	vis->gz = gz;
 	vis->gzt = gzt;
 	vis->thingheight = 4*FRACUNIT;
-	vis->pz = interp.z;
+	vis->pz = drop->z;
 	vis->pzt = vis->pz + vis->thingheight;
 	vis->texturemid = vis->gzt - viewz;
 	vis->scalestep = 0;
@@ -1694,7 +2076,7 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	}
 
 	vis->xscale = xscale; //SoM: 4/17/2000
-	vis->sector = thing->subsector->sector;
+	vis->sector = drop->sector;
 	vis->szt = (INT16)((centeryfrac - FixedMul(vis->gzt - viewz, yscale))>>FRACBITS);
 	vis->sz = (INT16)((centeryfrac - FixedMul(vis->gz - viewz, yscale))>>FRACBITS);
 
@@ -1703,7 +2085,7 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis->startfrac = 0;
 	vis->xiscale = iscale;
 
-	vis->thingscale = interp.scale;
+	vis->thingscale = FRACUNIT;
 
 	if (vis->x1 > x1)
 		vis->startfrac += vis->xiscale*(vis->x1-x1);
@@ -1713,21 +2095,20 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis->patch = sprframe->lumppat[0];
 
 	// specific translucency
-	if (thing->frame & FF_TRANSMASK)
-		vis->transmap = (thing->frame & FF_TRANSMASK) - 0x10000 + transtables;
+	if (drop->frame & FF_TRANSMASK)
+		vis->transmap = (drop->frame & FF_TRANSMASK) - 0x10000 + transtables;
 	else
 		vis->transmap = NULL;
 
 	vis->mobjflags = 0;
 	vis->cut = SC_NONE;
-	vis->extra_colormap = thing->subsector->sector->extra_colormap;
-	vis->heightsec = thing->subsector->sector->heightsec;
+	vis->extra_colormap = drop->sector->extra_colormap;
+	vis->heightsec = drop->sector->heightsec;
 
 	// Fullbright
 	vis->colormap = colormaps;
 	vis->precip = true;
 	vis->vflip = false;
-	vis->isScaled = false;
 }
 
 // R_AddSprites
@@ -1736,7 +2117,8 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 void R_AddSprites(sector_t *sec, INT32 lightlevel)
 {
 	mobj_t *thing;
-	precipmobj_t *precipthing; // Tails 08-25-2002
+	precipdrop_t *drops; // Tails 08-25-2002
+	size_t i, numdrops;
 	INT32 lightnum;
 	fixed_t approx_dist, limit_dist;
 
@@ -1750,11 +2132,11 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 	// A sector might have been split into several
 	//  subsectors during BSP building.
 	// Thus we check whether its already added.
-	if (sec->validcount == validcount)
+	if (sec->spritevalidcount[viewssnum] == validcount)
 		return;
 
 	// Well, now it will be done.
-	sec->validcount = validcount;
+	sec->spritevalidcount[viewssnum] = validcount;
 
 	if (!sec->numlights)
 	{
@@ -1856,112 +2238,327 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 		}
 	}
 
-	// no, no infinite draw distance for precipitation. this option at zero is supposed to turn it off
-	if ((limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS))
-	{
-		for (precipthing = sec->preciplist; precipthing; precipthing = precipthing->snext)
-		{
-			if (precipthing->precipflags & PCF_INVISIBLE)
-				continue;
-
-			approx_dist = P_AproxDistance(viewx-precipthing->x, viewy-precipthing->y);
-
-			if (approx_dist > limit_dist)
-				continue;
-
-			R_ProjectPrecipitationSprite(precipthing);
-		}
-	}
+	numdrops = R_GatherPrecipitation(sec, &drops);
+	for (i = 0; i < numdrops; i++)
+		R_ProjectPrecipitationSprite(&drops[i]);
 }
 
 //
 // R_SortVisSprites
 //
-static vissprite_t vsprsortedhead;
+static RENDERLOCAL vissprite_t vsprsortedhead;
+
+static RENDERLOCAL vissprite_t **vsprsortbuf = NULL;
+static RENDERLOCAL size_t vsprsortbufsize = 0;
+
+// Front to back: smaller scale first, then smaller dispoffset
+#define R_VisSpriteBefore(a, b) ((a)->sortscale < (b)->sortscale \
+	|| ((a)->sortscale == (b)->sortscale && (a)->dispoffset < (b)->dispoffset))
 
 void R_SortVisSprites(void)
 {
 	UINT32       i;
-	vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
-	vissprite_t *best = NULL;
-	vissprite_t  unsorted;
-	fixed_t      bestscale;
-	INT32        bestdispoffset;
+	size_t       width, lo, mid, hi, l, r, o;
+	vissprite_t **src, **dst, **swap, *ds;
 
 	if (!visspritecount)
 		return;
 
-	unsorted.next = unsorted.prev = &unsorted;
-
-	dsfirst = R_GetVisSprite(0);
-
-	// The first's prev and last's next will be set to
-	// nonsense, but are fixed in a moment
-	for (i = 0, dsnext = dsfirst, ds = NULL; i < visspritecount; i++)
+	if (vsprsortbufsize < 2*visspritecount)
 	{
-		dsprev = ds;
-		ds = dsnext;
-		if (i < visspritecount - 1) dsnext = R_GetVisSprite(i + 1);
-
-		ds->next = dsnext;
-		ds->prev = dsprev;
+		vsprsortbufsize = 2*visspritecount;
+		vsprsortbuf = realloc(vsprsortbuf, vsprsortbufsize * sizeof (*vsprsortbuf));
+		if (!vsprsortbuf)
+			I_Error("R_SortVisSprites: No more free memory");
 	}
 
-	// Fix first and last. ds still points to the last one after the loop
-	dsfirst->prev = &unsorted;
-	unsorted.next = dsfirst;
-	if (ds)
-		ds->next = &unsorted;
-	unsorted.prev = ds;
-
-	// pull the vissprites out by scale
-	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
+	src = vsprsortbuf;
+	dst = vsprsortbuf + visspritecount;
 	for (i = 0; i < visspritecount; i++)
+		src[i] = R_GetVisSprite(i);
+
+	// Bottom-up merge sort. Ties keep the order the sprites were
+	// projected in, same as the selection sort this replaced.
+	for (width = 1; width < visspritecount; width *= 2)
 	{
-		bestscale = bestdispoffset = INT32_MAX;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
+		for (lo = 0; lo < visspritecount; lo += 2*width)
 		{
-			if (ds->sortscale < bestscale)
+			mid = min(lo + width, visspritecount);
+			hi = min(lo + 2*width, visspritecount);
+			for (l = lo, r = mid, o = lo; o < hi; o++)
 			{
-				bestscale = ds->sortscale;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-			// order visprites of same scale by dispoffset, smallest first
-			else if (ds->sortscale == bestscale && ds->dispoffset < bestdispoffset)
-			{
-				bestdispoffset = ds->dispoffset;
-				best = ds;
+				if (l < mid && (r >= hi || !R_VisSpriteBefore(src[r], src[l])))
+					dst[o] = src[l++];
+				else
+					dst[o] = src[r++];
 			}
 		}
-		best->next->prev = best->prev;
-		best->prev->next = best->next;
-		best->next = &vsprsortedhead;
-		best->prev = vsprsortedhead.prev;
-		vsprsortedhead.prev->next = best;
-		vsprsortedhead.prev = best;
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
+	for (i = 0; i < visspritecount; i++)
+	{
+		ds = src[i];
+		ds->next = &vsprsortedhead;
+		ds->prev = vsprsortedhead.prev;
+		vsprsortedhead.prev->next = ds;
+		vsprsortedhead.prev = ds;
 	}
 }
 
+#undef R_VisSpriteBefore
+
 //
 // R_CreateDrawNodes
 // Creates and sorts a list of drawnodes for the scene being rendered.
 static drawnode_t *R_CreateDrawNode(drawnode_t *link);
 
-static drawnode_t nodebankhead;
-static drawnode_t nodehead;
+static RENDERLOCAL drawnode_t nodebankhead;
+static RENDERLOCAL drawnode_t nodehead;
+
+// Every node is also filed under the screen column bins it covers, in the
+// same order as the node list, so placing a sprite only has to look at
+// nodes it could overlap instead of walking the whole list.
+#define DRAWNODE_BINS 32
+
+static RENDERLOCAL drawnode_t **nodebins[DRAWNODE_BINS];
+static RENDERLOCAL size_t numnodebin[DRAWNODE_BINS], maxnodebin[DRAWNODE_BINS];
+static RENDERLOCAL INT32 nodebinshift;
+
+static INT32 R_NodeBin(INT32 x)
+{
+	if (x < 0)
+		x = 0;
+	else if (x >= viewwidth)
+		x = viewwidth - 1;
+	return x >> nodebinshift;
+}
+
+// Columns a node could be compared against a sprite over.
+// Swapped ends are kept as they are tested by overlap with the sprite.
+static void R_NodeBins(drawnode_t *node, INT32 *b1, INT32 *b2)
+{
+	INT32 x1, x2;
+
+	if (node->plane)
+		x1 = node->plane->minx, x2 = node->plane->maxx;
+	else if (node->thickseg)
+		x1 = node->thickseg->x1, x2 = node->thickseg->x2;
+	else if (node->seg)
+		x1 = node->seg->x1, x2 = node->seg->x2;
+	else
+		x1 = node->sprite->x1, x2 = node->sprite->x2;
+
+	*b1 = R_NodeBin(min(x1, x2));
+	*b2 = R_NodeBin(max(x1, x2));
+}
+
+static void R_BinDrawNode(drawnode_t *node)
+{
+	INT32 b, b1, b2;
+	size_t lo, hi, mid;
+
+	R_NodeBins(node, &b1, &b2);
+	for (b = b1; b <= b2; b++)
+	{
+		if (numnodebin[b] == maxnodebin[b])
+		{
+			maxnodebin[b] = maxnodebin[b] ? maxnodebin[b]*2 : 64;
+			nodebins[b] = realloc(nodebins[b], maxnodebin[b] * sizeof (*nodebins[b]));
+			if (!nodebins[b])
+				I_Error("R_BinDrawNode: No more free memory");
+		}
+
+		// binary search for where it goes in list order
+		lo = 0;
+		hi = numnodebin[b];
+		while (lo < hi)
+		{
+			mid = (lo + hi) / 2;
+			if (nodebins[b][mid]->order < node->order)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		memmove(&nodebins[b][lo + 1], &nodebins[b][lo], (numnodebin[b] - lo) * sizeof (*nodebins[b]));
+		nodebins[b][lo] = node;
+		numnodebin[b]++;
+	}
+}
+
+// Spread the list order out again when a gap runs out
+static void R_RenumberDrawNodes(void)
+{
+	drawnode_t *node;
+	UINT64 order = 0;
+
+	for (node = nodehead.next; node != &nodehead; node = node->next)
+		node->order = (order += (UINT64)1 << 32);
+}
+
+// Puts a sprite's node in front of another, or at the end if next is &nodehead
+static void R_InsertSpriteNode(vissprite_t *spr, drawnode_t *next)
+{
+	drawnode_t *entry = R_CreateDrawNode(next);
+	UINT64 before = (entry->prev == &nodehead) ? 0 : entry->prev->order;
+
+	entry->sprite = spr;
+	if (next == &nodehead)
+		entry->order = before + ((UINT64)1 << 32);
+	else
+	{
+		if (next->order - before < 2)
+			R_RenumberDrawNodes();
+		before = (entry->prev == &nodehead) ? 0 : entry->prev->order;
+		entry->order = before + (next->order - before)/2;
+	}
+	R_BinDrawNode(entry);
+}
+
+// Is the sprite hidden behind this node, and so has to be drawn before it?
+static boolean R_SpriteBehindNode(vissprite_t *rover, drawnode_t *r2, INT32 sintersect)
+{
+	INT32 i, x1, x2;
+	fixed_t scale;
+
+	if (r2->plane)
+	{
+		fixed_t planeobjectz, planecameraz;
+		if (r2->plane->minx > rover->x2 || r2->plane->maxx < rover->x1)
+			return false;
+		if (rover->szt > r2->plane->low || rover->sz < r2->plane->high)
+			return false;
+
+		// Effective height may be different for each comparison in the case of slopes
+		if (r2->plane->slope) {
+			planeobjectz = P_GetZAt(r2->plane->slope, rover->gx, rover->gy);
+			planecameraz = P_GetZAt(r2->plane->slope, viewx, viewy);
+		} else
+			planeobjectz = planecameraz = r2->plane->height;
+
+		if (rover->mobjflags & MF_NOCLIPHEIGHT)
+		{
+			//Objects with NOCLIPHEIGHT can appear halfway in.
+			if (planecameraz < viewz && rover->pz+(rover->thingheight/2) >= planeobjectz)
+				return false;
+			if (planecameraz > viewz && rover->pzt-(rover->thingheight/2) <= planeobjectz)
+				return false;
+		}
+		else
+		{
+			if (planecameraz < viewz && rover->pz >= planeobjectz)
+				return false;
+			if (planecameraz > viewz && rover->pzt <= planeobjectz)
+				return false;
+		}
+
+		// SoM: NOTE: Because a visplane's shape and scale is not directly
+		// bound to any single linedef, a simple poll of it's frontscale is
+		// not adequate. We must check the entire frontscale array for any
+		// part that is in front of the sprite.
+
+		x1 = rover->x1;
+		x2 = rover->x2;
+		if (x1 < r2->plane->minx) x1 = r2->plane->minx;
+		if (x2 > r2->plane->maxx) x2 = r2->plane->maxx;
+
+		if (r2->seg) // if no seg set, assume the whole thing is in front or something stupid
+		{
+			for (i = x1; i <= x2; i++)
+			{
+				if (r2->seg->frontscale[i] > rover->sortscale)
+					break;
+			}
+			if (i > x2)
+				return false;
+		}
+
+		return true;
+	}
+	else if (r2->thickseg)
+	{
+		fixed_t topplaneobjectz, topplanecameraz, botplaneobjectz, botplanecameraz;
+		if (rover->x1 > r2->thickseg->x2 || rover->x2 < r2->thickseg->x1)
+			return false;
+
+		scale = r2->thickseg->scale1 > r2->thickseg->scale2 ? r2->thickseg->scale1 : r2->thickseg->scale2;
+		if (scale <= rover->sortscale)
+			return false;
+		scale = r2->thickseg->scale1 + (r2->thickseg->scalestep * (sintersect - r2->thickseg->x1));
+		if (scale <= rover->sortscale)
+			return false;
+
+		if (*r2->ffloor->t_slope) {
+			topplaneobjectz = P_GetZAt(*r2->ffloor->t_slope, rover->gx, rover->gy);
+			topplanecameraz = P_GetZAt(*r2->ffloor->t_slope, viewx, viewy);
+		} else
+			topplaneobjectz = topplanecameraz = *r2->ffloor->topheight;
+
+		if (*r2->ffloor->b_slope) {
+			botplaneobjectz = P_GetZAt(*r2->ffloor->b_slope, rover->gx, rover->gy);
+			botplanecameraz = P_GetZAt(*r2->ffloor->b_slope, viewx, viewy);
+		} else
+			botplaneobjectz = botplanecameraz = *r2->ffloor->bottomheight;
+
+		return ((topplanecameraz > viewz && botplanecameraz < viewz) ||
+		    (topplanecameraz < viewz && rover->gzt < topplaneobjectz) ||
+		    (botplanecameraz > viewz && rover->gz > botplaneobjectz));
+	}
+	else if (r2->seg)
+	{
+#if 0 //#ifdef POLYOBJECTS_PLANES
+		if (r2->seg->curline->polyseg && rover->mobj && P_MobjInsidePolyobj(r2->seg->curline->polyseg, rover->mobj)) {
+			// Determine if we need to sort in front of the polyobj, based on the planes. This fixes the issue where
+			// polyobject planes render above the object standing on them. (A bit hacky... but it works.) -Red
+			mobj_t *mo = rover->mobj;
+			sector_t *po = r2->seg->curline->backsector;
+
+			if (po->ceilingheight < viewz && mo->z+mo->height > po->ceilingheight)
+				return false;
+
+			if (po->floorheight > viewz && mo->z < po->floorheight)
+				return false;
+		}
+#endif
+		if (rover->x1 > r2->seg->x2 || rover->x2 < r2->seg->x1)
+			return false;
+
+		scale = r2->seg->scale1 > r2->seg->scale2 ? r2->seg->scale1 : r2->seg->scale2;
+		if (scale <= rover->sortscale)
+			return false;
+		scale = r2->seg->scale1 + (r2->seg->scalestep * (sintersect - r2->seg->x1));
+
+		return (rover->sortscale < scale);
+	}
+	else if (r2->sprite)
+	{
+		if (r2->sprite->x1 > rover->x2 || r2->sprite->x2 < rover->x1)
+			return false;
+		if (r2->sprite->szt > rover->sz || r2->sprite->sz < rover->szt)
+			return false;
+
+		return (r2->sprite->sortscale > rover->sortscale
+		 || (r2->sprite->sortscale == rover->sortscale && r2->sprite->dispoffset > rover->dispoffset));
+	}
+
+	return false;
+}
 
 static void R_CreateDrawNodes(void)
 {
 	drawnode_t *entry;
 	drawseg_t *ds;
-	INT32 i, p, best, x1, x2;
+	INT32 i, p, best;
 	fixed_t bestdelta, delta;
 	vissprite_t *rover;
 	drawnode_t *r2;
 	visplane_t *plane;
 	INT32 sintersect;
-	fixed_t scale = 0;
+	INT32 b, b1, b2;
+	size_t cursor[DRAWNODE_BINS];
 
 	// Add the 3D floors, thicksides, and masked textures...
 	for (ds = ds_p; ds-- > drawsegs ;)
@@ -1976,8 +2573,8 @@ static void R_CreateDrawNodes(void)
 			}
 		}
 		// Check for a polyobject plane, but only if this is a front line
-		if (ds->curline->polyseg && ds->curline->polyseg->visplane && !ds->curline->side) {
-			plane = ds->curline->polyseg->visplane;
+		if (ds->curline->polyseg && ds->curline->polyseg->visplane[viewssnum] && !ds->curline->side) {
+			plane = ds->curline->polyseg->visplane[viewssnum];
 			R_PlaneBounds(plane);
 
 			if (plane->low < 0 || plane->high > vid.height || plane->high > plane->low)
@@ -1988,7 +2585,7 @@ static void R_CreateDrawNodes(void)
 				entry->plane = plane;
 				entry->seg = ds;
 			}
-			ds->curline->polyseg->visplane = NULL;
+			ds->curline->polyseg->visplane[viewssnum] = NULL;
 		}
 		if (ds->maskedtexturecol)
 		{
@@ -2039,25 +2636,35 @@ static void R_CreateDrawNodes(void)
 	// but it works getting them in for now
 	for (i = 0; i < numPolyObjects; i++)
 	{
-		if (!PolyObjects[i].visplane)
+		if (!PolyObjects[i].visplane[viewssnum])
 			continue;
-		plane = PolyObjects[i].visplane;
+		plane = PolyObjects[i].visplane[viewssnum];
 		R_PlaneBounds(plane);
 
 		if (plane->low < 0 || plane->high > vid.height || plane->high > plane->low)
 		{
-			PolyObjects[i].visplane = NULL;
+			PolyObjects[i].visplane[viewssnum] = NULL;
 			continue;
 		}
 		entry = R_CreateDrawNode(&nodehead);
 		entry->plane = plane;
 		// note: no seg is set, for what should be obvious reasons
-		PolyObjects[i].visplane = NULL;
+		PolyObjects[i].visplane[viewssnum] = NULL;
 	}
 
 	if (visspritecount == 0)
 		return;
 
+	// File what's there so far under the columns it covers
+	nodebinshift = 0;
+	while (((viewwidth - 1) >> nodebinshift) >= DRAWNODE_BINS)
+		nodebinshift++;
+	for (b = 0; b < DRAWNODE_BINS; b++)
+		numnodebin[b] = 0;
+	R_RenumberDrawNodes();
+	for (r2 = nodehead.next; r2 != &nodehead; r2 = r2->next)
+		R_BinDrawNode(r2);
+
 	R_SortVisSprites();
 	for (rover = vsprsortedhead.prev; rover != &vsprsortedhead; rover = rover->prev)
 	{
@@ -2066,158 +2673,32 @@ static void R_CreateDrawNodes(void)
 
 		sintersect = (rover->x1 + rover->x2) / 2;
 
-		for (r2 = nodehead.next; r2 != &nodehead; r2 = r2->next)
-		{
-			if (r2->plane)
-			{
-				fixed_t planeobjectz, planecameraz;
-				if (r2->plane->minx > rover->x2 || r2->plane->maxx < rover->x1)
-					continue;
-				if (rover->szt > r2->plane->low || rover->sz < r2->plane->high)
-					continue;
-
-				// Effective height may be different for each comparison in the case of slopes
-				if (r2->plane->slope) {
-					planeobjectz = P_GetZAt(r2->plane->slope, rover->gx, rover->gy);
-					planecameraz = P_GetZAt(r2->plane->slope, viewx, viewy);
-				} else
-					planeobjectz = planecameraz = r2->plane->height;
-
-				if (rover->mobjflags & MF_NOCLIPHEIGHT)
-				{
-					//Objects with NOCLIPHEIGHT can appear halfway in.
-					if (planecameraz < viewz && rover->pz+(rover->thingheight/2) >= planeobjectz)
-						continue;
-					if (planecameraz > viewz && rover->pzt-(rover->thingheight/2) <= planeobjectz)
-						continue;
-				}
-				else
-				{
-					if (planecameraz < viewz && rover->pz >= planeobjectz)
-						continue;
-					if (planecameraz > viewz && rover->pzt <= planeobjectz)
-						continue;
-				}
-
-				// SoM: NOTE: Because a visplane's shape and scale is not directly
-				// bound to any single linedef, a simple poll of it's frontscale is
-				// not adequate. We must check the entire frontscale array for any
-				// part that is in front of the sprite.
+		// Go through the nodes in the sprite's columns in list order,
+		// for the first one it's behind
+		b1 = R_NodeBin(min(rover->x1, rover->x2));
+		b2 = R_NodeBin(max(rover->x1, rover->x2));
+		for (b = b1; b <= b2; b++)
+			cursor[b] = 0;
 
-				x1 = rover->x1;
-				x2 = rover->x2;
-				if (x1 < r2->plane->minx) x1 = r2->plane->minx;
-				if (x2 > r2->plane->maxx) x2 = r2->plane->maxx;
-
-				if (r2->seg) // if no seg set, assume the whole thing is in front or something stupid
-				{
-					for (i = x1; i <= x2; i++)
-					{
-						if (r2->seg->frontscale[i] > rover->sortscale)
-							break;
-					}
-					if (i > x2)
-						continue;
-				}
+		for (;;)
+		{
+			r2 = &nodehead;
+			for (b = b1; b <= b2; b++)
+				if (cursor[b] < numnodebin[b] && (r2 == &nodehead || nodebins[b][cursor[b]]->order < r2->order))
+					r2 = nodebins[b][cursor[b]];
 
-				entry = R_CreateDrawNode(NULL);
-				(entry->prev = r2->prev)->next = entry;
-				(entry->next = r2)->prev = entry;
-				entry->sprite = rover;
+			if (r2 == &nodehead)
 				break;
-			}
-			else if (r2->thickseg)
-			{
-				fixed_t topplaneobjectz, topplanecameraz, botplaneobjectz, botplanecameraz;
-				if (rover->x1 > r2->thickseg->x2 || rover->x2 < r2->thickseg->x1)
-					continue;
-
-				scale = r2->thickseg->scale1 > r2->thickseg->scale2 ? r2->thickseg->scale1 : r2->thickseg->scale2;
-				if (scale <= rover->sortscale)
-					continue;
-				scale = r2->thickseg->scale1 + (r2->thickseg->scalestep * (sintersect - r2->thickseg->x1));
-				if (scale <= rover->sortscale)
-					continue;
-
-				if (*r2->ffloor->t_slope) {
-					topplaneobjectz = P_GetZAt(*r2->ffloor->t_slope, rover->gx, rover->gy);
-					topplanecameraz = P_GetZAt(*r2->ffloor->t_slope, viewx, viewy);
-				} else
-					topplaneobjectz = topplanecameraz = *r2->ffloor->topheight;
-
-				if (*r2->ffloor->b_slope) {
-					botplaneobjectz = P_GetZAt(*r2->ffloor->b_slope, rover->gx, rover->gy);
-					botplanecameraz = P_GetZAt(*r2->ffloor->b_slope, viewx, viewy);
-				} else
-					botplaneobjectz = botplanecameraz = *r2->ffloor->bottomheight;
-
-				if ((topplanecameraz > viewz && botplanecameraz < viewz) ||
-				    (topplanecameraz < viewz && rover->gzt < topplaneobjectz) ||
-				    (botplanecameraz > viewz && rover->gz > botplaneobjectz))
-				{
-					entry = R_CreateDrawNode(NULL);
-					(entry->prev = r2->prev)->next = entry;
-					(entry->next = r2)->prev = entry;
-					entry->sprite = rover;
-					break;
-				}
-			}
-			else if (r2->seg)
-			{
-#if 0 //#ifdef POLYOBJECTS_PLANES
-				if (r2->seg->curline->polyseg && rover->mobj && P_MobjInsidePolyobj(r2->seg->curline->polyseg, rover->mobj)) {
-					// Determine if we need to sort in front of the polyobj, based on the planes. This fixes the issue where
-					// polyobject planes render above the object standing on them. (A bit hacky... but it works.) -Red
-					mobj_t *mo = rover->mobj;
-					sector_t *po = r2->seg->curline->backsector;
-
-					if (po->ceilingheight < viewz && mo->z+mo->height > po->ceilingheight)
-						continue;
-
-					if (po->floorheight > viewz && mo->z < po->floorheight)
-						continue;
-				}
-#endif
-				if (rover->x1 > r2->seg->x2 || rover->x2 < r2->seg->x1)
-					continue;
 
-				scale = r2->seg->scale1 > r2->seg->scale2 ? r2->seg->scale1 : r2->seg->scale2;
-				if (scale <= rover->sortscale)
-					continue;
-				scale = r2->seg->scale1 + (r2->seg->scalestep * (sintersect - r2->seg->x1));
+			for (b = b1; b <= b2; b++)
+				if (cursor[b] < numnodebin[b] && nodebins[b][cursor[b]] == r2)
+					cursor[b]++;
 
-				if (rover->sortscale < scale)
-				{
-					entry = R_CreateDrawNode(NULL);
-					(entry->prev = r2->prev)->next = entry;
-					(entry->next = r2)->prev = entry;
-					entry->sprite = rover;
-					break;
-				}
-			}
-			else if (r2->sprite)
-			{
-				if (r2->sprite->x1 > rover->x2 || r2->sprite->x2 < rover->x1)
-					continue;
-				if (r2->sprite->szt > rover->sz || r2->sprite->sz < rover->szt)
-					continue;
-
-				if (r2->sprite->sortscale > rover->sortscale
-				 || (r2->sprite->sortscale == rover->sortscale && r2->sprite->dispoffset > rover->dispoffset))
-				{
-					entry = R_CreateDrawNode(NULL);
-					(entry->prev = r2->prev)->next = entry;
-					(entry->next = r2)->prev = entry;
-					entry->sprite = rover;
-					break;
-				}
-			}
-		}
-		if (r2 == &nodehead)
-		{
-			entry = R_CreateDrawNode(&nodehead);
-			entry->sprite = rover;
+			if (R_SpriteBehindNode(rover, r2, sintersect))
+				break;
 		}
+
+		R_InsertSpriteNode(rover, r2);
 	}
 }
 
@@ -2338,6 +2819,9 @@ void R_ClipVisSprite(vissprite_t *spr, INT32 x1, INT32 x2)
 				continue;
 			}
 
+			if (curr->scale < spr->sortscale)
+				continue; // behind the sprite
+
 			ds = curr->user;
 
 			if (ds->portalpass > 0 && ds->portalpass <= portalrender)
@@ -2487,12 +2971,15 @@ void R_ClipVisSprite(vissprite_t *spr, INT32 x1, INT32 x2)
 	}
 }
 
+// Which piece of the given level a screen column is in
+#define DS_RANGE_PIECE(x, level) ((x) <= 0 ? 0 : (x) >= viewwidth ? (1<<(level)) - 1 : ((x)<<(level)) / viewwidth)
+
 void R_ClipSprites(void)
 {
 	const size_t maxdrawsegs = ds_p - drawsegs;
-	const INT32 cx = viewwidth / 2;
 	drawseg_t* ds;
-	INT32 i;
+	drawseg_xrange_item_t item;
+	INT32 i, level, k, k1, k2;
 
 	// e6y
 	// Reducing of cache misses in the following R_DrawSprite()
@@ -2526,26 +3013,22 @@ void R_ClipSprites(void)
 	{
 		if (ds->silhouette || ds->maskedtexturecol)
 		{
-			drawsegs_xranges[0].items[drawsegs_xranges[0].count].x1 = ds->x1;
-			drawsegs_xranges[0].items[drawsegs_xranges[0].count].x2 = ds->x2;
-			drawsegs_xranges[0].items[drawsegs_xranges[0].count].user = ds;
+			item.x1 = ds->x1;
+			item.x2 = ds->x2;
+			item.scale = max(ds->scale1, ds->scale2);
+			item.user = ds;
 
 			// e6y: ~13% of speed improvement on sunder.wad map10
-			if (ds->x1 < cx)
+			for (level = 0; level < DS_RANGE_LEVELS; level++)
 			{
-				drawsegs_xranges[1].items[drawsegs_xranges[1].count] = 
-					drawsegs_xranges[0].items[drawsegs_xranges[0].count];
-				drawsegs_xranges[1].count++;
-			}
-
-			if (ds->x2 >= cx)
-			{
-				drawsegs_xranges[2].items[drawsegs_xranges[2].count] = 
-					drawsegs_xranges[0].items[drawsegs_xranges[0].count];
-				drawsegs_xranges[2].count++;
+				k1 = DS_RANGE_PIECE(min(ds->x1, ds->x2), level);
+				k2 = DS_RANGE_PIECE(max(ds->x1, ds->x2), level);
+				for (k = k1; k <= k2; k++)
+				{
+					drawsegs_xrange_t *range = &drawsegs_xranges[(1<<level) - 1 + k];
+					range->items[range->count++] = item;
+				}
 			}
-
-			drawsegs_xranges[0].count++;
 		}
 	}
 
@@ -2553,26 +3036,42 @@ void R_ClipSprites(void)
 	{
 		vissprite_t *spr = R_GetVisSprite(clippedvissprites);
 
-		if (spr->x2 < cx)
-		{
-			drawsegs_xrange = drawsegs_xranges[1].items;
-			drawsegs_xrange_count = drawsegs_xranges[1].count;
-		}
-		else if (spr->x1 >= cx)
-		{
-			drawsegs_xrange = drawsegs_xranges[2].items;
-			drawsegs_xrange_count = drawsegs_xranges[2].count;
-		}
-		else
-		{
-			drawsegs_xrange = drawsegs_xranges[0].items;
-			drawsegs_xrange_count = drawsegs_xranges[0].count;
-		}
+		for (level = DS_RANGE_LEVELS - 1; level > 0; level--)
+			if (DS_RANGE_PIECE(spr->x1, level) == DS_RANGE_PIECE(spr->x2, level))
+				break;
+
+		i = (1<<level) - 1 + DS_RANGE_PIECE(spr->x1, level);
+		drawsegs_xrange = drawsegs_xranges[i].items;
+		drawsegs_xrange_count = drawsegs_xranges[i].count;
 
 		R_ClipVisSprite(spr, spr->x1, spr->x2);
 	}
 }
 
+#undef DS_RANGE_PIECE
+
+// Draws whatever the node holds, returns false if there was nothing
+static boolean R_DrawMaskedNode(drawnode_t *r2)
+{
+	if (r2->plane)
+		R_DrawSinglePlane(r2->plane);
+	else if (r2->seg && r2->seg->maskedtexturecol != NULL)
+		R_RenderMaskedSegRange(r2->seg, r2->seg->x1, r2->seg->x2);
+	else if (r2->thickseg)
+		R_RenderThickSideRange(r2->thickseg, r2->thickseg->x1, r2->thickseg->x2, r2->ffloor);
+	else if (r2->sprite)
+	{
+		// Tails 08-18-2002
+		if (r2->sprite->precip == true)
+			R_DrawPrecipitationSprite(r2->sprite);
+		else
+			R_DrawSprite(r2->sprite);
+	}
+	else
+		return false;
+	return true;
+}
+
 //
 // R_DrawMasked
 //
@@ -2585,44 +3084,47 @@ void R_DrawMasked(void)
 
 	for (r2 = nodehead.next; r2 != &nodehead; r2 = r2->next)
 	{
-		if (r2->plane)
-		{
-			next = r2->prev;
-			R_DrawSinglePlane(r2->plane);
-			R_DoneWithNode(r2);
-			r2 = next;
-		}
-		else if (r2->seg && r2->seg->maskedtexturecol != NULL)
-		{
-			next = r2->prev;
-			R_RenderMaskedSegRange(r2->seg, r2->seg->x1, r2->seg->x2);
+		next = r2->prev;
+		if (!R_DrawMaskedNode(r2))
+			continue;
+		if (!r2->plane && r2->seg)
 			r2->seg->maskedtexturecol = NULL;
-			R_DoneWithNode(r2);
-			r2 = next;
-		}
-		else if (r2->thickseg)
-		{
-			next = r2->prev;
-			R_RenderThickSideRange(r2->thickseg, r2->thickseg->x1, r2->thickseg->x2, r2->ffloor);
-			R_DoneWithNode(r2);
-			r2 = next;
-		}
-		else if (r2->sprite)
-		{
-			next = r2->prev;
+		R_DoneWithNode(r2);
+		r2 = next;
+	}
+	R_ClearDrawNodes();
+}
 
-			// Tails 08-18-2002
-			if (r2->sprite->precip == true)
-				R_DrawPrecipitationSprite(r2->sprite);
-			else
-				R_DrawSprite(r2->sprite);
+#ifdef PARALLELVIEWS
+// The main thread's draw nodes, while every slice walks them
+static drawnode_t *slicenodes;
 
-			R_DoneWithNode(r2);
-			r2 = next;
-		}
-	}
+//
+// R_CreateSliceNodes
+// R_DrawMasked in three steps, for a view drawn in slices: the main thread
+// sorts everything once, each slice draws the lot clipped to its columns
+// with R_DrawSliceNodes, then the main thread puts the nodes back.
+//
+void R_CreateSliceNodes(void)
+{
+	R_CreateDrawNodes();
+	slicenodes = &nodehead;
+}
+
+void R_DrawSliceNodes(void)
+{
+	drawnode_t *r2;
+
+	for (r2 = slicenodes->next; r2 != slicenodes; r2 = r2->next)
+		R_DrawMaskedNode(r2);
+}
+
+void R_ClearSliceNodes(void)
+{
 	R_ClearDrawNodes();
+	slicenodes = NULL;
 }
+#endif
 
 // ==========================================================================
 //
@@ -2716,6 +3218,7 @@ void R_InitSkins(void)
 
 	skin->spritedef.numframes = sprites[SPR_PLAY].numframes;
 	skin->spritedef.spriteframes = sprites[SPR_PLAY].spriteframes;
+	skin->sprloaded = true;
 	ST_LoadFaceGraphics(skin->facerank, skin->facewant, skin->facemmap, 0);
 
 	// Set values for Sonic skin
@@ -2777,6 +3280,8 @@ void SetPlayerSkinByNum(INT32 playernum, INT32 skinnum)
 
 	if (skinnum >= 0 && skinnum < numskins) // Make sure it exists!
 	{
+		R_LoadSkinSprites(skin);
+
 		player->skin = skinnum;
 		if (player->mo)
 			player->mo->skin = skin;
@@ -3036,6 +3541,10 @@ next_token:
 		}
 		free(buf2);
 
+		// Only the frame count is worked out now, from the lump names;
+		// the frames themselves are built when the skin is first used,
+		// see R_LoadSkinSprites. Gameplay checks numframes, so it has to
+		// be right on every machine whatever they've drawn.
 		lump++; // if no sprite defined use spirte just after this one
 		if (skin->sprite[0] == '\0')
 		{
@@ -3045,8 +3554,9 @@ next_token:
 			lastlump = lump;
 			while (W_CheckNameForNumPwad(wadnum,lastlump) && memcmp(W_CheckNameForNumPwad(wadnum, lastlump),csprname,4)==0)
 				lastlump++;
-			// allocate (or replace) sprite frames, and set spritedef
-			R_AddSingleSpriteDef(csprname, &skin->spritedef, wadnum, lump, lastlump);
+			skin->sprstart = lump;
+			skin->sprend = lastlump;
+			skin->spritedef.numframes = R_CountSpriteFrames(csprname, wadnum, lump, lastlump);
 		}
 		else
 		{
@@ -3059,6 +3569,7 @@ next_token:
 				{
 					found = true;
 					skin->spritedef = sprites[name];
+					skin->sprloaded = true;
 				}
 
 			// not found so make a new one
@@ -3091,7 +3602,12 @@ next_token:
 					++localllump;
 				}
 
-				R_AddSingleSpriteDef(sprname, &skin->spritedef, wadnum, lstart, lend);
+				if (lstart != UINT16_MAX)
+				{
+					skin->sprstart = lstart;
+					skin->sprend = (lend == UINT16_MAX) ? localllump : lend;
+					skin->spritedef.numframes = R_CountSpriteFrames(sprname, wadnum, skin->sprstart, skin->sprend);
+				}
 			}
 
 			// I don't particularly care about skipping to the end of the used frames.
@@ -3125,7 +3641,93 @@ next_token:
 	return;
 }
 
+//
+// Build a skin's sprite frames the first time something needs them.
+// numframes is already set from R_AddSkins and comes out the same.
+// Main thread only: this grows spritecachedinfo, which the views read,
+// so R_RenderViewsParallel builds what it needs before starting them.
+//
+void R_LoadSkinSprites(skin_t *skin)
+{
+	const char *sprname;
+	size_t lumpsend = 0;
+
+	if (skin->sprloaded)
+		return;
+
+	if (skin->sprend > skin->sprstart)
+	{
+		sprname = skin->sprite[0] != '\0' ? skin->sprite : W_CheckNameForNumPwad(skin->wadnum, skin->sprstart);
+
+		// Built again after R_FlushSkinSprites, the patches go back into
+		// the spritecachedinfo entries they had the first time.
+		if (skin->sprlumpid)
+		{
+			lumpsend = numspritelumps;
+			numspritelumps = skin->sprlumpid;
+		}
+		else
+			skin->sprlumpid = numspritelumps;
+
+		skin->spritedef.numframes = 0; // nothing to patch over yet
+		R_AddSingleSpriteDef(sprname, &skin->spritedef, skin->wadnum, skin->sprstart, skin->sprend);
+
+		if (lumpsend)
+			numspritelumps = lumpsend;
+	}
+
+	skin->sprloaded = true;
+}
+
+//
+// Throw away the frames of skins nobody is playing as, and let go of
+// their patches so the zone can purge them. numframes stays for
+// gameplay; anything that draws these skins again builds them again.
+//
+void R_FlushSkinSprites(void)
+{
+	INT32 i, j;
+	size_t f;
+
+	for (i = 1; i < numskins; i++)
+	{
+		spritedef_t *sprdef = &skins[i].spritedef;
+
+		// skins sharing a normal sprite's frames never own them
+		if (!skins[i].sprloaded || skins[i].sprend <= skins[i].sprstart || !sprdef->spriteframes)
+			continue;
+
+		for (j = 0; j < MAXPLAYERS; j++)
+			if (playeringame[j] && players[j].skin == i)
+				break;
+		if (j < MAXPLAYERS)
+			continue;
+
+		for (f = 0; f < sprdef->numframes; f++)
+			for (j = 0; j < 8; j++)
+				if (sprdef->spriteframes[f].lumppat[j] != LUMPERROR)
+					W_UnlockCachedPatchNum(sprdef->spriteframes[f].lumppat[j]);
+
+		Z_Free(sprdef->spriteframes);
+		sprdef->spriteframes = NULL;
+		skins[i].sprloaded = false;
+	}
+}
+
 #ifdef DELFILE
+static void R_UnloadSkinSprites(skin_t *skin)
+{
+	// skins sharing a normal sprite's frames never own them
+	if (!skin->sprloaded || skin->sprend <= skin->sprstart)
+		return;
+
+	if (skin->spritedef.spriteframes)
+		Z_Free(skin->spritedef.spriteframes);
+	skin->spritedef.spriteframes = NULL;
+	skin->spritedef.numframes = 0;
+	skin->sprloaded = false;
+}
+
 void R_DelSkins(UINT16 wadnum)
 {
 	UINT16 lump, lastlump = 0;
@@ -3135,37 +3737,8 @@ void R_DelSkins(UINT16 wadnum)
 			break;
 		numskins--;
 		ST_UnLoadFaceGraphics(numskins); // only used by DELFILE
-		if (skins[numskins].sprite[0] != '\0')
-		{
-			const char *csprname = W_CheckNameForNumPwad(wadnum, lump);
-
-			// skip to end of this skin's frames
-			lastlump = lump;
-			while (W_CheckNameForNumPwad(wadnum,lastlump) && memcmp(W_CheckNameForNumPwad(wadnum, lastlump),csprname,4)==0)
-				lastlump++;
-			// allocate (or replace) sprite frames, and set spritedef
-			R_DelSingleSpriteDef(csprname, &skins[numskins].spritedef, wadnum, lump, lastlump);
-		}
-		else
-		{
-			// search in the normal sprite tables
-			size_t name;
-			boolean found = false;
-			const char *sprname = skins[numskins].sprite;
-			for (name = 0;sprnames[name][0] != '\0';name++)
-				if (strcmp(sprnames[name], sprname) == 0)
-				{
-					found = true;
-					skins[numskins].spritedef = sprites[name];
-				}
-
-			// not found so make a new one
-			if (!found)
-				R_DelSingleSpriteDef(sprname, &skins[numskins].spritedef, wadnum, 0, INT16_MAX);
-
-			while (W_CheckNameForNumPwad(wadnum,lastlump) && memcmp(W_CheckNameForNumPwad(wadnum, lastlump),sprname,4)==0)
-				lastlump++;
-		}
+		R_UnloadSkinSprites(&skins[numskins]);
+		lastlump = lump + 1;
 		CONS_Printf(M_GetText("Removed skin '%s'\n"), skins[numskins].name);
 	}
 }
@@ -35,13 +35,13 @@ extern INT16 negonearray[MAXVIDWIDTH];
 extern INT16 screenheightarray[MAXVIDWIDTH];
 
 // vars for R_DrawMaskedColumn
-extern INT16 *mfloorclip;
-extern INT16 *mceilingclip;
-extern fixed_t spryscale;
-extern fixed_t sprtopscreen;
-extern fixed_t sprbotscreen;
-extern fixed_t windowtop;
-extern fixed_t windowbottom;
+extern RENDERLOCAL INT16 *mfloorclip;
+extern RENDERLOCAL INT16 *mceilingclip;
+extern RENDERLOCAL fixed_t spryscale;
+extern RENDERLOCAL fixed_t sprtopscreen;
+extern RENDERLOCAL fixed_t sprbotscreen;
+extern RENDERLOCAL fixed_t windowtop;
+extern RENDERLOCAL fixed_t windowbottom;
 
 void R_DrawMaskedColumn(column_t *column);
 void R_SortVisSprites(void);
@@ -54,11 +54,32 @@ void R_AddSpriteDefs(UINT16 wadnum);
 void R_DelSpriteDefs(UINT16 wadnum);
 #endif
 
+// A precipitation drop as it is this frame, see R_SetupPrecipitation
+typedef struct
+{
+	fixed_t x, y, z;
+	sector_t *sector;
+	UINT32 phase;
+	spritenum_t sprite;
+	UINT32 frame;
+} precipdrop_t;
+
+void R_SetupPrecipitation(void);
+size_t R_GatherPrecipitation(sector_t *sec, precipdrop_t **drops);
+
 //SoM: 6/5/2000: Light sprites correctly!
 void R_AddSprites(sector_t *sec, INT32 lightlevel);
 void R_InitSprites(void);
 void R_ClearSprites(void);
+#ifdef PARALLELVIEWS
+void R_FreeVisSpriteChunks(void);
+#endif
 void R_DrawMasked(void);
+#ifdef PARALLELVIEWS
+void R_CreateSliceNodes(void);
+void R_DrawSliceNodes(void);
+void R_ClearSliceNodes(void);
+#endif
 
 // -----------
 // SKINS STUFF
@@ -73,8 +94,11 @@ void R_DrawMasked(void);
 typedef struct
 {
 	char name[SKINNAMESIZE+1]; // INT16 descriptive name of the skin
-	spritedef_t spritedef;
+	spritedef_t spritedef; // numframes is always set, spriteframes only after R_LoadSkinSprites
 	UINT16 wadnum;
+	UINT16 sprstart, sprend; // lumps in wadnum holding the skin's own frames
+	size_t sprlumpid; // its first spritecachedinfo entry once built, 0 before
+	boolean sprloaded;
 	char sprite[4]; // Sprite name, if seperated from S_SKIN.
 	skinflags_t flags;
 
@@ -156,13 +180,12 @@ typedef struct vissprite_s
 
 	boolean precip;
 	boolean vflip; // Flip vertically
-	boolean isScaled;
 	INT32 dispoffset; // copy of info->dispoffset, affects ordering but not drawing
 
 	fixed_t thingscale;
 } vissprite_t;
 
-extern UINT32 visspritecount;
+extern RENDERLOCAL UINT32 visspritecount;
 
 void R_ClipSprites(void);
 void R_ClipVisSprite(vissprite_t *spr, INT32 x1, INT32 x2);
@@ -183,6 +206,8 @@ typedef struct drawnode_s
 	ffloor_t *ffloor;
 	vissprite_t *sprite;
 
+	UINT64 order; // position in the list, for sorting sprites in
+
 	struct drawnode_s *next;
 	struct drawnode_s *prev;
 } drawnode_t;
@@ -194,6 +219,8 @@ boolean SetPlayerSkin(INT32 playernum,const char *skinname);
 void SetPlayerSkinByNum(INT32 playernum,INT32 skinnum); // Tails 03-16-2002
 INT32 R_SkinAvailable(const char *name);
 void R_AddSkins(UINT16 wadnum);
+void R_LoadSkinSprites(skin_t *skin);
+void R_FlushSkinSprites(void);
 
 #ifdef DELFILE
 void R_DelSkins(UINT16 wadnum);
@@ -41,14 +41,16 @@
 // assembly or c drawer routines for 8bpp/16bpp
 // --------------------------------------------
 void (*wallcolfunc)(void); // new wall column drawer to draw posts >128 high
-void (*colfunc)(void); // standard column, up to 128 high posts
+RENDERLOCAL void (*colfunc)(void); // standard column, up to 128 high posts
 
 void (*basecolfunc)(void);
 void (*fuzzcolfunc)(void); // standard fuzzy effect column drawer
 void (*transcolfunc)(void); // translation column drawer
 void (*shadecolfunc)(void); // smokie test..
-void (*spanfunc)(void); // span drawer, use a 64x64 tile
+RENDERLOCAL void (*spanfunc)(void); // span drawer, use a 64x64 tile
 void (*splatfunc)(void); // span drawer w/ transparency
+void (*transspanfunc)(void); // translucent span drawer
+void (*tiltedspanfunc)(void); // span drawer for slopes
 void (*basespanfunc)(void); // default span func for color mode
 void (*transtransfunc)(void); // translucent translated column drawer
 void (*twosmultipatchfunc)(void); // for cols with transparent pixels
@@ -102,6 +104,7 @@ boolean R_SSE = false;
 boolean R_3DNow = false;
 boolean R_MMXExt = false;
 boolean R_SSE2 = false;
+boolean R_AVX2 = false;
 
 
 void SCR_SetMode(void)
@@ -123,6 +126,8 @@ void SCR_SetMode(void)
 	{
 		spanfunc = basespanfunc = R_DrawSpan_8;
 		splatfunc = R_DrawSplat_8;
+		transspanfunc = R_DrawTranslucentSpan_8;
+		tiltedspanfunc = R_DrawTiltedSpan_8;
 		transcolfunc = R_DrawTranslatedColumn_8;
 		transtransfunc = R_DrawTranslatedTranslucentColumn_8;
 
@@ -153,6 +158,26 @@ void SCR_SetMode(void)
 				twosmultipatchfunc = R_Draw2sMultiPatchColumn_8_ASM;
 			}
 		}
+#endif
+#ifdef SIMDDRAW
+		if (R_ASM && R_AVX2)
+		{
+			colfunc = basecolfunc = R_DrawColumn_8_AVX2;
+			fuzzcolfunc = R_DrawTranslucentColumn_8_AVX2;
+			walldrawerfunc = R_DrawColumn_8_AVX2;
+			spanfunc = basespanfunc = R_DrawSpan_8_AVX2;
+			transspanfunc = R_DrawTranslucentSpan_8_AVX2;
+			tiltedspanfunc = R_DrawTiltedSpan_8_AVX2;
+		}
+		else if (R_ASM && R_SSE2)
+		{
+			colfunc = basecolfunc = R_DrawColumn_8_SSE2;
+			fuzzcolfunc = R_DrawTranslucentColumn_8_SSE2;
+			walldrawerfunc = R_DrawColumn_8_SSE2;
+			spanfunc = basespanfunc = R_DrawSpan_8_SSE2;
+			transspanfunc = R_DrawTranslucentSpan_8_SSE2;
+			tiltedspanfunc = R_DrawTiltedSpan_8_SSE2;
+		}
 #endif
 	}
 /*	else if (vid.bpp > 1)
@@ -199,8 +224,13 @@ void SCR_Startup(void)
 			R_SSE = true;
 		if (RCpuInfo->SSE2)
 			R_SSE2 = true;
-		CONS_Printf("CPU Info: 486: %i, 586: %i, MMX: %i, 3DNow: %i, MMXExt: %i, SSE2: %i\n", R_486, R_586, R_MMX, R_3DNow, R_MMXExt, R_SSE2);
+		if (RCpuInfo->AVX2)
+			R_AVX2 = true;
+		CONS_Printf("CPU Info: 486: %i, 586: %i, MMX: %i, 3DNow: %i, MMXExt: %i, SSE2: %i, AVX2: %i\n", R_486, R_586, R_MMX, R_3DNow, R_MMXExt, R_SSE2, R_AVX2);
 	}
+#if defined (__x86_64__) || defined (_M_X64)
+	R_SSE2 = true; // every x86-64 CPU has it
+#endif
 
 	if (M_CheckParm("-noASM"))
 		R_ASM = false;
@@ -223,6 +253,11 @@ void SCR_Startup(void)
 	if (M_CheckParm("-SSE2"))
 		R_SSE2 = true;
 
+	if (M_CheckParm("-AVX2"))
+		R_AVX2 = true;
+	if (M_CheckParm("-noAVX2"))
+		R_AVX2 = false;
+
 	M_SetupMemcpy();
 
 	if (dedicated)
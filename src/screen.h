@@ -126,14 +126,16 @@ extern vmode_t specialmodes[NUMSPECIALMODES];
 // ---------------------------------------------
 
 extern void (*wallcolfunc)(void);
-extern void (*colfunc)(void);
+extern RENDERLOCAL void (*colfunc)(void);
 extern void (*basecolfunc)(void);
 extern void (*fuzzcolfunc)(void);
 extern void (*transcolfunc)(void);
 extern void (*shadecolfunc)(void);
-extern void (*spanfunc)(void);
+extern RENDERLOCAL void (*spanfunc)(void);
 extern void (*basespanfunc)(void);
 extern void (*splatfunc)(void);
+extern void (*transspanfunc)(void);
+extern void (*tiltedspanfunc)(void);
 extern void (*transtransfunc)(void);
 extern void (*twosmultipatchfunc)(void);
 extern void (*twosmultipatchtransfunc)(void);
@@ -148,6 +150,7 @@ extern boolean R_MMX;
 extern boolean R_3DNow;
 extern boolean R_MMXExt;
 extern boolean R_SSE2;
+extern boolean R_AVX2;
 
 // ----------------
 // screen variables
@@ -3946,6 +3946,9 @@ const CPUInfoFlags *I_CPUInfo(void)
 		WIN_CPUInfo.AMD3DNow    = SDL_Has3DNow();
 		WIN_CPUInfo.SSE         = SDL_HasSSE();
 		WIN_CPUInfo.SSE2        = SDL_HasSSE2();
+#if SDL_VERSION_ATLEAST(2,0,4)
+		WIN_CPUInfo.AVX2        = SDL_HasAVX2();
+#endif
 		WIN_CPUInfo.AltiVec     = SDL_HasAltiVec();
 	}
 	WIN_CPUInfo.MMXExt      = SDL_FALSE; //SDL_HasMMXExt(); No longer in SDL2
@@ -3966,6 +3969,9 @@ const CPUInfoFlags *I_CPUInfo(void)
 	SDL_CPUInfo.AMD3DNowExt = SDL_FALSE; //SDL_Has3DNowExt(); No longer in SDL2
 	SDL_CPUInfo.SSE         = SDL_HasSSE();
 	SDL_CPUInfo.SSE2        = SDL_HasSSE2();
+#if SDL_VERSION_ATLEAST(2,0,4)
+	SDL_CPUInfo.AVX2        = SDL_HasAVX2();
+#endif
 	SDL_CPUInfo.AltiVec     = SDL_HasAltiVec();
 	return &SDL_CPUInfo;
 #else
@@ -155,7 +155,7 @@ Worker (
 	return 0;
 }
 
-void
+int
 I_spawn_thread (
 		const char  * name,
 		I_thread_fn   entry,
@@ -163,6 +163,7 @@ I_spawn_thread (
 ){
 	Link   link;
 	Thread th;
+	int    started = 0;
 
 	th = malloc(sizeof *th);
 
@@ -186,9 +187,13 @@ I_spawn_thread (
 
 			if (! th->thread)
 				abort();
+
+			started = 1;
 		}
 	}
 	I_unlock_mutex(i_thread_pool_mutex);
+
+	return started;
 }
 
 int
@@ -218,6 +223,7 @@ I_stop_threads (void)
 {
 	Link        link;
 	Link        next;
+	Link        threads;
 
 	Thread      th;
 	SDL_mutex * mutex;
@@ -228,24 +234,29 @@ I_stop_threads (void)
 		/* rely on the good will of thread-san */
 		SDL_AtomicSet(&i_threads_running, 0);
 
+		/* take the list, but don't hold the lock while waiting:
+		   a thread that's finishing may still want it */
 		I_lock_mutex(&i_thread_pool_mutex);
 		{
-			for (
-					link = i_thread_pool;
-					link;
-					link = next
-			){
-				next = link->next;
-				th   = link->data;
-
-				SDL_WaitThread(th->thread, NULL);
-
-				free(th);
-				free(link);
-			}
+			threads       = i_thread_pool;
+			i_thread_pool = NULL;
 		}
 		I_unlock_mutex(i_thread_pool_mutex);
 
+		for (
+				link = threads;
+				link;
+				link = next
+		){
+			next = link->next;
+			th   = link->data;
+
+			SDL_WaitThread(th->thread, NULL);
+
+			free(th);
+			free(link);
+		}
+
 		for (
 				link = i_mutex_pool;
 				link;
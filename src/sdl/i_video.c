@@ -72,7 +72,13 @@
 #include "../i_video.h"
 #include "../console.h"
 #include "../command.h"
+#include "../m_misc.h"
+#include "../r_draw.h" // SIMDDRAW
 #include "sdlmain.h"
+
+#ifdef SIMDDRAW
+#include <immintrin.h>
+#endif
 #include "../i_system.h"
 #ifdef HWRENDER
 #include "../hardware/hw_main.h"
@@ -106,6 +112,7 @@ static void Impl_SetVsync(void);
 // synchronize page flipping with screen refresh
 consvar_t cv_vidwait = {"vid_wait", "Off", CV_SAVE|CV_CALL|CV_NOINIT, CV_OnOff, Impl_SetVsync, 0, NULL, NULL, 0, 0, NULL};
 static consvar_t cv_stretch = {"stretch", "Off", CV_SAVE|CV_NOSHOWHELP, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+static consvar_t cv_dirtyrows = {"vid_dirtyrows", "On", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
 UINT8 graphics_started = 0; // Is used in console.c and screen.c
 
@@ -150,6 +157,25 @@ static SDL_Texture  *texture;
 static SDL_bool      havefocus = SDL_TRUE;
 static const char *fallback_resolution_name = "Fallback";
 
+// -headless: SDL's video subsystem is never started. The software renderer
+// draws into vid.buffer as always, and I_FinishUpdate only hands finished
+// frames to -dumpframes <dir>, if that was given. For timing the renderer
+// (with -timedemo) on machines without a display or a GPU.
+static SDL_bool headless = SDL_FALSE;
+static INT32 headlesswidth = BASEVIDWIDTH, headlessheight = BASEVIDHEIGHT;
+static const char *dumpframedir = NULL;
+static UINT32 dumpframenum = 0;
+
+// Software mode frames are expanded from screens[0] straight into the
+// streaming texture, with palettemap (the palette in the texture's pixel
+// format) and expandrow. With vid_dirtyrows, rows that are the same as in
+// lastframe are left alone, so a still menu costs next to nothing.
+static Uint32 palettemap[256];
+static void (*expandrow)(void *dest, const UINT8 *source, INT32 count);
+static UINT8 *lastframe = NULL;
+static size_t lastframesize = 0;
+static SDL_bool framestale = SDL_TRUE; // redo the whole texture next time
+
 // windowed video modes from which to choose from.
 static INT32 windowedModes[MAXWINMODES][2] =
 {
@@ -175,6 +201,7 @@ static INT32 windowedModes[MAXWINMODES][2] =
 
 static void Impl_VideoSetupSDLBuffer(void);
 static void Impl_VideoSetupBuffer(void);
+static void Impl_MapPalette(void);
 static SDL_bool Impl_CreateWindow(SDL_bool fullscreen);
 //static void Impl_SetWindowName(const char *title);
 static void Impl_SetWindowIcon(void);
@@ -256,6 +283,7 @@ static void SDLSetMode(INT32 width, INT32 height, SDL_bool fullscreen)
 		}
 
 		texture = SDL_CreateTexture(renderer, sw_texture_format, SDL_TEXTUREACCESS_STREAMING, width, height);
+		Impl_MapPalette();
 
 		// Set up SW surface
 		if (vidSurface != NULL)
@@ -1406,6 +1434,199 @@ static inline boolean I_SkipFrame(void)
 #endif
 }
 
+//
+// Impl_DumpFrame
+// Writes screens[0] out for -dumpframes: PNG when we have it, PPM otherwise.
+//
+static void Impl_DumpFrame(void)
+{
+	UINT8 palette[768];
+	const char *filename;
+	boolean ok;
+	INT32 i;
+
+	for (i = 0; i < 256; i++)
+	{
+		palette[i*3] = localPalette[i].r;
+		palette[i*3+1] = localPalette[i].g;
+		palette[i*3+2] = localPalette[i].b;
+	}
+
+#ifdef HAVE_PNG
+	filename = va("%s"PATHSEP"frame%06u.png", dumpframedir, dumpframenum);
+	ok = M_SavePNG(filename, screens[0], vid.width, vid.height, palette);
+#else
+	{
+		UINT8 *row = malloc(vid.width*3);
+		const UINT8 *src = screens[0];
+		FILE *f = NULL;
+		INT32 x, y;
+
+		filename = va("%s"PATHSEP"frame%06u.ppm", dumpframedir, dumpframenum);
+		ok = (row && (f = fopen(filename, "wb")) != NULL);
+		if (ok)
+		{
+			fprintf(f, "P6\n%d %d\n255\n", vid.width, vid.height);
+			for (y = 0; y < vid.height && ok; y++, src += vid.rowbytes)
+			{
+				for (x = 0; x < vid.width; x++)
+					M_Memcpy(&row[x*3], &palette[src[x]*3], 3);
+				ok = (fwrite(row, 3, vid.width, f) == (size_t)vid.width);
+			}
+			if (fclose(f))
+				ok = false;
+		}
+		free(row);
+	}
+#endif
+
+	if (!ok)
+	{
+		CONS_Alert(CONS_ERROR, "Couldn't write frame %s, no longer dumping frames\n", filename);
+		dumpframedir = NULL;
+		return;
+	}
+	dumpframenum++;
+}
+
+static void Impl_ExpandRow16(void *dest, const UINT8 *source, INT32 count)
+{
+	Uint16 *d = dest;
+	while (count--)
+		*d++ = (Uint16)palettemap[*source++];
+}
+
+static void Impl_ExpandRow32(void *dest, const UINT8 *source, INT32 count)
+{
+	Uint32 *d = dest;
+	while (count--)
+		*d++ = palettemap[*source++];
+}
+
+#ifdef SIMDDRAW
+// Eight palette lookups per gather. SSE2 has no gather, and doing the
+// lookups one at a time and packing them is no faster than the loops above.
+static __attribute__((target("avx2"))) void Impl_ExpandRow16_AVX2(void *dest, const UINT8 *source, INT32 count)
+{
+	Uint16 *d = dest;
+	const int *map = (const int *)palettemap;
+
+	for (; count >= 16; count -= 16, source += 16, d += 16)
+	{
+		const __m256i lo = _mm256_i32gather_epi32(map, _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)source)), 4);
+		const __m256i hi = _mm256_i32gather_epi32(map, _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(source + 8))), 4);
+		// packus works within 128-bit lanes, so put the quarters back in order
+		_mm256_storeu_si256((__m256i *)d, _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8));
+	}
+	Impl_ExpandRow16(d, source, count);
+}
+
+static __attribute__((target("avx2"))) void Impl_ExpandRow32_AVX2(void *dest, const UINT8 *source, INT32 count)
+{
+	Uint32 *d = dest;
+	const int *map = (const int *)palettemap;
+
+	for (; count >= 8; count -= 8, source += 8, d += 8)
+		_mm256_storeu_si256((__m256i *)d,
+			_mm256_i32gather_epi32(map, _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)source)), 4));
+	Impl_ExpandRow32(d, source, count);
+}
+#endif
+
+//
+// Impl_MapPalette
+// Puts localPalette in the texture's pixel format, and picks expandrow
+// for it. Leaves expandrow NULL for formats we don't do.
+//
+static void Impl_MapPalette(void)
+{
+	SDL_PixelFormat *format;
+	Uint32 formatenum;
+	int i;
+
+	expandrow = NULL;
+	framestale = SDL_TRUE;
+
+	if (!texture || SDL_QueryTexture(texture, &formatenum, NULL, NULL, NULL) < 0
+	|| (format = SDL_AllocFormat(formatenum)) == NULL)
+		return;
+
+	for (i = 0; i < 256; i++)
+		palettemap[i] = SDL_MapRGB(format, localPalette[i].r, localPalette[i].g, localPalette[i].b);
+
+	if (format->BytesPerPixel == 2)
+		expandrow = Impl_ExpandRow16;
+	else if (format->BytesPerPixel == 4)
+		expandrow = Impl_ExpandRow32;
+#ifdef SIMDDRAW
+	if (expandrow && R_AVX2)
+		expandrow = (format->BytesPerPixel == 2) ? Impl_ExpandRow16_AVX2 : Impl_ExpandRow32_AVX2;
+#endif
+
+	SDL_FreeFormat(format);
+}
+
+//
+// Impl_ExpandFrame
+// Writes screens[0] into the texture, only the rows that changed if it
+// can. Returns false if the texture has to be filled the slow way.
+//
+static SDL_bool Impl_ExpandFrame(void)
+{
+	const UINT8 *source = screens[0];
+	const size_t width = vid.width;
+	INT32 top = 0, bottom = vid.height; // rows [top, bottom) get redone
+	SDL_Rect rect;
+	UINT8 *pixels;
+	int pitch;
+	INT32 y;
+
+	if (!expandrow)
+		return SDL_FALSE;
+
+	if (cv_dirtyrows.value && lastframesize != width*vid.height)
+	{
+		free(lastframe);
+		lastframesize = width*vid.height;
+		if ((lastframe = malloc(lastframesize)) == NULL)
+			lastframesize = 0;
+		framestale = SDL_TRUE;
+	}
+
+	if (cv_dirtyrows.value && lastframe && !framestale)
+	{
+		while (top < bottom && !memcmp(source + top*vid.rowbytes, lastframe + top*width, width))
+			top++;
+		while (bottom > top && !memcmp(source + (bottom-1)*vid.rowbytes, lastframe + (bottom-1)*width, width))
+			bottom--;
+		if (top == bottom)
+			return SDL_TRUE; // the texture's still right
+	}
+
+	rect.x = 0;
+	rect.y = top;
+	rect.w = vid.width;
+	rect.h = bottom - top;
+	if (SDL_LockTexture(texture, &rect, (void **)&pixels, &pitch) < 0)
+	{
+		framestale = SDL_TRUE;
+		return SDL_FALSE;
+	}
+	for (y = top; y < bottom; y++, pixels += pitch)
+		expandrow(pixels, source + y*vid.rowbytes, vid.width);
+	SDL_UnlockTexture(texture);
+
+	if (cv_dirtyrows.value && lastframe)
+	{
+		for (y = top; y < bottom; y++)
+			M_Memcpy(lastframe + y*width, source + y*vid.rowbytes, width);
+		framestale = SDL_FALSE;
+	}
+	else
+		framestale = SDL_TRUE; // lastframe wasn't kept up
+	return SDL_TRUE;
+}
+
 //
 // I_FinishUpdate
 //
@@ -1432,20 +1653,30 @@ void I_FinishUpdate(void)
 		ST_AskToJoinEnvelope();
 #endif
 
+	if (headless)
+	{
+		if (dumpframedir && screens[0])
+			Impl_DumpFrame();
+		return;
+	}
+
 	if (rendermode == render_soft && screens[0])
 	{
-		if (!bufSurface) //Double-Check
+		if (!Impl_ExpandFrame()) // texture format we can't write, go through SDL
 		{
-			Impl_VideoSetupSDLBuffer();
-		}
+			if (!bufSurface) //Double-Check
+			{
+				Impl_VideoSetupSDLBuffer();
+			}
 
-		if (bufSurface)
-		{
-			SDL_BlitSurface(bufSurface, &src_rect, vidSurface, &src_rect);
-			// Fury -- there's no way around UpdateTexture, the GL backend uses it anyway
-			SDL_LockSurface(vidSurface);
-			SDL_UpdateTexture(texture, &src_rect, vidSurface->pixels, vidSurface->pitch);
-			SDL_UnlockSurface(vidSurface);
+			if (bufSurface)
+			{
+				SDL_BlitSurface(bufSurface, &src_rect, vidSurface, &src_rect);
+				// Fury -- there's no way around UpdateTexture, the GL backend uses it anyway
+				SDL_LockSurface(vidSurface);
+				SDL_UpdateTexture(texture, &src_rect, vidSurface->pixels, vidSurface->pitch);
+				SDL_UnlockSurface(vidSurface);
+			}
 		}
 
 		SDL_RenderClear(renderer);
@@ -1502,11 +1733,14 @@ void I_SetPalette(RGBA_t *palette)
 	//if (vidSurface) SDL_SetPaletteColors(vidSurface->format->palette, localPalette, 0, 256);
 	// Fury -- SDL2 vidSurface is a 32-bit surface buffer copied to the texture. It's not palletized, like bufSurface.
 	if (bufSurface) SDL_SetPaletteColors(bufSurface->format->palette, localPalette, 0, 256);
+	Impl_MapPalette();
 }
 
 // return number of fullscreen + X11 modes
 INT32 VID_NumModes(void)
 {
+	if (headless)
+		return 1; // whatever VID_GetModeForSize was last asked for
 	if (USE_FULLSCREEN && numVidModes != -1)
 		return numVidModes - firstEntry;
 	else
@@ -1529,6 +1763,11 @@ const char *VID_GetModeName(INT32 modeNum)
 	else // windowed modes
 	{
 #endif
+	if (headless)
+	{
+		sprintf(&vidModeName[0][0], "%dx%d", headlesswidth, headlessheight);
+		return &vidModeName[0][0];
+	}
 	if (modeNum == -1)
 	{
 		return fallback_resolution_name;
@@ -1546,6 +1785,12 @@ const char *VID_GetModeName(INT32 modeNum)
 INT32 VID_GetModeForSize(INT32 w, INT32 h)
 {
 	int i;
+	if (headless) // any size will do, there's no window to fit
+	{
+		headlesswidth = min(max(w, BASEVIDWIDTH), MAXVIDWIDTH);
+		headlessheight = min(max(h, BASEVIDHEIGHT), MAXVIDHEIGHT);
+		return 0;
+	}
 	for (i = 0; i < MAXWINMODES; i++)
 	{
 		if (windowedModes[i][0] == w && windowedModes[i][1] == h)
@@ -1676,6 +1921,17 @@ static UINT32 VID_GetRefreshRate(void)
 
 INT32 VID_SetMode(INT32 modeNum)
 {
+	if (headless)
+	{
+		vid.recalc = 1;
+		vid.bpp = 1;
+		vid.width = headlesswidth;
+		vid.height = headlessheight;
+		vid.modenum = 0;
+		Impl_VideoSetupBuffer();
+		return SDL_TRUE;
+	}
+
 	SDLdoUngrabMouse();
 
 	vid.recalc = 1;
@@ -1887,11 +2143,27 @@ void I_StartupGraphics(void)
 	COM_AddCommand ("vid_mode", VID_Command_Mode_f);
 	CV_RegisterVar (&cv_vidwait);
 	CV_RegisterVar (&cv_stretch);
+	CV_RegisterVar (&cv_dirtyrows);
 	disable_mouse = M_CheckParm("-nomouse");
 	disable_fullscreen = M_CheckParm("-win") ? 1 : 0;
 
 	keyboard_started = true;
 
+	if (M_CheckParm("-headless"))
+	{
+		headless = SDL_TRUE;
+		disable_mouse = SDL_TRUE;
+		rendermode = render_soft;
+		if (M_CheckParm("-dumpframes") && M_IsNextParm())
+			dumpframedir = M_GetNextParm();
+
+		VID_SetMode(VID_GetModeForSize(BASEVIDWIDTH, BASEVIDHEIGHT));
+		vid.WndParent = NULL;
+		CONS_Printf("Running headless, %dx%d\n", vid.width, vid.height);
+		graphics_started = true;
+		return;
+	}
+
 #if !defined(HAVE_TTF)
 	// Previously audio was init here for questionable reasons?
 	if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0)
@@ -48,7 +48,7 @@
 
 #include "r_fps.h"
 
-UINT16 objectsdrawn = 0;
+RENDERLOCAL UINT16 objectsdrawn = 0;
 
 //
 // STATUS BAR DATA
@@ -638,6 +638,17 @@ static void ST_drawDebugInfo(void)
 		height -= 32;
 	}
 
+	if (cv_debug & DBG_RENDER && rendermode == render_soft)
+	{
+		const UINT32 chain10 = planestats.lookups ? planestats.steps*10/planestats.lookups : 0;
+
+		V_DrawRightAlignedString(320, height - 16, V_MONOSPACE, va("Planes: %5u", planestats.planes));
+		V_DrawRightAlignedString(320, height - 8,  V_MONOSPACE, va("Chain: %2u.%u/%3u", chain10/10, chain10%10, planestats.longestchain));
+		V_DrawRightAlignedString(320, height,      V_MONOSPACE, va("Splits: %5u", planestats.splits));
+
+		height -= 32;
+	}
+
 	if (cv_debug & DBG_MEMORY)
 		V_DrawRightAlignedString(320, height,     V_MONOSPACE, va("Heap used: %7sKB", sizeu1(Z_TagsUsage(0, INT32_MAX)>>10)));
 }
@@ -1760,7 +1771,7 @@ static void ST_doItemFinderIconsAndSound(void) // SRB2kart - unused.
 {
 	INT32 emblems[16];
 	thinker_t *th;
-	mobj_t *mo2;
+	mobj_t *mo2, *next;
 
 	UINT8 stemblems = 0, stunfound = 0;
 	INT32 i;
@@ -1785,29 +1796,22 @@ static void ST_doItemFinderIconsAndSound(void) // SRB2kart - unused.
 		return;
 
 	// Scan thinkers to find emblem mobj with these ids
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	P_ForEachMobjOfType(mo2, next, MT_EMBLEM)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (!(mo2->flags & MF_SPECIAL))
 			continue;
-		mo2 = (mobj_t *)th;
 
-		if (mo2->type == MT_EMBLEM)
+		for (i = 0; i < stemblems; ++i)
 		{
-			if (!(mo2->flags & MF_SPECIAL))
-				continue;
-
-			for (i = 0; i < stemblems; ++i)
+			if (mo2->health == emblems[i]+1)
 			{
-				if (mo2->health == emblems[i]+1)
-				{
-					soffset = (i * 20) - ((stemblems-1) * 10);
+				soffset = (i * 20) - ((stemblems-1) * 10);
 
-					newinterval = ST_drawEmeraldHuntIcon(mo2, itemhoming, soffset);
-					if (newinterval && (!interval || newinterval < interval))
-						interval = newinterval;
+				newinterval = ST_drawEmeraldHuntIcon(mo2, itemhoming, soffset);
+				if (newinterval && (!interval || newinterval < interval))
+					interval = newinterval;
 
-					break;
-				}
+				break;
 			}
 		}
 	}
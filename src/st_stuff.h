@@ -131,6 +131,6 @@ typedef enum
 
 extern hudinfo_t hudinfo[NUMHUDITEMS];
 
-extern UINT16 objectsdrawn;
+extern RENDERLOCAL UINT16 objectsdrawn;
 
 #endif
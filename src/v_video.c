@@ -676,9 +676,14 @@ void V_DrawContinueIcon(INT32 x, INT32 y, INT32 flags, INT32 skinnum, UINT8 skin
 		V_DrawScaledPatch(x - 10, y - 14, flags, W_CachePatchName("CONTINS", PU_CACHE)); // Draw a star
 	else
 	{ // Find front angle of the first waiting frame of the character's actual sprites
-		spriteframe_t *sprframe = &skins[skinnum].spritedef.spriteframes[2 & FF_FRAMEMASK];
-		patch_t *patch = W_CachePatchNum(sprframe->lumppat[0], PU_CACHE);
-		const UINT8 *colormap = R_GetTranslationColormap(skinnum, skincolor, GTC_CACHE);
+		spriteframe_t *sprframe;
+		patch_t *patch;
+		const UINT8 *colormap;
+
+		R_LoadSkinSprites(&skins[skinnum]);
+		sprframe = &skins[skinnum].spritedef.spriteframes[2 & FF_FRAMEMASK];
+		patch = W_CachePatchNum(sprframe->lumppat[0], PU_CACHE);
+		colormap = R_GetTranslationColormap(skinnum, skincolor, GTC_CACHE);
 
 		// No variant for translucency
 		V_DrawTinyMappedPatch(x, y, flags, patch, colormap);
@@ -33,6 +33,14 @@
 #include <unistd.h>
 #endif
 
+#include <sys/stat.h>
+#include <time.h>
+
+#if defined (UNIXCOMMON) && !defined (__CYGWIN__)
+#define HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #define ZWAD
 
 #ifdef ZWAD
@@ -63,12 +71,14 @@
 #include "d_clisrv.h"
 #include "r_defs.h"
 #include "i_system.h"
+#include "i_threads.h"
 #include "md5.h"
 #include "lua_script.h"
 #ifdef SCANTHINGS
 #include "p_setup.h" // P_ScanThings
 #endif
 #include "m_misc.h" // M_MapNumber
+#include "m_argv.h" // M_CheckParm
 
 #ifdef HWRENDER
 #include "r_data.h"
@@ -111,6 +121,14 @@ static UINT16 lumpnumcacheindex = 0;
 UINT16 numwadfiles = 0; // number of active wadfiles
 wadfile_t *wadfiles[MAX_WADFILES]; // 0 to numwadfiles-1 are valid
 
+static void W_MapFile(wadfile_t *wadfile);
+static void W_UnmapFile(wadfile_t *wadfile);
+static void W_BuildNameIndex(wadfile_t *wadfile);
+static void W_FreeNameIndex(wadfile_t *wadfile);
+#ifdef HAVE_ZLIB
+static void W_FlushInflateCache(UINT16 wad);
+#endif
+
 // W_Shutdown
 // Closes all of the WAD files before quitting
 // If not done on a Mac then open wad files
@@ -122,6 +140,11 @@ void W_Shutdown(void)
 	{
 		wadfile_t *wad = wadfiles[numwadfiles];
 
+#ifdef HAVE_ZLIB
+		W_FlushInflateCache(numwadfiles);
+#endif
+		W_UnmapFile(wad);
+		W_FreeNameIndex(wad);
 		if (wad->handle)
 			fclose(wad->handle);
 		Z_Free(wad->filename);
@@ -282,7 +305,329 @@ static inline void W_LoadDehackedLumps(UINT16 wadnum)
 #endif
 }
 
+// ==========================================================================
+// File MD5s
+// ==========================================================================
+//
+// With a big addon list, hashing files is most of what startup does. Sums
+// are remembered in srb2home/md5cache.txt against each file's path, size
+// and modification time, so only files that changed get hashed again
+// (-nomd5cache ignores it). New sums only mark the cache dirty; the file is
+// rewritten whole once the files being loaded are all in, one line per
+// path, leaving out files that have since gone away or changed. Modification times only go down to the second, so a
+// file touched within the last second is never trusted to the cache.
+// W_HashFiles hashes a whole list at once, spread across a few threads.
+
+#ifndef NOMD5
+#define MD5CACHE_FILE "md5cache.txt"
+#define MD5HASH_THREADS 4
+
+typedef struct md5cache_s
+{
+	char *path;
+	unsigned long size, mtime;
+	UINT8 md5sum[16];
+	struct md5cache_s *next;
+} md5cache_t;
+
+static md5cache_t *md5cache = NULL;
+static boolean md5cacheloaded = false, md5cacheenabled = false;
+static boolean md5cachedirty = false; // something new to write out
+static boolean md5cachebatch = false; // W_InitMultipleFiles saves at the end
+
+static md5cache_t *W_FindCachedMD5(const char *path)
+{
+	md5cache_t *mc;
+	for (mc = md5cache; mc; mc = mc->next)
+		if (!strcmp(mc->path, path))
+			return mc;
+	return NULL;
+}
+
+// Whether a file was last written long enough ago that its size and
+// mtime will show any later change to it.
+static boolean W_MD5Settled(const struct stat *st)
+{
+	return (time(NULL) - st->st_mtime > 1);
+}
+
+// Remembers a sum in memory; W_SaveMD5Cache puts it on disk.
+static void W_CacheMD5(const char *path, const struct stat *st, const UINT8 *md5sum)
+{
+	md5cache_t *mc = W_FindCachedMD5(path);
+
+	if (!mc)
+	{
+		mc = Z_Malloc(sizeof *mc, PU_STATIC, NULL);
+		mc->path = Z_StrDup(path);
+		mc->next = md5cache;
+		md5cache = mc;
+	}
+	mc->size = (unsigned long)st->st_size;
+	mc->mtime = (unsigned long)st->st_mtime;
+	M_Memcpy(mc->md5sum, md5sum, 16);
+}
+
+// Writes the cache out again from scratch, through a temporary file so a
+// crash halfway through doesn't lose it.
+static void W_SaveMD5Cache(void)
+{
+	char path[MAX_WADPATH], temppath[MAX_WADPATH+4];
+	md5cache_t *mc;
+	FILE *f;
+	INT32 i;
+
+	if (!md5cacheenabled || !md5cachedirty)
+		return;
+	md5cachedirty = false;
+
+	snprintf(path, sizeof path, "%s"PATHSEP"%s", srb2home, MD5CACHE_FILE);
+	snprintf(temppath, sizeof temppath, "%s.tmp", path);
+	if ((f = fopen(temppath, "w")) == NULL)
+		return;
+
+	for (mc = md5cache; mc; mc = mc->next)
+	{
+		struct stat st;
+
+		if (stat(mc->path, &st) || mc->size != (unsigned long)st.st_size
+		|| mc->mtime != (unsigned long)st.st_mtime || !W_MD5Settled(&st))
+			continue;
+
+		for (i = 0; i < 16; i++)
+			fprintf(f, "%02x", mc->md5sum[i]);
+		fprintf(f, " %lu %lu %s\n", mc->size, mc->mtime, mc->path);
+	}
+
+	if (fclose(f))
+	{
+		remove(temppath);
+		return;
+	}
+	remove(path);
+	rename(temppath, path);
+}
+
+static void W_LoadMD5Cache(void)
+{
+	char line[MAX_WADPATH + 64];
+	FILE *f;
+
+	md5cacheloaded = true;
+	md5cacheenabled = !M_CheckParm("-nomd5cache");
+	if (!md5cacheenabled || (f = fopen(va("%s"PATHSEP"%s", srb2home, MD5CACHE_FILE), "r")) == NULL)
+		return;
+
+	while (fgets(line, sizeof line, f))
+	{
+		struct stat st;
+		UINT8 md5sum[16];
+		unsigned int byte;
+		unsigned long size, mtime;
+		int pathpos = 0;
+		char *path;
+		INT32 i;
+
+		if (strlen(line) < 33 || line[32] != ' '
+		|| sscanf(line, "%*32[0-9a-f] %lu %lu %n", &size, &mtime, &pathpos) < 2 || !pathpos)
+			continue;
+		for (i = 0; i < 16; i++)
+		{
+			sscanf(&line[i*2], "%2x", &byte);
+			md5sum[i] = (UINT8)byte;
+		}
+
+		path = &line[pathpos];
+		path[strcspn(path, "\r\n")] = '\0';
+
+		memset(&st, 0, sizeof st);
+		st.st_size = (off_t)size;
+		st.st_mtime = (time_t)mtime;
+		W_CacheMD5(path, &st, md5sum);
+	}
+	fclose(f);
+}
+
+// Looks up a file that's already been stat'd; the sum is only good if
+// nothing about the file changed since.
+static boolean W_GetCachedMD5(const char *path, const struct stat *st, void *resblock)
+{
+	md5cache_t *mc;
+
+	if (!md5cacheloaded)
+		W_LoadMD5Cache();
+
+	mc = W_FindCachedMD5(path);
+	if (!mc || mc->size != (unsigned long)st->st_size || mc->mtime != (unsigned long)st->st_mtime
+	|| !W_MD5Settled(st))
+		return false;
+
+	M_Memcpy(resblock, mc->md5sum, 16);
+	return true;
+}
+
+typedef struct
+{
+	char *path;
+	struct stat st;
+	UINT8 md5sum[16];
+	boolean ok;
+} md5job_t;
+
+static md5job_t *md5jobs;
+static size_t md5numjobs, md5nextjob, md5jobsdone, md5workers;
+
+#ifdef HAVE_THREADS
+static I_mutex md5_mutex;
+static I_cond md5_cond;
+#endif
+
+// Runs on the hashing threads, so it mustn't touch anything but its jobs.
+static void W_MD5Worker(void *userdata)
+{
+	md5job_t *job;
+	FILE *fhandle;
+	size_t i;
+
+	(void)userdata;
+	for (;;)
+	{
+#ifdef HAVE_THREADS
+		I_lock_mutex(&md5_mutex);
+#endif
+		i = md5nextjob++;
+		if (i >= md5numjobs)
+		{
+			// the job list can't be freed until every worker is out of here
+			md5workers--;
+#ifdef HAVE_THREADS
+			I_wake_all_cond(&md5_cond);
+			I_unlock_mutex(md5_mutex);
+#endif
+			return;
+		}
+#ifdef HAVE_THREADS
+		I_unlock_mutex(md5_mutex);
+#endif
+
+		job = &md5jobs[i];
+		if ((fhandle = fopen(job->path, "rb")) != NULL)
+		{
+			job->ok = (md5_stream(fhandle, job->md5sum) == 0);
+			fclose(fhandle);
+		}
+
+#ifdef HAVE_THREADS
+		I_lock_mutex(&md5_mutex);
+		if (++md5jobsdone == md5numjobs)
+			I_wake_all_cond(&md5_cond);
+		I_unlock_mutex(md5_mutex);
+#else
+		md5jobsdone++;
+#endif
+	}
+}
+#endif
+
+/** Hashes every file in a list ahead of W_InitFile, in parallel, so each
+  * W_MakeFileMD5 after it is just a lookup.
+  *
+  * \param filenames A null-terminated list of files.
+  */
+void W_HashFiles(char **filenames)
+{
+#ifdef NOMD5
+	(void)filenames;
+#else
+	precise_t t = I_GetPreciseTime();
+	size_t i, count = 0;
+	UINT8 md5sum[16];
+#ifdef HAVE_THREADS
+	INT32 threads = MD5HASH_THREADS;
+#endif
+
+	for (i = 0; filenames[i]; i++)
+		;
+	if (!i)
+		return;
+
+	md5jobs = Z_Calloc(i * sizeof (*md5jobs), PU_STATIC, NULL);
+	md5numjobs = md5nextjob = md5jobsdone = 0;
+
+	for (; *filenames; filenames++)
+	{
+		const char *filename = *filenames;
+		FILE *handle = W_OpenWadFile(&filename, false);
+		md5job_t *job = &md5jobs[md5numjobs];
+
+		if (!handle)
+			continue; // W_InitFile will complain about it
+		fclose(handle);
+
+		if (stat(filename, &job->st) || W_GetCachedMD5(filename, &job->st, md5sum))
+			continue;
+
+		job->path = Z_StrDup(filename);
+		md5numjobs++;
+	}
+
+#ifdef HAVE_THREADS
+	if (M_CheckParm("-hashthreads") && M_IsNextParm())
+		threads = max(1, atoi(M_GetNextParm()));
+
+	// the main thread pitches in too
+	I_lock_mutex(&md5_mutex);
+	md5workers = 1;
+	I_unlock_mutex(md5_mutex);
+	for (i = 1; i < md5numjobs && i < (size_t)threads; i++)
+	{
+		I_lock_mutex(&md5_mutex);
+		md5workers++;
+		I_unlock_mutex(md5_mutex);
+		if (!I_spawn_thread("md5-hash", W_MD5Worker, NULL))
+		{
+			I_lock_mutex(&md5_mutex);
+			md5workers--;
+			I_unlock_mutex(md5_mutex);
+			break;
+		}
+	}
+	W_MD5Worker(NULL);
+
+	I_lock_mutex(&md5_mutex);
+	while (md5jobsdone < md5numjobs || md5workers)
+		I_hold_cond(&md5_cond, md5_mutex);
+	I_unlock_mutex(md5_mutex);
+#else
+	md5workers = 1;
+	W_MD5Worker(NULL);
+#endif
+
+	for (i = 0; i < md5numjobs; i++)
+	{
+		if (md5jobs[i].ok)
+		{
+			W_CacheMD5(md5jobs[i].path, &md5jobs[i].st, md5jobs[i].md5sum);
+			md5cachedirty = true;
+		}
+		count += md5jobs[i].ok;
+		Z_Free(md5jobs[i].path);
+	}
+	Z_Free(md5jobs);
+	md5jobs = NULL;
+	if (!md5cachebatch)
+		W_SaveMD5Cache();
+
+	if (count)
+	{
+		CONS_Debug(DBG_SETUP, "Hashed %s file%s in %f seconds\n", sizeu1(count), count == 1 ? "" : "s",
+			(double)(I_GetPreciseTime() - t) / I_GetPrecisePrecision());
+	}
+#endif
+}
+
 /** Compute MD5 message digest for bytes read from STREAM of this filname.
+  * Comes from the MD5 cache if the file hasn't changed since it was last hashed.
   *
   * The resulting message digest number will be written into the 16 bytes
   * beginning at RESBLOCK.
@@ -291,13 +636,17 @@ static inline void W_LoadDehackedLumps(UINT16 wadnum)
   * \param resblock resulting MD5 checksum
   * \return 0 if MD5 checksum was made, and is at resblock, 1 if error was found
   */
-static inline INT32 W_MakeFileMD5(const char *filename, void *resblock)
+INT32 W_MakeFileMD5(const char *filename, void *resblock)
 {
 #ifdef NOMD5
 	(void)filename;
 	memset(resblock, 0x00, 16);
 #else
 	FILE *fhandle;
+	struct stat st;
+
+	if (!stat(filename, &st) && W_GetCachedMD5(filename, &st, resblock))
+		return 0;
 
 	if ((fhandle = fopen(filename, "rb")) != NULL)
 	{
@@ -311,6 +660,13 @@ static inline INT32 W_MakeFileMD5(const char *filename, void *resblock)
 		CONS_Debug(DBG_SETUP, "MD5 calc for %s took %f seconds\n",
 			filename, (float)(I_GetTime() - t)/NEWTICRATE);
 		fclose(fhandle);
+		if (!stat(filename, &st))
+		{
+			W_CacheMD5(filename, &st, resblock);
+			md5cachedirty = true;
+			if (!md5cachebatch)
+				W_SaveMD5Cache();
+		}
 		return 0;
 	}
 #endif
@@ -789,6 +1145,8 @@ UINT16 W_InitFile(const char *filename)
 	fseek(handle, 0, SEEK_END);
 	wadfile->filesize = (unsigned)ftell(handle);
 	wadfile->type = type;
+	W_MapFile(wadfile);
+	W_BuildNameIndex(wadfile);
 
 	// already generated, just copy it over
 	M_Memcpy(&wadfile->md5sum, &md5sum, 16);
@@ -854,6 +1212,10 @@ void W_UnloadWadFile(UINT16 num)
 	CONS_Printf(M_GetText("Removing WAD %s...\n"), wadfiles[num]->filename);
 
 	DEH_UnloadDehackedWad(num);
+	W_StopPrefetch();
+#ifdef HAVE_ZLIB
+	W_FlushInflateCache(num);
+#endif
 	wadfiles[num] = NULL;
 	lumpcache = delwad->lumpcache;
 	numwadfiles--;
@@ -868,6 +1230,8 @@ void W_UnloadWadFile(UINT16 num)
 			Z_ChangeTag(lumpcache[i], PU_PURGELEVEL);
 	}
 	Z_Free(lumpcache);
+	W_UnmapFile(delwad);
+	W_FreeNameIndex(delwad);
 	fclose(delwad->handle);
 	Z_Free(delwad->filename);
 	Z_Free(delwad);
@@ -891,6 +1255,13 @@ INT32 W_InitMultipleFiles(char **filenames, boolean addons)
 	INT32 rc = 1;
 	INT32 overallrc = 1;
 
+#ifndef NOMD5
+	md5cachebatch = true;
+#endif
+	D_StartupProfileBegin("W_HashFiles", NULL, NULL);
+	W_HashFiles(filenames);
+	D_StartupProfileEnd();
+
 	// will be realloced as lumps are added
 	for (; *filenames; filenames++)
 	{
@@ -898,12 +1269,19 @@ INT32 W_InitMultipleFiles(char **filenames, boolean addons)
 			G_SetGameModified(true, false);
 
 		//CONS_Debug(DBG_SETUP, "Loading %s\n", *filenames);
+		D_StartupProfileBegin("W_InitFile", *filenames, NULL);
 		rc = W_InitFile(*filenames);
+		D_StartupProfileEnd();
 		if (rc == INT16_MAX)
 			CONS_Printf(M_GetText("Errors occurred while loading %s; not added.\n"), *filenames);
 		overallrc &= (rc != INT16_MAX) ? 1 : 0;
 	}
 
+#ifndef NOMD5
+	md5cachebatch = false;
+	W_SaveMD5Cache();
+#endif
+
 	if (!numwadfiles)
 		I_Error("W_InitMultipleFiles: no files found");
 
@@ -940,6 +1318,82 @@ const char *W_CheckNameForNum(lumpnum_t lumpnum)
 	return W_CheckNameForNumPwad(WADFILENUM(lumpnum),LUMPNUM(lumpnum));
 }
 
+// ==========================================================================
+// Lump name index
+// ==========================================================================
+//
+// Every file gets a hash of its short and long lump names, built once when
+// it's added. Each bucket chains its lumps in ascending order, so the first
+// match at or after 'startlump' is the same one the old forward scan found,
+// and W_CheckNumForName still walks the files newest-first.
+
+#define NAMEINDEX_END UINT16_MAX // numlumps is a UINT16, so no lump gets this
+
+// Hashes all 8 bytes the way W_CheckNumForNamePwad compares them.
+static UINT32 W_HashShortName(const char *name)
+{
+	UINT32 hash = 2166136261u;
+	size_t i;
+	for (i = 0; i < 8; i++)
+		hash = (hash ^ (UINT8)name[i]) * 16777619u;
+	return hash;
+}
+
+static UINT32 W_HashLongName(const char *name)
+{
+	UINT32 hash = 2166136261u;
+	while (*name)
+		hash = (hash ^ (UINT8)*name++) * 16777619u;
+	return hash;
+}
+
+static void W_BuildNameIndex(wadfile_t *wadfile)
+{
+	UINT32 buckets = 16, b;
+	UINT16 i;
+
+	wadfile->namefirst = wadfile->namenext = NULL;
+	wadfile->longfirst = wadfile->longnext = NULL;
+	wadfile->hashmask = 0;
+
+	if (M_CheckParm("-nolumpindex"))
+		return;
+
+	while (buckets < wadfile->numlumps)
+		buckets <<= 1;
+
+	wadfile->namefirst = Z_Malloc((2*buckets + 2*wadfile->numlumps) * sizeof (UINT16), PU_STATIC, NULL);
+	wadfile->longfirst = wadfile->namefirst + buckets;
+	wadfile->namenext = wadfile->longfirst + buckets;
+	wadfile->longnext = wadfile->namenext + wadfile->numlumps;
+	wadfile->hashmask = buckets - 1;
+
+	for (b = 0; b < buckets; b++)
+		wadfile->namefirst[b] = wadfile->longfirst[b] = NAMEINDEX_END;
+
+	// Insert backwards so each chain comes out in ascending lump order.
+	for (i = wadfile->numlumps; i-- > 0;)
+	{
+		lumpinfo_t *lump_p = wadfile->lumpinfo + i;
+
+		b = W_HashShortName(lump_p->name) & wadfile->hashmask;
+		wadfile->namenext[i] = wadfile->namefirst[b];
+		wadfile->namefirst[b] = i;
+
+		b = W_HashLongName(lump_p->longname) & wadfile->hashmask;
+		wadfile->longnext[i] = wadfile->longfirst[b];
+		wadfile->longfirst[b] = i;
+	}
+}
+
+static void W_FreeNameIndex(wadfile_t *wadfile)
+{
+	if (wadfile->namefirst)
+		Z_Free(wadfile->namefirst);
+	wadfile->namefirst = wadfile->namenext = NULL;
+	wadfile->longfirst = wadfile->longnext = NULL;
+}
+
 //
 // Same as the original, but checks in one pwad only.
 // wadid is a wad number
@@ -964,7 +1418,14 @@ UINT16 W_CheckNumForNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 	// start at 'startlump', useful parameter when there are multiple
 	//                       resources with the same name
 	//
-	if (startlump < wadfiles[wad]->numlumps)
+	if (wadfiles[wad]->namefirst)
+	{
+		i = wadfiles[wad]->namefirst[W_HashShortName(uname) & wadfiles[wad]->hashmask];
+		for (; i != NAMEINDEX_END; i = wadfiles[wad]->namenext[i])
+			if (i >= startlump && memcmp(wadfiles[wad]->lumpinfo[i].name, uname, sizeof(uname) - 1) == 0)
+				return i;
+	}
+	else if (startlump < wadfiles[wad]->numlumps)
 	{
 		lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
 		for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
@@ -998,7 +1459,14 @@ UINT16 W_CheckNumForLongNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 	// start at 'startlump', useful parameter when there are multiple
 	//                       resources with the same name
 	//
-	if (startlump < wadfiles[wad]->numlumps)
+	if (wadfiles[wad]->longfirst)
+	{
+		i = wadfiles[wad]->longfirst[W_HashLongName(uname) & wadfiles[wad]->hashmask];
+		for (; i != NAMEINDEX_END; i = wadfiles[wad]->longnext[i])
+			if (i >= startlump && !strcmp(wadfiles[wad]->lumpinfo[i].longname, uname))
+				return i;
+	}
+	else if (startlump < wadfiles[wad]->numlumps)
 	{
 		lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
 		for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
@@ -1010,6 +1478,89 @@ UINT16 W_CheckNumForLongNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 	return INT16_MAX;
 }
 
+// Times lump lookups over every loaded file, with and without the name
+// index, the way W_CheckNumForName does them on a lumpnumcache miss.
+// Run with -lumpbench.
+#define LUMPBENCH_SAMPLES 4096
+
+static UINT32 W_BenchmarkPass(boolean longnames)
+{
+	UINT32 found = 0, step, total = 0, n;
+	UINT16 w, l;
+	INT32 i;
+
+	for (w = 0; w < numwadfiles; w++)
+		total += wadfiles[w]->numlumps;
+	step = total / LUMPBENCH_SAMPLES + 1;
+
+	for (n = 0, w = 0; w < numwadfiles; w++)
+		for (l = 0; l < wadfiles[w]->numlumps; l++)
+		{
+			const char *name;
+
+			if (n++ % step)
+				continue;
+
+			name = longnames ? wadfiles[w]->lumpinfo[l].longname : wadfiles[w]->lumpinfo[l].name;
+			for (i = numwadfiles - 1; i >= 0; i--)
+				if ((longnames ? W_CheckNumForLongNamePwad(name, (UINT16)i, 0)
+					: W_CheckNumForNamePwad(name, (UINT16)i, 0)) != INT16_MAX)
+				{
+					found++;
+					break;
+				}
+
+			// and one that never hits, which costs a full pass over every file
+			for (i = numwadfiles - 1; i >= 0; i--)
+				if ((longnames ? W_CheckNumForLongNamePwad("\\NOLUMP", (UINT16)i, 0)
+					: W_CheckNumForNamePwad("\\NOLUMP", (UINT16)i, 0)) != INT16_MAX)
+					break;
+		}
+
+	return found;
+}
+
+void W_BenchmarkLookups(void)
+{
+	UINT16 *namefirst[MAX_WADFILES], *longfirst[MAX_WADFILES];
+	double ms[2][2];
+	UINT32 found[2][2];
+	precise_t t;
+	INT32 pass, kind;
+	UINT16 w;
+
+	for (pass = 0; pass < 2; pass++)
+	{
+		// pass 0 scans linearly, pass 1 uses the index
+		for (w = 0; w < numwadfiles; w++)
+		{
+			if (pass == 0)
+			{
+				namefirst[w] = wadfiles[w]->namefirst;
+				longfirst[w] = wadfiles[w]->longfirst;
+				wadfiles[w]->namefirst = wadfiles[w]->longfirst = NULL;
+			}
+			else
+			{
+				wadfiles[w]->namefirst = namefirst[w];
+				wadfiles[w]->longfirst = longfirst[w];
+			}
+		}
+
+		for (kind = 0; kind < 2; kind++)
+		{
+			t = I_GetPreciseTime();
+			found[pass][kind] = W_BenchmarkPass(kind == 1);
+			ms[pass][kind] = (double)(I_GetPreciseTime() - t) * 1000.0 / I_GetPrecisePrecision();
+		}
+	}
+
+	CONS_Printf("Lump lookups over %u files:\n", numwadfiles);
+	for (kind = 0; kind < 2; kind++)
+		CONS_Printf(" %s names: %.2f ms scanning, %.2f ms indexed (%u/%u found)\n",
+			kind ? "long" : "short", ms[0][kind], ms[1][kind], found[1][kind], found[0][kind]);
+}
+
 UINT16
 W_CheckNumForMarkerStartPwad (const char *name, UINT16 wad, UINT16 startlump)
 {
@@ -1362,44 +1913,700 @@ void zerr(int ret)
         CONS_Printf("zlib version mismatch!\n");
     }
 }
-#endif
 
-#define NO_PNG_LUMPS
+// ==========================================================================
+// Inflated lump cache
+// ==========================================================================
+//
+// Deflated PK3 entries are kept after they've been inflated, up to a fixed
+// budget (-inflatecache <MB>, 0 turns it off), so a lump that gets purged
+// out of PU_CACHE doesn't need inflating all over again. The least recently
+// used ones are dropped first; with -inflatespill they're written out to
+// srb2home/inflate/ under the file's MD5 and lump number, and read back
+// from there instead. Each spill starts with the lump's place in its file
+// and a CRC of the data, and is only used again if both still match.
 
-#ifdef NO_PNG_LUMPS
-static void ErrorIfPNG(UINT8 *d, size_t s, char *f, char *l)
+#define INFLATECACHE_DEFAULTMB 32
+#define INFLATECACHE_HASHSIZE 256 // must be a power of two
+#define INFLATE_READCHUNK 16384
+
+typedef struct inflatedlump_s
 {
-    if (s < 67) // http://garethrees.org/2007/11/14/pngcrush/
-        return;
-    // Check for PNG file signature using memcmp
-    // As it may be faster on CPUs with slow unaligned memory access
-    // Ref: http://www.libpng.org/pub/png/spec/1.2/PNG-Rationale.html#R.PNG-file-signature
-    if (memcmp(&d[0], "\x89\x50\x4e\x47\x0d\x0a\x1a\x0a", 8) == 0)
-    {
-        I_Error("W_Wad: Lump \"%s\" in file \"%s\" is a .PNG - please convert to either Doom or Flat (raw) image format.", l, f);
-    }
-}
-#endif
+	UINT16 wad, lump;
+	UINT8 *data;
+	size_t size;
+	struct inflatedlump_s *hnext; // next in hash chain
+	struct inflatedlump_s *prev, *next; // LRU list, most recent first
+} inflatedlump_t;
 
-/** Reads bytes from the head of a lump.
-  * Note: If the lump is compressed, the whole thing has to be read anyway.
-  *
-  * \param wad Wad number to read from.
-  * \param lump Lump number to read from.
-  * \param dest Buffer in memory to serve as destination.
-  * \param size Number of bytes to read.
-  * \param offest Number of bytes to offset.
-  * \return Number of bytes read (should equal size).
-  * \sa W_ReadLump, W_RawReadLumpHeader
-  */
-size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset)
+typedef struct
 {
-	size_t lumpsize;
-	lumpinfo_t *l;
-	FILE *handle;
+	char id[4]; // "INFL"
+	UINT32 position, disksize, size; // the lump this was inflated from
+	UINT32 crc; // of the inflated data that follows
+} inflatespill_t;
 
-	if (!TestValidLump(wad,lump))
-		return 0;
+static inflatedlump_t *inflatehash[INFLATECACHE_HASHSIZE];
+static inflatedlump_t inflatelru = {0, 0, NULL, 0, NULL, &inflatelru, &inflatelru};
+static size_t inflatecachesize = 0, inflatecachemax = 0;
+static boolean inflatecacheinit = false, inflatespill = false;
+
+#define InflateHash(wad, lump) ((((wad) << 5) ^ (lump)) & (INFLATECACHE_HASHSIZE - 1))
+
+static void W_InitInflateCache(void)
+{
+	INT32 mb = INFLATECACHE_DEFAULTMB;
+
+	inflatecacheinit = true;
+	if (M_CheckParm("-inflatecache") && M_IsNextParm())
+		mb = max(0, atoi(M_GetNextParm()));
+	inflatecachemax = (size_t)mb << 20;
+
+	inflatespill = (inflatecachemax && M_CheckParm("-inflatespill"));
+	if (inflatespill)
+		I_mkdir(va("%s"PATHSEP"inflate", srb2home), 0755);
+}
+
+// Spilled lumps are only told apart by their file's MD5, so there has to be one.
+static const char *W_InflateSpillPath(UINT16 wad, UINT16 lump)
+{
+	static char path[MAX_WADPATH];
+	char md5hex[33];
+	boolean hasmd5 = false;
+	INT32 i;
+
+	if (!inflatespill)
+		return NULL;
+
+	for (i = 0; i < 16; i++)
+	{
+		hasmd5 |= (wadfiles[wad]->md5sum[i] != 0);
+		sprintf(&md5hex[i*2], "%02x", wadfiles[wad]->md5sum[i]);
+	}
+	if (!hasmd5)
+		return NULL;
+
+	snprintf(path, sizeof path, "%s"PATHSEP"inflate"PATHSEP"%s-%u.lmp", srb2home, md5hex, lump);
+	return path;
+}
+
+static void W_SpillInflatedLump(UINT16 wad, UINT16 lump, const UINT8 *data, size_t size)
+{
+	const char *path = W_InflateSpillPath(wad, lump);
+	const lumpinfo_t *l = &wadfiles[wad]->lumpinfo[lump];
+	inflatespill_t spill;
+	FILE *f;
+
+	if (!path || FIL_FileExists(path) || (f = fopen(path, "wb")) == NULL)
+		return;
+
+	memcpy(spill.id, "INFL", 4);
+	spill.position = (UINT32)l->position;
+	spill.disksize = (UINT32)l->disksize;
+	spill.size = (UINT32)size;
+	spill.crc = (UINT32)crc32(crc32(0L, Z_NULL, 0), data, (uInt)size);
+
+	if (fwrite(&spill, sizeof spill, 1, f) < 1 || fwrite(data, 1, size, f) < size)
+	{
+		fclose(f);
+		remove(path);
+		return;
+	}
+	fclose(f);
+}
+
+/** Reads a spilled lump back in whole, if there's one that can be trusted.
+  * \param wad File number of the lump.
+  * \param lump Lump number within the file.
+  * \return The inflated lump from Z_Malloc, or NULL. A spill that was cut
+  *         off, rewritten or made for another version of the lump is
+  *         deleted, so the next eviction can spill it again.
+  */
+static UINT8 *W_ReadSpilledLump(UINT16 wad, UINT16 lump)
+{
+	const char *path = W_InflateSpillPath(wad, lump);
+	const lumpinfo_t *l = &wadfiles[wad]->lumpinfo[lump];
+	inflatespill_t spill;
+	UINT8 *data = NULL;
+	boolean good = false;
+	FILE *f;
+
+	if (!path || (f = fopen(path, "rb")) == NULL)
+		return NULL;
+
+	if (fread(&spill, sizeof spill, 1, f) == 1 && !memcmp(spill.id, "INFL", 4)
+		&& spill.position == (UINT32)l->position && spill.disksize == (UINT32)l->disksize
+		&& spill.size == (UINT32)l->size)
+	{
+		data = Z_Malloc(l->size, PU_STATIC, NULL);
+		good = (fread(data, 1, l->size, f) == l->size && fgetc(f) == EOF
+			&& spill.crc == (UINT32)crc32(crc32(0L, Z_NULL, 0), data, (uInt)l->size));
+	}
+	fclose(f);
+
+	if (!good)
+	{
+		if (data)
+			Z_Free(data);
+		remove(path);
+		return NULL;
+	}
+	return data;
+}
+
+static inflatedlump_t *W_FindInflatedLump(UINT16 wad, UINT16 lump)
+{
+	inflatedlump_t *il;
+
+	for (il = inflatehash[InflateHash(wad, lump)]; il; il = il->hnext)
+		if (il->wad == wad && il->lump == lump)
+		{
+			// move it to the front of the LRU list
+			il->prev->next = il->next;
+			il->next->prev = il->prev;
+			il->next = inflatelru.next;
+			il->prev = &inflatelru;
+			inflatelru.next->prev = il;
+			inflatelru.next = il;
+			return il;
+		}
+
+	return NULL;
+}
+
+static void W_DropInflatedLump(inflatedlump_t *il, boolean spill)
+{
+	inflatedlump_t **link = &inflatehash[InflateHash(il->wad, il->lump)];
+
+	while (*link != il)
+		link = &(*link)->hnext;
+	*link = il->hnext;
+	il->prev->next = il->next;
+	il->next->prev = il->prev;
+
+	if (spill)
+		W_SpillInflatedLump(il->wad, il->lump, il->data, il->size);
+
+	inflatecachesize -= il->size;
+	Z_Free(il->data);
+	Z_Free(il);
+}
+
+// Takes ownership of data, which must have come from Z_Malloc.
+static void W_AddInflatedLump(UINT16 wad, UINT16 lump, UINT8 *data, size_t size)
+{
+	inflatedlump_t *il;
+
+	// not worth emptying most of the cache for
+	if (size > inflatecachemax/4)
+	{
+		W_SpillInflatedLump(wad, lump, data, size);
+		Z_Free(data);
+		return;
+	}
+
+	while (inflatecachesize + size > inflatecachemax)
+		W_DropInflatedLump(inflatelru.prev, true);
+
+	il = Z_Malloc(sizeof *il, PU_STATIC, NULL);
+	il->wad = wad;
+	il->lump = lump;
+	il->data = data;
+	il->size = size;
+
+	il->hnext = inflatehash[InflateHash(wad, lump)];
+	inflatehash[InflateHash(wad, lump)] = il;
+	il->next = inflatelru.next;
+	il->prev = &inflatelru;
+	inflatelru.next->prev = il;
+	inflatelru.next = il;
+
+	inflatecachesize += size;
+}
+
+// Forgets everything cached from a file that's going away.
+static void W_FlushInflateCache(UINT16 wad)
+{
+	inflatedlump_t *il, *next;
+
+	for (il = inflatelru.next; il != &inflatelru; il = next)
+	{
+		next = il->next;
+		if (il->wad == wad)
+			W_DropInflatedLump(il, false);
+	}
+}
+
+// Inflates the first 'want' bytes of a deflated lump into 'out', reading
+// no more of the compressed stream than that takes. 'mapped' is the raw
+// lump in the file mapping, or NULL to read it from 'handle'. Doesn't
+// touch the zone or print anything, so the prefetcher can use it off the
+// main thread; on failure 'err' gets the zlib error, Z_ERRNO if the file
+// couldn't be read.
+static boolean W_InflateLump(lumpinfo_t *l, FILE *handle, UINT8 *mapped, UINT8 *out, size_t want, int *err)
+{
+	unsigned long left = l->disksize;
+	UINT8 *chunk = NULL;
+	z_stream strm;
+	int zErr = Z_OK;
+
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+
+	strm.next_in = mapped;
+	strm.avail_in = mapped ? l->disksize : 0;
+	strm.next_out = out;
+	strm.avail_out = want;
+
+	*err = inflateInit2(&strm, -15);
+	if (*err != Z_OK)
+		return false;
+
+	if (!mapped)
+	{
+		fseek(handle, (long)l->position, SEEK_SET);
+		chunk = malloc(INFLATE_READCHUNK);
+		if (!chunk)
+		{
+			(void)inflateEnd(&strm);
+			*err = Z_MEM_ERROR;
+			return false;
+		}
+	}
+
+	while (strm.avail_out)
+	{
+		if (!strm.avail_in && !mapped)
+		{
+			size_t n = min(left, INFLATE_READCHUNK);
+			if (!n)
+				break;
+			if (fread(chunk, 1, n, handle) < n)
+			{
+				zErr = Z_ERRNO;
+				break;
+			}
+			left -= n;
+			strm.next_in = chunk;
+			strm.avail_in = n;
+		}
+
+		zErr = inflate(&strm, Z_SYNC_FLUSH);
+		if (zErr != Z_OK)
+			break;
+	}
+
+	(void)inflateEnd(&strm);
+	free(chunk);
+
+	if (strm.avail_out)
+	{
+		// ran out of input, or the stream ended short of its stated size
+		*err = (zErr == Z_OK || zErr == Z_STREAM_END || zErr == Z_BUF_ERROR) ? Z_DATA_ERROR : zErr;
+		return false;
+	}
+	return true;
+}
+#endif
+
+#define NO_PNG_LUMPS
+
+#ifdef NO_PNG_LUMPS
+static void ErrorIfPNG(UINT8 *d, size_t s, char *f, char *l)
+{
+    if (s < 67) // http://garethrees.org/2007/11/14/pngcrush/
+        return;
+    // Check for PNG file signature using memcmp
+    // As it may be faster on CPUs with slow unaligned memory access
+    // Ref: http://www.libpng.org/pub/png/spec/1.2/PNG-Rationale.html#R.PNG-file-signature
+    if (memcmp(&d[0], "\x89\x50\x4e\x47\x0d\x0a\x1a\x0a", 8) == 0)
+    {
+        I_Error("W_Wad: Lump \"%s\" in file \"%s\" is a .PNG - please convert to either Doom or Flat (raw) image format.", l, f);
+    }
+}
+#endif
+
+// ==========================================================================
+// Memory-mapped files
+// ==========================================================================
+//
+// Where the platform has mmap, every WAD and PK3 is mapped read-only when
+// it's added. Lump reads then copy or inflate straight out of the mapping
+// instead of going through fseek/fread and a temporary buffer, and big
+// uncompressed lumps are cached as a private mapping of their own pages,
+// so they cost nothing until touched and are shared between processes
+// until somebody writes to them.
+
+// Uncompressed lumps at least this big get their own mapping when cached;
+// smaller ones aren't worth a VMA and are just copied.
+#define MAPLUMP_MINSIZE (32<<10)
+
+static void W_MapFile(wadfile_t *wadfile)
+{
+	wadfile->mapping = NULL;
+#ifdef HAVE_MMAP
+	if (!wadfile->filesize || M_CheckParm("-nowadmap"))
+		return;
+
+	wadfile->mapping = mmap(NULL, wadfile->filesize, PROT_READ, MAP_PRIVATE, fileno(wadfile->handle), 0);
+	if (wadfile->mapping == MAP_FAILED)
+	{
+		CONS_Debug(DBG_SETUP, "Couldn't map %s, reading it normally\n", wadfile->filename);
+		wadfile->mapping = NULL;
+	}
+#endif
+}
+
+static void W_UnmapFile(wadfile_t *wadfile)
+{
+#ifdef HAVE_MMAP
+	if (wadfile->mapping)
+		munmap(wadfile->mapping, wadfile->filesize);
+#endif
+	wadfile->mapping = NULL;
+}
+
+// Returns the lump's raw (maybe compressed) data inside the file mapping,
+// or NULL if it has to be read from the file handle instead.
+static UINT8 *W_MappedLumpData(wadfile_t *wadfile, lumpinfo_t *l)
+{
+	if (!wadfile->mapping || l->position + l->disksize > wadfile->filesize)
+		return NULL;
+	return wadfile->mapping + l->position;
+}
+
+#ifdef HAVE_MMAP
+static void W_ReleaseLumpMapping(void *real, size_t size)
+{
+	munmap(real, size);
+}
+#endif
+
+// Caches a big uncompressed lump as a private mapping of its own, handed
+// to the zone as an adopted block. The page holding the zone header gets
+// copied on write; the rest stays shared with the page cache.
+static boolean W_MapLumpToCache(UINT16 wad, UINT16 lump, INT32 tag)
+{
+#ifdef HAVE_MMAP
+	static size_t pagesize = 0;
+	wadfile_t *wadfile = wadfiles[wad];
+	lumpinfo_t *l = &wadfile->lumpinfo[lump];
+	size_t start, len;
+	UINT8 *base;
+
+	if (!W_MappedLumpData(wadfile, l) || l->compression != CM_NOCOMPRESSION
+	|| l->size < MAPLUMP_MINSIZE || l->position < Z_ADOPTROOM)
+		return false;
+
+	if (!pagesize)
+		pagesize = (size_t)sysconf(_SC_PAGESIZE);
+
+	start = (l->position - Z_ADOPTROOM) & ~(pagesize - 1);
+	len = l->position + l->size - start;
+	base = mmap(NULL, len, PROT_READ|PROT_WRITE, MAP_PRIVATE, fileno(wadfile->handle), (off_t)start);
+	if (base == MAP_FAILED)
+		return false;
+
+#ifdef NO_PNG_LUMPS
+	ErrorIfPNG(base + (l->position - start), l->size, wadfile->filename, l->fullname);
+#endif
+
+	Z_Adopt(base, base + (l->position - start), l->size, W_ReleaseLumpMapping, tag, &wadfile->lumpcache[lump]);
+	return true;
+#else
+	(void)wad;
+	(void)lump;
+	(void)tag;
+	return false;
+#endif
+}
+
+// ==========================================================================
+// Lump prefetching
+// ==========================================================================
+//
+// While the vote or intermission screen is up, the next map's lumps get
+// warmed up on a worker thread: mapped ones have their pages touched, files
+// that aren't mapped get read through a handle of the worker's own, and
+// deflated lumps are inflated so they can go straight into the inflated
+// lump cache. The worker never touches the zone; whatever it inflated is
+// handed over on the main thread by W_PrefetchTicker.
+
+#define PREFETCH_MAXLUMPS 4096
+#define PREFETCH_LUMPSPERTIC 8 // without threads, the ticker does the work
+
+typedef struct
+{
+	UINT16 wad, lump;
+	UINT8 *data; // inflated lump, malloc'd by the worker
+} prefetch_t;
+
+static prefetch_t prefetchlumps[PREFETCH_MAXLUMPS];
+static size_t prefetchcount = 0; // queued
+static size_t prefetchnext = 0; // next one the worker takes
+static size_t prefetchdone = 0; // everything before this is finished
+static size_t prefetchhanded = 0; // and everything before this handed over
+static boolean prefetchrunning = false, prefetchcancel = false;
+
+// the worker's own handle, for files that aren't mapped
+static FILE *prefetchhandle = NULL;
+static UINT16 prefetchhandlewad = UINT16_MAX;
+
+#ifdef HAVE_THREADS
+static I_mutex prefetch_mutex;
+static I_cond prefetch_cond;
+#endif
+
+/** Queues a lump to be warmed up by the next W_StartPrefetch.
+  *
+  * \param lumpnum Lump number to prefetch.
+  */
+void W_PrefetchLump(lumpnum_t lumpnum)
+{
+	UINT16 wad = WADFILENUM(lumpnum), lump = LUMPNUM(lumpnum);
+	size_t i;
+
+	if (prefetchrunning || prefetchcount >= PREFETCH_MAXLUMPS
+	|| wad >= numwadfiles || !wadfiles[wad] || lump >= wadfiles[wad]->numlumps
+	|| !wadfiles[wad]->lumpinfo[lump].size || wadfiles[wad]->lumpcache[lump])
+		return;
+
+	for (i = 0; i < prefetchcount; i++)
+		if (prefetchlumps[i].wad == wad && prefetchlumps[i].lump == lump)
+			return;
+
+	prefetchlumps[prefetchcount].wad = wad;
+	prefetchlumps[prefetchcount].lump = lump;
+	prefetchlumps[prefetchcount].data = NULL;
+	prefetchcount++;
+}
+
+// Runs on the worker thread.
+static void W_PrefetchOne(prefetch_t *pf)
+{
+	wadfile_t *wadfile = wadfiles[pf->wad];
+	lumpinfo_t *l = &wadfile->lumpinfo[pf->lump];
+	UINT8 *mapped = W_MappedLumpData(wadfile, l);
+
+	if (!mapped && prefetchhandlewad != pf->wad)
+	{
+		if (prefetchhandle)
+			fclose(prefetchhandle);
+		prefetchhandle = fopen(wadfile->filename, "rb");
+		prefetchhandlewad = pf->wad;
+	}
+	if (!mapped && !prefetchhandle)
+		return;
+
+	if (l->compression == CM_NOCOMPRESSION)
+	{
+		if (mapped)
+		{
+			volatile UINT8 sink;
+			size_t i;
+			for (i = 0; i < l->disksize; i += 4096)
+				sink = mapped[i];
+			(void)sink;
+		}
+		else
+		{
+			UINT8 buf[4096];
+			unsigned long left = l->disksize;
+			fseek(prefetchhandle, (long)l->position, SEEK_SET);
+			while (left && fread(buf, 1, min(left, sizeof buf), prefetchhandle) == min(left, sizeof buf))
+				left -= min(left, sizeof buf);
+		}
+	}
+#ifdef HAVE_ZLIB
+	else if (l->compression == CM_DEFLATE && l->size <= inflatecachemax/4)
+	{
+		int zErr;
+		pf->data = malloc(l->size);
+		if (pf->data && !W_InflateLump(l, prefetchhandle, mapped, pf->data, l->size, &zErr))
+		{
+			free(pf->data);
+			pf->data = NULL;
+		}
+	}
+#endif
+}
+
+#ifdef HAVE_THREADS
+static void W_PrefetchWorker(void *userdata)
+{
+	size_t i;
+
+	(void)userdata;
+	for (;;)
+	{
+		I_lock_mutex(&prefetch_mutex);
+		i = prefetchnext;
+		if (prefetchcancel || i >= prefetchcount || I_thread_is_stopped())
+		{
+			prefetchrunning = false;
+			I_wake_all_cond(&prefetch_cond);
+			I_unlock_mutex(prefetch_mutex);
+			return;
+		}
+		prefetchnext++;
+		I_unlock_mutex(prefetch_mutex);
+
+		W_PrefetchOne(&prefetchlumps[i]);
+
+		I_lock_mutex(&prefetch_mutex);
+		prefetchdone = i + 1;
+		I_unlock_mutex(prefetch_mutex);
+	}
+}
+#endif
+
+// Starts warming up everything queued with W_PrefetchLump.
+void W_StartPrefetch(void)
+{
+	if (prefetchrunning || prefetchcount == prefetchnext)
+		return;
+
+#ifdef HAVE_ZLIB
+	if (!inflatecacheinit)
+		W_InitInflateCache();
+#endif
+
+#ifdef HAVE_THREADS
+	I_lock_mutex(&prefetch_mutex);
+	prefetchcancel = false;
+	prefetchrunning = true;
+	I_unlock_mutex(prefetch_mutex);
+
+	// Nothing will ever clear prefetchrunning if the worker doesn't start,
+	// and W_StopPrefetch would wait on it forever.
+	if (!I_spawn_thread("lump-prefetch", W_PrefetchWorker, NULL))
+	{
+		I_lock_mutex(&prefetch_mutex);
+		prefetchrunning = false;
+		I_wake_all_cond(&prefetch_cond);
+		I_unlock_mutex(prefetch_mutex);
+	}
+#else
+	prefetchcancel = false;
+	prefetchrunning = true;
+#endif
+}
+
+// Main thread only: takes whatever the worker inflated into the cache.
+static void W_HandOverPrefetched(prefetch_t *pf)
+{
+#ifdef HAVE_ZLIB
+	if (pf->data)
+	{
+		lumpinfo_t *l = &wadfiles[pf->wad]->lumpinfo[pf->lump];
+		if (!W_FindInflatedLump(pf->wad, pf->lump))
+		{
+			UINT8 *data = Z_Malloc(l->size, PU_STATIC, NULL);
+			M_Memcpy(data, pf->data, l->size);
+			W_AddInflatedLump(pf->wad, pf->lump, data, l->size);
+		}
+		free(pf->data);
+		pf->data = NULL;
+	}
+#else
+	(void)pf;
+#endif
+}
+
+void W_PrefetchTicker(void)
+{
+	size_t done;
+#ifndef HAVE_THREADS
+	size_t n;
+#endif
+
+	if (!prefetchcount)
+		return;
+
+#ifdef HAVE_THREADS
+	I_lock_mutex(&prefetch_mutex);
+	done = prefetchdone;
+	I_unlock_mutex(prefetch_mutex);
+#else
+	for (n = 0; prefetchrunning && n < PREFETCH_LUMPSPERTIC; n++)
+	{
+		if (prefetchnext >= prefetchcount)
+		{
+			prefetchrunning = false;
+			break;
+		}
+		W_PrefetchOne(&prefetchlumps[prefetchnext++]);
+	}
+	done = prefetchdone = prefetchnext;
+#endif
+
+	for (; prefetchhanded < done; prefetchhanded++)
+		W_HandOverPrefetched(&prefetchlumps[prefetchhanded]);
+}
+
+// Stops the worker and forgets the queue, keeping whatever was finished.
+// Call before anything that could pull a file out from under it.
+void W_StopPrefetch(void)
+{
+	size_t i;
+
+	if (!prefetchcount)
+		return;
+
+#ifdef HAVE_THREADS
+	I_lock_mutex(&prefetch_mutex);
+	prefetchcancel = true;
+	while (prefetchrunning)
+		I_hold_cond(&prefetch_cond, prefetch_mutex);
+	I_unlock_mutex(prefetch_mutex);
+#else
+	prefetchrunning = false;
+#endif
+
+	W_PrefetchTicker();
+	for (i = prefetchhanded; i < prefetchcount; i++)
+		free(prefetchlumps[i].data);
+
+	if (prefetchhandle)
+		fclose(prefetchhandle);
+	prefetchhandle = NULL;
+	prefetchhandlewad = UINT16_MAX;
+
+	prefetchcount = prefetchnext = prefetchdone = prefetchhanded = 0;
+}
+
+#ifdef PARALLELVIEWS
+// Splitscreen views read and cache lumps from several threads while they're
+// being drawn; the file handles and caches below aren't safe for that.
+static I_mutex lump_mutex;
+#endif
+
+static inline void W_LockLumps(void)
+{
+#ifdef PARALLELVIEWS
+	if (renderthreads)
+		I_lock_mutex(&lump_mutex);
+#endif
+}
+
+static inline void W_UnlockLumps(void)
+{
+#ifdef PARALLELVIEWS
+	if (renderthreads)
+		I_unlock_mutex(lump_mutex);
+#endif
+}
+
+static size_t W_ReadLumpBytes(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset)
+{
+	size_t lumpsize;
+	lumpinfo_t *l;
+	FILE *handle;
+	UINT8 *mapped;
+
+	if (!TestValidLump(wad,lump))
+		return 0;
 
 	lumpsize = wadfiles[wad]->lumpinfo[lump].size;
 	// empty resource (usually markers like S_START, F_END ..)
@@ -1411,24 +2618,32 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 		size = lumpsize - offset;
 
 	// Let's get the raw lump data.
-	// We setup the desired file handle to read the lump data.
+	// Straight from the mapping if the file is mapped, otherwise
+	// we setup the desired file handle to read the lump data.
 	l = wadfiles[wad]->lumpinfo + lump;
 	handle = wadfiles[wad]->handle;
-	fseek(handle, (long)(l->position + offset), SEEK_SET);
+	mapped = W_MappedLumpData(wadfiles[wad], l);
+	if (!mapped)
+		fseek(handle, (long)(l->position + offset), SEEK_SET);
 
 	// But let's not copy it yet. We support different compression formats on lumps, so we need to take that into account.
 	switch(wadfiles[wad]->lumpinfo[lump].compression)
 	{
 	case CM_NOCOMPRESSION:		// If it's uncompressed, we directly write the data into our destination, and return the bytes read.
-#ifdef NO_PNG_LUMPS
 		{
-			size_t bytesread = fread(dest, 1, size, handle);
+			size_t bytesread;
+			if (mapped)
+			{
+				M_Memcpy(dest, mapped + offset, size);
+				bytesread = size;
+			}
+			else
+				bytesread = fread(dest, 1, size, handle);
+#ifdef NO_PNG_LUMPS
 			ErrorIfPNG(dest, bytesread, wadfiles[wad]->filename, l->fullname);
+#endif
 			return bytesread;
 		}
-#else
-		return fread(dest, 1, size, handle);
-#endif
 	case CM_LZF:		// Is it LZF compressed? Used by ZWADs.
 		{
 #ifdef ZWAD
@@ -1436,11 +2651,18 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 			char *decData; // Lump's decompressed real data.
 			size_t retval; // Helper var, lzf_decompress returns 0 when an error occurs.
 
-			rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
 			decData = Z_Malloc(l->size, PU_STATIC, NULL);
 
-			if (fread(rawData, 1, l->disksize, handle) < l->disksize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+			if (mapped)
+				rawData = (char *)mapped;
+			else
+			{
+				// The offset is applied after decompressing.
+				fseek(handle, (long)l->position, SEEK_SET);
+				rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
+				if (fread(rawData, 1, l->disksize, handle) < l->disksize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+			}
 			retval = lzf_decompress(rawData, l->disksize, decData, l->size);
 #ifndef AVOID_ERRNO
 			if (retval == 0) // If this was returned, check if errno was set
@@ -1461,7 +2683,8 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 			if (!decData) // Did we get no data at all?
 				return 0;
 			M_Memcpy(dest, decData + offset, size);
-			Z_Free(rawData);
+			if (!mapped)
+				Z_Free(rawData);
 			Z_Free(decData);
 #ifdef NO_PNG_LUMPS
 			ErrorIfPNG(dest, size, wadfiles[wad]->filename, l->fullname);
@@ -1476,54 +2699,46 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 #ifdef HAVE_ZLIB
 	case CM_DEFLATE: // Is it compressed via DEFLATE? Very common in ZIPs/PK3s, also what most doom-related editors support.
 		{
-			UINT8 *rawData; // The lump's raw data.
+			inflatedlump_t *il;
 			UINT8 *decData; // Lump's decompressed real data.
-
+			size_t want = offset + size; // A header read only needs inflating this far.
 			int zErr; // Helper var.
-			z_stream strm;
-			unsigned long rawSize = l->disksize;
-			unsigned long decSize = l->size;
-
-			rawData = Z_Malloc(rawSize, PU_STATIC, NULL);
-			decData = Z_Malloc(decSize, PU_STATIC, NULL);
-
-			if (fread(rawData, 1, rawSize, handle) < rawSize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
 
-			strm.zalloc = Z_NULL;
-			strm.zfree = Z_NULL;
-			strm.opaque = Z_NULL;
+			if (!inflatecacheinit)
+				W_InitInflateCache();
 
-			strm.total_in = strm.avail_in = rawSize;
-			strm.total_out = strm.avail_out = decSize;
-
-			strm.next_in = rawData;
-			strm.next_out = decData;
-
-			zErr = inflateInit2(&strm, -15);
-			if (zErr == Z_OK)
+			if ((il = W_FindInflatedLump(wad, lump)) != NULL)
+				M_Memcpy(dest, il->data + offset, size);
+			else if ((decData = W_ReadSpilledLump(wad, lump)) != NULL)
+			{
+				M_Memcpy(dest, decData + offset, size);
+				W_AddInflatedLump(wad, lump, decData, lumpsize);
+			}
+			else
 			{
-				zErr = inflate(&strm, Z_FINISH);
-				if (zErr == Z_STREAM_END)
+				decData = Z_Malloc(want, PU_STATIC, NULL);
+				if (W_InflateLump(l, handle, mapped, decData, want, &zErr))
 				{
-					M_Memcpy(dest, decData, size);
+					M_Memcpy(dest, decData + offset, size);
+
+					// Keep whole lumps around for the next time they're asked for.
+					if (want == lumpsize && inflatecachemax)
+					{
+						W_AddInflatedLump(wad, lump, decData, want);
+						decData = NULL;
+					}
 				}
 				else
 				{
-					size = 0;
+					if (zErr == Z_ERRNO)
+						I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
 					zerr(zErr);
+					size = 0;
 				}
-				(void)inflateEnd(&strm);
-			}
-			else
-			{
-				CONS_Printf("whopet\n");
-				size = 0;
-				zerr(zErr);
-			}
 
-			Z_Free(rawData);
-			Z_Free(decData);
+				if (decData)
+					Z_Free(decData);
+			}
 
 #ifdef NO_PNG_LUMPS
 			ErrorIfPNG(dest, size, wadfiles[wad]->filename, l->fullname);
@@ -1537,6 +2752,25 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 	return -1;
 }
 
+/** Reads bytes from the head of a lump.
+  * Note: If the lump is compressed, the whole thing has to be read anyway.
+  *
+  * \param wad Wad number to read from.
+  * \param lump Lump number to read from.
+  * \param dest Buffer in memory to serve as destination.
+  * \param size Number of bytes to read.
+  * \param offest Number of bytes to offset.
+  * \return Number of bytes read (should equal size).
+  * \sa W_ReadLump, W_RawReadLumpHeader
+  */
+size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset)
+{
+	W_LockLumps();
+	size = W_ReadLumpBytes(wad, lump, dest, size, offset);
+	W_UnlockLumps();
+	return size;
+}
+
 size_t W_ReadLumpHeader(lumpnum_t lumpnum, void *dest, size_t size, size_t offset)
 {
 	return W_ReadLumpHeaderPwad(WADFILENUM(lumpnum), LUMPNUM(lumpnum), dest, size, offset);
@@ -1565,20 +2799,24 @@ void W_ReadLumpPwad(UINT16 wad, UINT16 lump, void *dest)
 void *W_CacheLumpNumPwad(UINT16 wad, UINT16 lump, INT32 tag)
 {
 	lumpcache_t *lumpcache;
+	void *ptr;
 
 	if (!TestValidLump(wad,lump))
 		return NULL;
 
+	W_LockLumps();
 	lumpcache = wadfiles[wad]->lumpcache;
-	if (!lumpcache[lump])
+	if (!lumpcache[lump] && !W_MapLumpToCache(wad, lump, tag))
 	{
-		void *ptr = Z_Malloc(W_LumpLengthPwad(wad, lump), tag, &lumpcache[lump]);
-		W_ReadLumpHeaderPwad(wad, lump, ptr, 0, 0);  // read the lump in full
+		ptr = Z_Malloc(W_LumpLengthPwad(wad, lump), tag, &lumpcache[lump]);
+		W_ReadLumpBytes(wad, lump, ptr, 0, 0);  // read the lump in full
 	}
 	else
 		Z_ChangeTag(lumpcache[lump], tag);
 
-	return lumpcache[lump];
+	ptr = lumpcache[lump];
+	W_UnlockLumps();
+	return ptr;
 }
 
 void *W_CacheLumpNum(lumpnum_t lumpnum, INT32 tag)
@@ -1723,6 +2961,34 @@ void W_UnlockCachedPatch(void *patch)
 		Z_Unlock(patch);
 }
 
+/** Lets the zone purge a patch if it's cached, without caching it if it
+  * isn't. The next W_CachePatchNum locks it again.
+  *
+  * \param lumpnum Lump number of the patch.
+  */
+void W_UnlockCachedPatchNum(lumpnum_t lumpnum)
+{
+	UINT16 wad = WADFILENUM(lumpnum), lump = LUMPNUM(lumpnum);
+
+	if (!TestValidLump(wad, lump))
+		return;
+
+#ifdef HWRENDER
+	if (rendermode != render_soft && rendermode != render_none)
+	{
+		GLPatch_t *grPatch = M_AATreeGet(wadfiles[wad]->hwrcache, lump);
+		if (grPatch && grPatch->mipmap->grInfo.data)
+			Z_ChangeTag(grPatch->mipmap->grInfo.data, PU_HWRCACHE_UNLOCKED);
+		return;
+	}
+#endif
+
+	W_LockLumps();
+	if (wadfiles[wad]->lumpcache[lump])
+		Z_ChangeTag(wadfiles[wad]->lumpcache[lump], PU_CACHE_UNLOCKED);
+	W_UnlockLumps();
+}
+
 void *W_CachePatchName(const char *name, INT32 tag)
 {
 	lumpnum_t num;
@@ -111,6 +111,10 @@ typedef struct wadfile_s
 #endif
 	UINT16 numlumps; // this wad's number of resources
 	FILE *handle;
+	UINT8 *mapping; // the whole file mapped read-only, or NULL
+	UINT16 *namefirst, *namenext; // lump name index, see W_BuildNameIndex
+	UINT16 *longfirst, *longnext; // same, for long names
+	UINT32 hashmask;
 	UINT32 filesize; // for network
 	UINT8 md5sum[16];
 	boolean important;
@@ -128,6 +132,10 @@ void W_Shutdown(void);
 
 // Opens a WAD file. Returns the FILE * handle for the file, or NULL if not found or could not be opened
 FILE *W_OpenWadFile(const char **filename, boolean useerrors);
+// MD5 of a file, from the MD5 cache if it hasn't changed; returns 0 on success
+INT32 W_MakeFileMD5(const char *filename, void *resblock);
+// Hashes a null-terminated list of files in parallel, filling the MD5 cache
+void W_HashFiles(char **filenames);
 // Load and add a wadfile to the active wad files, returns numbers of lumps, INT16_MAX on error
 UINT16 W_InitFile(const char *filename);
 #ifdef DELFILE
@@ -145,6 +153,7 @@ const char *W_CheckNameForNum(lumpnum_t lumpnum);
 
 UINT16 W_CheckNumForNamePwad(const char *name, UINT16 wad, UINT16 startlump); // checks only in one pwad
 UINT16 W_CheckNumForLongNamePwad(const char *name, UINT16 wad, UINT16 startlump);
+void W_BenchmarkLookups(void);
 
 /* Find the first lump after F_START for instance. */
 UINT16 W_CheckNumForMarkerStartPwad(const char *name, UINT16 wad, UINT16 startlump);
@@ -176,6 +185,12 @@ size_t W_ReadLumpHeader(lumpnum_t lump, void *dest, size_t size, size_t offest);
 void W_ReadLumpPwad(UINT16 wad, UINT16 lump, void *dest);
 void W_ReadLump(lumpnum_t lump, void *dest);
 
+// Warm lumps up in the background, see P_PrefetchLevel
+void W_PrefetchLump(lumpnum_t lumpnum);
+void W_StartPrefetch(void);
+void W_PrefetchTicker(void);
+void W_StopPrefetch(void);
+
 void *W_CacheLumpNumPwad(UINT16 wad, UINT16 lump, INT32 tag);
 void *W_CacheLumpNum(lumpnum_t lump, INT32 tag);
 void *W_CacheLumpNumForce(lumpnum_t lumpnum, INT32 tag);
@@ -194,6 +209,7 @@ void *W_CachePatchNum(lumpnum_t lumpnum, INT32 tag); // return a patch_t
 #endif
 
 void W_UnlockCachedPatch(void *patch);
+void W_UnlockCachedPatchNum(lumpnum_t lumpnum);
 
 void W_VerifyFileMD5(UINT16 wadfilenum, const char *matchmd5);
 
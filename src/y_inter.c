@@ -626,6 +626,7 @@ void Y_Ticker(void)
 #endif
 
 	intertic++;
+	P_PrefetchTicker();
 
 	// Team scramble code for team match and CTF.
 	// Don't do this if we're going to automatically scramble teams next round.
@@ -880,6 +881,12 @@ void Y_StartIntermission(void)
 		usetile = useinterpic = false;
 		usebuffer = true;
 	}
+
+	// Straight on to the next map, so get it ready while the tally's up.
+	// If there's a vote, Y_VoteStops does this once it's decided.
+	if (!demo.playback && !modeattacking && nextmap < 1100-1 && !mapheaderinfo[gamemap-1]->cutscenenum
+	&& !(cv_advancemap.value == 3 && !skipstats && (multiplayer || netgame)))
+		P_PrefetchLevel(nextmap+1);
 }
 
 // ======
@@ -1240,6 +1247,9 @@ static void Y_VoteStops(SINT8 pick, SINT8 level)
 	}
 
 	deferencoremode = (levelinfo[level].encore);
+
+	// Now we know where we're going, start loading it while the roulette spins down.
+	P_PrefetchLevel(nextmap+1);
 }
 
 //
@@ -1259,6 +1269,7 @@ void Y_VoteTicker(void)
 #endif
 
 	votetic++;
+	P_PrefetchTicker();
 
 	if (votetic == voteendtic)
 	{
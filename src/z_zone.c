@@ -24,14 +24,23 @@
 ///        caught with this direct-malloc version. We also suspected that SRB2's
 ///        allocator was fragmenting badly. Finally, this version is a bit
 ///        simpler (about half the lines of code).
+///
+///        Small blocks with a level tag (PU_LEVEL <= tag < PU_PURGELEVEL) are
+///        the exception: they are bump allocated out of large per-tag chunks,
+///        so that Z_FreeTags() at map change can drop them a chunk at a time
+///        instead of calling free() for every sector, thinker and node.
 
 #include "doomdef.h"
 #include "doomstat.h"
 #include "i_system.h" // I_GetFreeMem
+#include "i_time.h" // I_GetTime
 #include "i_video.h" // rendermode
 #include "z_zone.h"
 #include "m_misc.h" // M_Memcpy
+#include "m_argv.h" // M_CheckParm
+#include "d_main.h" // srb2home, pandf
 #include "lua_script.h"
+#include "i_threads.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h" // For hardware memory info
@@ -44,12 +53,20 @@ static boolean Z_calloc = false;
 #endif
 
 #define ZONEID 0xa441d13d
+#define POOLID 0xa441d13e
 
 #ifdef ZDEBUG
 //#define ZDEBUG2
 #endif
 
+// Valgrind can only see overruns between separately malloc'd blocks,
+// so don't hide level allocations inside arena chunks when using it.
+#ifndef HAVE_VALGRIND
+#define ZONEARENAS
+#endif
+
 struct memblock_s;
+struct memchunk_s;
 
 typedef struct
 {
@@ -79,15 +96,88 @@ typedef struct memblock_s
 	INT32 ownerline;
 #endif
 
+	struct memchunk_s *chunk; // arena chunk holding this block, NULL if malloc'd
+	boolean pinned; // arena block retagged out of its arena, lives in the main list
+
+	UINT32 site; // memprofile call site, 0 if not profiled
+	tic_t birth;
+
+	zrelease_t release; // for adopted blocks, how to give "real" back
+
 	struct memblock_s *next, *prev;
 } ATTRPACK memblock_t;
 
-#ifdef ZDEBUG
-#define Ptr2Memblock(s, f) Ptr2Memblock2(s, f, __FILE__, __LINE__)
-static memblock_t *Ptr2Memblock2(void *ptr, const char* func, const char *file, INT32 line)
-#else
-static memblock_t *Ptr2Memblock(void *ptr, const char* func)
+#ifdef ZONEARENAS
+// Level arenas. Each level tag gets its own list of big chunks, and blocks
+// small enough are carved out of those with a bump pointer. The memblock_t
+// sits at the start of the block inside the chunk, so an arena block costs
+// no malloc() at all. Freed blocks go on per-size free lists for reuse
+// during the level, and Z_FreeTags() releases the chunks wholesale.
+#define ZARENA_FIRSTTAG PU_LEVEL
+#define ZARENA_LASTTAG PU_HWRPLANE
+#define NUMZARENAS (ZARENA_LASTTAG - ZARENA_FIRSTTAG + 1)
+
+#define ZARENA_CHUNKSIZE (256<<10)
+#define ZARENA_GRAIN 16 // footprints are rounded up to this
+#define ZARENA_MAXBLOCK 4096 // anything bigger goes to malloc
+#define ZARENA_NUMCLASSES (ZARENA_MAXBLOCK/ZARENA_GRAIN)
+
+struct memarena_s;
+
+typedef struct memchunk_s
+{
+	struct memarena_s *arena; // NULL once retired
+	size_t used; // bump offset into the data
+	size_t pinned; // blocks in this chunk that were retagged out of the arena
+	struct memchunk_s *next, *prev;
+} memchunk_t;
+
+// Rounded up so the first block in a chunk starts on a grain boundary.
+#define ZARENA_CHUNKHDR ((sizeof (memchunk_t) + ZARENA_GRAIN - 1) & ~(size_t)(ZARENA_GRAIN - 1))
+
+typedef struct memarena_s
+{
+	INT32 tag;
+	memchunk_t *chunks; // newest first, only the first one is bumped
+	memblock_t head; // live blocks
+	memblock_t *freelist[ZARENA_NUMCLASSES];
+
+	size_t numchunks;
+	size_t live; // bytes held by live blocks
+	size_t freebytes; // bytes sitting on the free lists
+} memarena_t;
+
+static memarena_t zarenas[NUMZARENAS];
+static memchunk_t *retiredchunks; // released arena chunks still holding pinned blocks
+static boolean usezarenas;
+
+#define ArenaFootprint(b) ((b)->size + sizeof *(b))
+
+// Pool slabs. Each slot is a memhdr_t (with POOLID and the pool in place
+// of the block) followed by the object, which starts on a cache line.
+// That lets Z_Free tell pool objects apart without any extra lookup.
+#define ZPOOL_CACHELINE 64
+#define ZPOOL_SLABSIZE (64<<10)
+
+// In front of each object: the memprofile birth tic + 1, then the
+// memhdr_t right against the object, rounded up to pointer alignment.
+#define ZPOOL_SLOTHDR ((sizeof (UINT32) + sizeof (memhdr_t) + sizeof (void *) - 1) & ~(sizeof (void *) - 1))
+#define PoolSlotBirth(slot) (*(UINT32 *)(slot))
+
+// The birth stamp must never reach into the header.
+typedef char zpool_slothdr_check[(ZPOOL_SLOTHDR - sizeof (memhdr_t) >= sizeof (UINT32)) ? 1 : -1];
+
+typedef struct zslab_s
+{
+	struct zslab_s *next;
+	UINT8 *base; // first slot
+	size_t used; // slots handed out so far by bumping
+} zslab_t;
+
+static zpool_t *zpools;
 #endif
+
+static memblock_t *Ptr2Memblock2(void *ptr, const char* func, const char *file, INT32 line)
 {
 	memhdr_t *hdr;
 	memblock_t *block;
@@ -107,22 +197,10 @@ static memblock_t *Ptr2Memblock(void *ptr, const char* func)
 
 #ifdef VALGRIND_MEMPOOL_EXISTS
 	if (!VALGRIND_MEMPOOL_EXISTS(hdr->block))
-	{
-#ifdef ZDEBUG
 		I_Error("%s: bad memblock from %s:%d", func, file, line);
-#else
-		I_Error("%s: bad memblock", func);
-#endif
-	}
 #endif
 	if (hdr->id != ZONEID)
-	{
-#ifdef ZDEBUG
 		I_Error("%s: wrong id from %s:%d", func, file, line);
-#else
-		I_Error("%s: wrong id", func);
-#endif
-	}
 	block = hdr->block;
 #ifdef VALGRIND_MAKE_MEM_NOACCESS
 	VALGRIND_MAKE_MEM_NOACCESS(hdr, sizeof *hdr);
@@ -133,11 +211,242 @@ static memblock_t *Ptr2Memblock(void *ptr, const char* func)
 
 static memblock_t head;
 
+#ifdef PARALLELVIEWS
+// Splitscreen views allocate from several threads while they're being
+// drawn. The rest of the time only the main thread touches the zone, so
+// the lock is only taken then.
+static I_mutex zone_mutex;
+#endif
+
+static inline void Z_LockZone(void)
+{
+#ifdef PARALLELVIEWS
+	if (renderthreads)
+		I_lock_mutex(&zone_mutex);
+#endif
+}
+
+static inline void Z_UnlockZone(void)
+{
+#ifdef PARALLELVIEWS
+	if (renderthreads)
+		I_unlock_mutex(zone_mutex);
+#endif
+}
+
 static void Command_Memfree_f(void);
+static void Command_Memprofile_f(void);
+#ifdef ZONEARENAS
+static void Z_ArenaFree(memblock_t *block);
+static void Z_PoolFree(zpool_t *pool, void *ptr);
+#endif
 #ifdef ZDEBUG
 static void Command_Memdump_f(void);
 #endif
 
+//
+// Allocation-site profiler, see "memprofile".
+//
+// Every Z_ allocation already knows its call site, so while profiling is
+// on each block remembers which site it came from and when. Sites keep
+// running totals, and frees feed a per-tag histogram of block lifetimes.
+// All of it is plain counters behind one branch, so it's fine to leave
+// running on a live server. Blocks allocated while profiling are still
+// accounted for when freed after "memprofile stop", so live numbers stay
+// right across start/stop.
+//
+
+#define ZPROF_MAXSITES 8192 // including the unused site 0
+#define ZPROF_HASHSIZE 16384 // power of two, at least twice ZPROF_MAXSITES
+#define ZPROF_NUMTAGS 128 // higher tags share the last row
+#define ZPROF_NUMBUCKETS 20 // lifetimes up to 2^18 tics, then everything else
+
+typedef struct
+{
+	const char *file; // or the pool name, for object pools
+	INT32 line;
+	INT32 tag; // tag of the latest allocation
+	size_t livebytes, liveblocks, peakbytes;
+	size_t allocs, totalbytes, frees;
+} zsite_t;
+
+static boolean zprofiling;
+static zsite_t *zsites; // malloc'd on the first start, kept afterwards
+static UINT16 *zsitehash; // indices into zsites, 0 is empty
+static UINT32 numzsites = 1;
+static UINT32 zlifetimes[ZPROF_NUMTAGS][ZPROF_NUMBUCKETS];
+
+// File names are compared by pointer: __FILE__ is the same literal for
+// every allocation in a translation unit, which is all we need here.
+static UINT32 Z_ProfileSite(const char *file, INT32 line)
+{
+	size_t h = ((size_t)file>>3 ^ (size_t)line*2654435761u) & (ZPROF_HASHSIZE - 1);
+	zsite_t *site;
+
+	while (zsitehash[h])
+	{
+		site = &zsites[zsitehash[h]];
+		if (site->line == line && site->file == file)
+			return zsitehash[h];
+		h = (h + 1) & (ZPROF_HASHSIZE - 1);
+	}
+
+	if (numzsites == ZPROF_MAXSITES)
+		return 0; // table full, don't track any new sites
+
+	site = &zsites[numzsites];
+	memset(site, 0, sizeof *site);
+	site->file = file;
+	site->line = line;
+	zsitehash[h] = (UINT16)numzsites;
+	return numzsites++;
+}
+
+static void Z_ProfileAlloc(UINT32 s, size_t size, INT32 tag)
+{
+	zsite_t *site = &zsites[s];
+
+	site->tag = tag;
+	site->allocs++;
+	site->totalbytes += size;
+	site->liveblocks++;
+	site->livebytes += size;
+	if (site->livebytes > site->peakbytes)
+		site->peakbytes = site->livebytes;
+}
+
+static void Z_ProfileFree(UINT32 s, size_t size, tic_t birth, INT32 tag)
+{
+	zsite_t *site = &zsites[s];
+	tic_t lifetime = I_GetTime() - birth;
+	INT32 bucket = 0;
+
+	site->frees++;
+	site->liveblocks--;
+	site->livebytes -= size;
+
+	while (lifetime && bucket < ZPROF_NUMBUCKETS - 1)
+	{
+		lifetime >>= 1;
+		bucket++;
+	}
+	if (tag < 0)
+		tag = 0;
+	else if (tag >= ZPROF_NUMTAGS)
+		tag = ZPROF_NUMTAGS - 1;
+	zlifetimes[tag][bucket]++;
+}
+
+static inline void Z_ProfileBlock(memblock_t *block, const char *file, INT32 line)
+{
+	block->site = 0;
+	if (!zprofiling)
+		return;
+
+	block->site = Z_ProfileSite(file, line);
+	if (block->site)
+	{
+		block->birth = I_GetTime();
+		Z_ProfileAlloc(block->site, block->realsize, block->tag);
+	}
+}
+
+static inline void Z_UnprofileBlock(memblock_t *block)
+{
+	if (block->site)
+		Z_ProfileFree(block->site, block->realsize, block->birth, block->tag);
+}
+
+static boolean Z_DumpProfile(const char *filename)
+{
+	FILE *f = fopen(filename, "w");
+	UINT32 i;
+	INT32 t, b;
+
+	if (!f)
+		return false;
+
+	fprintf(f, "file,line,tag,live_bytes,live_blocks,peak_bytes,allocs,total_bytes,frees\n");
+	for (i = 1; i < numzsites; i++)
+	{
+		const zsite_t *site = &zsites[i];
+		const char *name = strrchr(site->file, PATHSEP[0]);
+
+		fprintf(f, "%s,%d,%d,%s,%s,%s,%s,%s",
+			name ? name + 1 : site->file, site->line, site->tag,
+			sizeu1(site->livebytes), sizeu2(site->liveblocks), sizeu3(site->peakbytes),
+			sizeu4(site->allocs), sizeu5(site->totalbytes));
+		fprintf(f, ",%s\n", sizeu1(site->frees));
+	}
+
+	// Second table: frees per tag, by lifetime. Bucket n counts blocks
+	// that lived less than 2^n tics (bucket 0: freed on the same tic).
+	fprintf(f, "\ntag");
+	for (b = 0; b < ZPROF_NUMBUCKETS - 1; b++)
+		fprintf(f, ",lt_%u", 1u<<b);
+	fprintf(f, ",more\n");
+	for (t = 0; t < ZPROF_NUMTAGS; t++)
+	{
+		UINT32 total = 0;
+
+		for (b = 0; b < ZPROF_NUMBUCKETS; b++)
+			total += zlifetimes[t][b];
+		if (!total)
+			continue;
+
+		fprintf(f, "%d", t);
+		for (b = 0; b < ZPROF_NUMBUCKETS; b++)
+			fprintf(f, ",%u", zlifetimes[t][b]);
+		fprintf(f, "\n");
+	}
+
+	fclose(f);
+	return true;
+}
+
+static void Command_Memprofile_f(void)
+{
+	const char *cmd = COM_Argv(1);
+
+	if (!stricmp(cmd, "start"))
+	{
+		if (zsites == NULL)
+		{
+			zsites = malloc(ZPROF_MAXSITES * sizeof *zsites);
+			zsitehash = calloc(ZPROF_HASHSIZE, sizeof *zsitehash);
+			if (zsites == NULL || zsitehash == NULL)
+			{
+				free(zsites);
+				free(zsitehash);
+				zsites = NULL;
+				zsitehash = NULL;
+				CONS_Alert(CONS_ERROR, M_GetText("Not enough memory to start profiling\n"));
+				return;
+			}
+		}
+		zprofiling = true;
+		CONS_Printf(M_GetText("Memory profiling started.\n"));
+	}
+	else if (!stricmp(cmd, "stop"))
+	{
+		zprofiling = false;
+		CONS_Printf(M_GetText("Memory profiling stopped.\n"));
+	}
+	else if (!stricmp(cmd, "dump") && COM_Argc() == 3)
+	{
+		const char *filepath = va(pandf, srb2home, COM_Argv(2));
+
+		if (zsites == NULL)
+			CONS_Printf(M_GetText("Nothing to dump, use \"memprofile start\" first.\n"));
+		else if (Z_DumpProfile(filepath))
+			CONS_Printf(M_GetText("Wrote %s call sites to %s\n"), sizeu1(numzsites - 1), filepath);
+		else
+			CONS_Alert(CONS_ERROR, M_GetText("Couldn't write %s\n"), filepath);
+	}
+	else
+		CONS_Printf(M_GetText("memprofile start|stop|dump <file>: profile zone allocations by call site\n"));
+}
+
 void Z_Init(void)
 {
 	UINT32 total, memfree;
@@ -146,38 +455,55 @@ void Z_Init(void)
 
 	head.next = head.prev = &head;
 
+#ifdef ZONEARENAS
+	{
+		INT32 i;
+
+		memset(zarenas, 0x00, sizeof(zarenas));
+		for (i = 0; i < NUMZARENAS; i++)
+		{
+			zarenas[i].tag = ZARENA_FIRSTTAG + i;
+			zarenas[i].head.next = zarenas[i].head.prev = &zarenas[i].head;
+		}
+		retiredchunks = NULL;
+
+		usezarenas = !M_CheckParm("-nozonearena");
+	}
+#endif
+
 	memfree = I_GetFreeMem(&total)>>20;
 	CONS_Printf("System memory: %uMB - Free: %uMB\n", total>>20, memfree);
 
 	// Note: This allocates memory. Watch out.
 	COM_AddCommand("memfree", Command_Memfree_f);
+	COM_AddCommand("memprofile", Command_Memprofile_f);
 
 #ifdef ZDEBUG
 	COM_AddCommand("memdump", Command_Memdump_f);
 #endif
 }
 
-#ifdef ZDEBUG
-void Z_Free2(void *ptr, const char *file, INT32 line)
-#else
-void Z_Free(void *ptr)
-#endif
+static void Z_FreeBlock(void *ptr, const char *file, INT32 line)
 {
 	memblock_t *block;
 
-	if (ptr == NULL)
-		return;
-
 #ifdef ZDEBUG2
 	CONS_Debug(DBG_MEMORY, "Z_Free %s:%d\n", file, line);
 #endif
 
-#ifdef ZDEBUG
-	block = Ptr2Memblock2(ptr, "Z_Free", file, line);
-#else
-	block = Ptr2Memblock(ptr, "Z_Free");
+#ifdef ZONEARENAS
+	{
+		memhdr_t *hdr = (memhdr_t *)((UINT8 *)ptr - sizeof *hdr);
+		if (hdr->id == POOLID)
+		{
+			Z_PoolFree((zpool_t *)hdr->block, ptr);
+			return;
+		}
+	}
 #endif
 
+	block = Ptr2Memblock2(ptr, "Z_Free", file, line);
+
 #ifdef ZDEBUG
 	// Write every Z_Free call to a debug file.
 	CONS_Debug(DBG_MEMORY, "Z_Free at %s:%d\n", file, line);
@@ -196,8 +522,21 @@ void Z_Free(void *ptr)
 	if (block->user != NULL)
 		*block->user = NULL;
 
+	Z_UnprofileBlock(block);
+
+#ifdef ZONEARENAS
+	if (block->chunk != NULL)
+	{
+		Z_ArenaFree(block);
+		return;
+	}
+#endif
+
 	// Free the memory and get rid of the block.
-	free(block->real);
+	if (block->release)
+		block->release(block->real, block->size);
+	else
+		free(block->real);
 	block->prev->next = block->next;
 	block->next->prev = block->prev;
 	free(block);
@@ -206,7 +545,20 @@ void Z_Free(void *ptr)
 #endif
 }
 
+void Z_Free2(void *ptr, const char *file, INT32 line)
+{
+	if (ptr == NULL)
+		return;
+
+	Z_LockZone();
+	Z_FreeBlock(ptr, file, line);
+	Z_UnlockZone();
+}
+
+static void Z_PurgeTags(INT32 lowtag, INT32 hightag);
+
 // malloc() that doesn't accept failure.
+// Call with the zone lock held; the purge below doesn't take it again.
 static void *xm(size_t size)
 {
 	const size_t padedsize = size+sizeof (size_t);
@@ -215,7 +567,7 @@ static void *xm(size_t size)
 	if (p == NULL)
 	{
 		// Oh crumbs: we're out of heap. Try purging the cache and reallocating.
-		Z_FreeTags(PU_PURGELEVEL, INT32_MAX);
+		Z_PurgeTags(PU_PURGELEVEL, INT32_MAX);
 		p = malloc(padedsize);
 
 		if (p == NULL)
@@ -231,16 +583,158 @@ static void *xm(size_t size)
 	return p;
 }
 
-// Z_Malloc
-// You can pass Z_Malloc() a NULL user if the tag is less than
-// PU_PURGELEVEL.
+#ifdef ZONEARENAS
+static inline memarena_t *Z_ArenaForTag(INT32 tag)
+{
+	if (!usezarenas || tag < ZARENA_FIRSTTAG || tag > ZARENA_LASTTAG)
+		return NULL;
+	return &zarenas[tag - ZARENA_FIRSTTAG];
+}
 
-#ifdef ZDEBUG
-void *Z_Malloc2(size_t size, INT32 tag, void *user, INT32 alignbits,
-	const char *file, INT32 line)
-#else
-void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
+/** Carves a block out of a level arena.
+  * \param arena Arena for the block's tag.
+  * \param footprint Total bytes wanted, including the memblock_t, rounded
+  *                  to ZARENA_GRAIN.
+  * \return The new block, not yet linked anywhere.
+  */
+static memblock_t *Z_ArenaAlloc(memarena_t *arena, size_t footprint)
+{
+	const size_t class = footprint/ZARENA_GRAIN - 1;
+	memchunk_t *chunk = arena->chunks;
+	memblock_t *block;
+
+	if (arena->freelist[class])
+	{
+		block = arena->freelist[class];
+		arena->freelist[class] = block->next;
+		arena->freebytes -= footprint;
+		return block;
+	}
+
+	if (chunk == NULL || chunk->used + footprint > ZARENA_CHUNKSIZE)
+	{
+		chunk = xm(ZARENA_CHUNKHDR + ZARENA_CHUNKSIZE);
+		chunk->arena = arena;
+		chunk->used = 0;
+		chunk->pinned = 0;
+		chunk->prev = NULL;
+		chunk->next = arena->chunks;
+		if (chunk->next)
+			chunk->next->prev = chunk;
+		arena->chunks = chunk;
+		arena->numchunks++;
+	}
+
+	block = (memblock_t *)((UINT8 *)chunk + ZARENA_CHUNKHDR + chunk->used);
+	chunk->used += footprint;
+	block->chunk = chunk;
+	block->size = footprint - sizeof *block;
+	return block;
+}
+
+static void Z_FreeRetiredChunk(memchunk_t *chunk)
+{
+	if (chunk->prev)
+		chunk->prev->next = chunk->next;
+	else
+		retiredchunks = chunk->next;
+	if (chunk->next)
+		chunk->next->prev = chunk->prev;
+	free(chunk);
+}
+
+// Puts an arena block back on its free list. Pinned blocks give up their
+// hold on the chunk, which may then be released if its arena is gone.
+static void Z_ArenaFree(memblock_t *block)
+{
+	memchunk_t *chunk = block->chunk;
+	memarena_t *arena = chunk->arena;
+	const size_t footprint = ArenaFootprint(block);
+
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
+	block->hdr->id = 0; // catch double frees
+
+	if (block->pinned)
+	{
+		block->pinned = false;
+		if (--chunk->pinned == 0 && arena == NULL)
+		{
+			Z_FreeRetiredChunk(chunk);
+			return;
+		}
+		if (arena == NULL)
+			return;
+	}
+	else
+		arena->live -= footprint;
+
+	block->next = arena->freelist[footprint/ZARENA_GRAIN - 1];
+	arena->freelist[footprint/ZARENA_GRAIN - 1] = block;
+	arena->freebytes += footprint;
+}
+
+// Moves an arena block into the main block list, because its new tag no
+// longer matches the arena's. Its chunk is kept alive until it's freed.
+static void Z_ArenaPin(memblock_t *block)
+{
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
+
+	block->next = head.next;
+	block->prev = &head;
+	head.next = block;
+	block->next->prev = block;
+
+	block->chunk->arena->live -= ArenaFootprint(block);
+	block->chunk->pinned++;
+	block->pinned = true;
+}
+
+// Frees everything in an arena at once. Only the blocks' users and Lua
+// references need a walk; the memory itself goes a chunk at a time.
+static void Z_ReleaseArena(memarena_t *arena)
+{
+	memblock_t *block;
+	memchunk_t *chunk, *next;
+
+	for (block = arena->head.next; block != &arena->head; block = block->next)
+	{
+#ifdef HAVE_BLUA
+		LUA_InvalidateUserdata((UINT8 *)block->hdr + sizeof *block->hdr);
+#endif
+		if (block->user != NULL)
+			*block->user = NULL;
+		Z_UnprofileBlock(block);
+	}
+
+	for (chunk = arena->chunks; chunk; chunk = next)
+	{
+		next = chunk->next;
+		if (chunk->pinned)
+		{
+			chunk->arena = NULL;
+			chunk->prev = NULL;
+			chunk->next = retiredchunks;
+			if (retiredchunks)
+				retiredchunks->prev = chunk;
+			retiredchunks = chunk;
+		}
+		else
+			free(chunk);
+	}
+
+	arena->chunks = NULL;
+	arena->head.next = arena->head.prev = &arena->head;
+	memset(arena->freelist, 0x00, sizeof(arena->freelist));
+	arena->numchunks = 0;
+	arena->live = 0;
+	arena->freebytes = 0;
+}
 #endif
+
+static void *Z_MallocBlock(size_t size, INT32 tag, void *user, INT32 alignbits,
+	const char *file, INT32 line)
 {
 	size_t extrabytes = (1<<alignbits) - (sizeof(size_t)*8 > (UINT32) alignbits); // only subtract 1 if the bit shift did not cause an overflow
 	size_t padsize = 0;
@@ -249,11 +743,56 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	memhdr_t *hdr;
 	void *given;
 	size_t blocksize = extrabytes + sizeof *hdr + size;
+#ifdef ZONEARENAS
+	memarena_t *arena = Z_ArenaForTag(tag);
+	const size_t footprint = (sizeof *block + blocksize + ZARENA_GRAIN - 1) & ~(size_t)(ZARENA_GRAIN - 1);
+#endif
 
 #ifdef ZDEBUG2
 	CONS_Debug(DBG_MEMORY, "Z_Malloc %s:%d\n", file, line);
 #endif
 
+#ifdef ZONEARENAS
+	if (arena != NULL && footprint <= ZARENA_MAXBLOCK)
+	{
+		block = Z_ArenaAlloc(arena, footprint);
+
+		given = (void *)((size_t)((UINT8 *)(block + 1) + extrabytes + sizeof *hdr)
+			& ~extrabytes);
+		hdr = (memhdr_t *)((UINT8 *)given - sizeof *hdr);
+
+		block->next = arena->head.next;
+		block->prev = &arena->head;
+		arena->head.next = block;
+		block->next->prev = block;
+		arena->live += footprint;
+
+		block->real = NULL;
+		block->hdr = hdr;
+		block->tag = tag;
+		block->user = NULL;
+		block->pinned = false;
+		block->release = NULL;
+#ifdef ZDEBUG
+		block->ownerline = line;
+		block->ownerfile = file;
+#endif
+		block->realsize = size;
+		Z_ProfileBlock(block, file, line);
+
+		hdr->id = ZONEID;
+		hdr->block = block;
+
+		if (user != NULL)
+		{
+			block->user = user;
+			*(void **)user = given;
+		}
+
+		return given;
+	}
+#endif
+
 	block = xm(sizeof *block);
 #ifdef HAVE_VALGRIND
 	padsize += (1<<sizeof(size_t))*2;
@@ -285,12 +824,16 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	block->hdr = hdr;
 	block->tag = tag;
 	block->user = NULL;
+	block->chunk = NULL;
+	block->pinned = false;
+	block->release = NULL;
 #ifdef ZDEBUG
 	block->ownerline = line;
 	block->ownerfile = file;
 #endif
 	block->size = blocksize;
 	block->realsize = size;
+	Z_ProfileBlock(block, file, line);
 
 	hdr->id = ZONEID;
 	hdr->block = block;
@@ -311,27 +854,233 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	return given;
 }
 
-#ifdef ZDEBUG
-void *Z_Calloc2(size_t size, INT32 tag, void *user, INT32 alignbits, const char *file, INT32 line)
+// Z_Malloc
+// You can pass Z_Malloc() a NULL user if the tag is less than
+// PU_PURGELEVEL.
+
+void *Z_Malloc2(size_t size, INT32 tag, void *user, INT32 alignbits,
+	const char *file, INT32 line)
+{
+	void *given;
+
+	Z_LockZone();
+	given = Z_MallocBlock(size, tag, user, alignbits, file, line);
+	Z_UnlockZone();
+	return given;
+}
+
+/** Allocates a zeroed object from a pool.
+  * Slabs are malloc'd on demand; the pool registers itself the first time
+  * it's used so Z_FreeTags and memfree know about it.
+  * \param pool The pool to take the object from.
+  * \param file Caller, used if the pool falls back to Z_Calloc.
+  * \param line Caller, used if the pool falls back to Z_Calloc.
+  * \return The object. Give it back with Z_Free.
+  */
+void *Z_PoolCalloc2(zpool_t *pool, const char *file, INT32 line)
+{
+#ifdef ZONEARENAS
+	zslab_t *slab;
+	memhdr_t *hdr;
+	UINT8 *slot;
+
+	if (!usezarenas)
+		return Z_Calloc2(pool->objsize, pool->tag, NULL, 0, file, line);
+
+	if (!pool->registered)
+	{
+		pool->stride = (ZPOOL_SLOTHDR + pool->objsize + ZPOOL_CACHELINE - 1) & ~(size_t)(ZPOOL_CACHELINE - 1);
+		pool->perslab = ZPOOL_SLABSIZE / pool->stride;
+		if (pool->perslab < 8)
+			pool->perslab = 8;
+		pool->next = zpools;
+		zpools = pool;
+		pool->registered = true;
+	}
+
+	if (pool->freelist)
+	{
+		UINT8 *obj = pool->freelist;
+		pool->freelist = *(void **)obj;
+		slot = obj - ZPOOL_SLOTHDR;
+		pool->recycled++;
+	}
+	else
+	{
+		slab = pool->slabs;
+		if (slab == NULL || slab->used == pool->perslab)
+		{
+			UINT8 *raw;
+
+			Z_LockZone();
+			raw = xm(sizeof *slab + ZPOOL_SLOTHDR + ZPOOL_CACHELINE + pool->perslab * pool->stride);
+			Z_UnlockZone();
+
+			slab = (zslab_t *)raw;
+			// Line the objects, not the slots, up on the cache line.
+			slab->base = (UINT8 *)(((size_t)(raw + sizeof *slab + ZPOOL_SLOTHDR) + ZPOOL_CACHELINE - 1)
+				& ~(size_t)(ZPOOL_CACHELINE - 1)) - ZPOOL_SLOTHDR;
+			slab->used = 0;
+			slab->next = pool->slabs;
+			pool->slabs = slab;
+			pool->numslabs++;
+		}
+		slot = slab->base + slab->used++ * pool->stride;
+	}
+
+	hdr = (memhdr_t *)(slot + ZPOOL_SLOTHDR - sizeof *hdr);
+	hdr->block = (memblock_t *)pool;
+	hdr->id = POOLID;
+
+	if (++pool->live > pool->peak)
+		pool->peak = pool->live;
+
+	// Pool objects are profiled per pool rather than per call site;
+	// the spare word in the slot only has room for the birth time.
+	PoolSlotBirth(slot) = 0;
+	if (zprofiling)
+	{
+		if (!pool->site)
+			pool->site = Z_ProfileSite(pool->name, 0);
+		if (pool->site)
+		{
+			PoolSlotBirth(slot) = I_GetTime() + 1;
+			Z_ProfileAlloc(pool->site, pool->objsize, pool->tag);
+		}
+	}
+
+	return memset(slot + ZPOOL_SLOTHDR, 0, pool->objsize);
 #else
-void *Z_CallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
+	return Z_Calloc2(pool->objsize, pool->tag, NULL, 0, file, line);
+#endif
+}
+
+#ifdef ZONEARENAS
+static void Z_UnprofilePoolSlot(zpool_t *pool, UINT8 *slot)
+{
+	if (PoolSlotBirth(slot))
+		Z_ProfileFree(pool->site, pool->objsize, PoolSlotBirth(slot) - 1, pool->tag);
+}
+
+static void Z_PoolFree(zpool_t *pool, void *ptr)
+{
+	memhdr_t *hdr = (memhdr_t *)((UINT8 *)ptr - sizeof *hdr);
+
+#ifdef HAVE_BLUA
+	LUA_InvalidateUserdata(ptr);
+#endif
+	Z_UnprofilePoolSlot(pool, (UINT8 *)ptr - ZPOOL_SLOTHDR);
+
+	hdr->id = 0; // catch double frees
+	*(void **)ptr = pool->freelist;
+	pool->freelist = ptr;
+	pool->live--;
+}
+
+// Drops every slab of a pool. Objects still alive only need their Lua
+// references cut and their profiling closed; nobody else may hold on to
+// them past a purge.
+static void Z_ReleasePool(zpool_t *pool)
+{
+	zslab_t *slab, *next;
+	size_t i;
+
+	for (slab = pool->slabs; slab; slab = next)
+	{
+		next = slab->next;
+		for (i = 0; i < slab->used; i++)
+		{
+			UINT8 *slot = slab->base + i * pool->stride;
+			if (((memhdr_t *)(slot + ZPOOL_SLOTHDR - sizeof (memhdr_t)))->id != POOLID)
+				continue;
+#ifdef HAVE_BLUA
+			LUA_InvalidateUserdata(slot + ZPOOL_SLOTHDR);
+#endif
+			Z_UnprofilePoolSlot(pool, slot);
+		}
+		free(slab);
+	}
+
+	pool->slabs = NULL;
+	pool->freelist = NULL;
+	pool->numslabs = 0;
+	pool->live = 0;
+}
 #endif
+
+/** Adopts externally obtained memory as a zone block.
+  * \param real What gets passed to \p release when the block is freed.
+  * \param given The pointer handed out, with Z_ADOPTROOM bytes before it
+  *              that the zone header may use.
+  * \param size Usable bytes at \p given.
+  * \param release Called with \p real and the length from \p real to
+  *                the end of the data once the block is freed.
+  * \return \p given, now a zone block.
+  */
+void *Z_Adopt2(void *real, void *given, size_t size, zrelease_t release, INT32 tag, void *user, const char *file, INT32 line)
 {
+	memblock_t *block;
+	memhdr_t *hdr = (memhdr_t *)((UINT8 *)given - sizeof *hdr);
+
+	Z_LockZone();
+	block = xm(sizeof *block);
+#ifdef VALGRIND_CREATE_MEMPOOL
+	VALGRIND_CREATE_MEMPOOL(block, 0, true);
+#endif
 #ifdef VALGRIND_MEMPOOL_ALLOC
-	Z_calloc = true;
+	VALGRIND_MEMPOOL_ALLOC(block, hdr, size + sizeof *hdr);
 #endif
+
+	block->next = head.next;
+	block->prev = &head;
+	head.next = block;
+	block->next->prev = block;
+
+	block->real = real;
+	block->hdr = hdr;
+	block->tag = tag;
+	block->user = NULL;
+	block->chunk = NULL;
+	block->pinned = false;
+	block->release = release;
 #ifdef ZDEBUG
-	return memset(Z_Malloc2    (size, tag, user, alignbits, file, line), 0, size);
-#else
-	return memset(Z_MallocAlign(size, tag, user, alignbits            ), 0, size);
+	block->ownerline = line;
+	block->ownerfile = file;
 #endif
+	block->size = (size_t)((UINT8 *)given - (UINT8 *)real) + size;
+	block->realsize = size;
+	Z_ProfileBlock(block, file, line);
+
+	hdr->id = ZONEID;
+	hdr->block = block;
+
+#ifdef VALGRIND_MAKE_MEM_NOACCESS
+	VALGRIND_MAKE_MEM_NOACCESS(hdr, sizeof *hdr);
+#endif
+
+	if (user != NULL)
+	{
+		block->user = user;
+		*(void **)user = given;
+	}
+	Z_UnlockZone();
+
+	if (user == NULL && tag >= PU_PURGELEVEL)
+		I_Error("Z_Adopt: attempted to adopt purgable block "
+			"(size %s) with no user", sizeu1(size));
+
+	return given;
 }
 
-#ifdef ZDEBUG
-void *Z_Realloc2(void *ptr, size_t size, INT32 tag, void *user, INT32 alignbits, const char *file, INT32 line)
-#else
-void *Z_ReallocAlign(void *ptr, size_t size,INT32 tag, void *user,  INT32 alignbits)
+void *Z_Calloc2(size_t size, INT32 tag, void *user, INT32 alignbits, const char *file, INT32 line)
+{
+#ifdef VALGRIND_MEMPOOL_ALLOC
+	Z_calloc = true;
 #endif
+	return memset(Z_Malloc2(size, tag, user, alignbits, file, line), 0, size);
+}
+
+void *Z_Realloc2(void *ptr, size_t size, INT32 tag, void *user, INT32 alignbits, const char *file, INT32 line)
 {
 	void *rez;
 	memblock_t *block;
@@ -343,24 +1092,14 @@ void *Z_ReallocAlign(void *ptr, size_t size,INT32 tag, void *user,  INT32 alignb
 
 	if (!size)
 	{
-		Z_Free(ptr);
+		Z_Free2(ptr, file, line);
 		return NULL;
 	}
 
 	if (!ptr)
-	{
-#ifdef ZDEBUG
 		return Z_Calloc2(size, tag, user, alignbits, file , line);
-#else
-		return Z_CallocAlign(size, tag, user, alignbits);
-#endif
-	}
 
-#ifdef ZDEBUG
 	block = Ptr2Memblock2(ptr, "Z_Realloc", file, line);
-#else
-	block = Ptr2Memblock(ptr, "Z_Realloc");
-#endif
 
 	if (block == NULL)
 		return NULL;
@@ -368,10 +1107,8 @@ void *Z_ReallocAlign(void *ptr, size_t size,INT32 tag, void *user,  INT32 alignb
 #ifdef ZDEBUG
 	// Write every Z_Realloc call to a debug file.
 	DEBFILE(va("Z_Realloc at %s:%d\n", file, line));
-	rez = Z_Malloc2(size, tag, user, alignbits, file, line);
-#else
-	rez = Z_MallocAlign(size, tag, user, alignbits);
 #endif
+	rez = Z_Malloc2(size, tag, user, alignbits, file, line);
 
 	if (size < block->realsize)
 		copysize = size;
@@ -380,11 +1117,7 @@ void *Z_ReallocAlign(void *ptr, size_t size,INT32 tag, void *user,  INT32 alignb
 
 	M_Memcpy(rez, ptr, copysize);
 
-#ifdef ZDEBUG
 	Z_Free2(ptr, file, line);
-#else
-	Z_Free(ptr);
-#endif
 
 	// Need to set the user in case the old block had the same one, in
 	// which case the Z_Free will just have NULLed it out.
@@ -397,18 +1130,41 @@ void *Z_ReallocAlign(void *ptr, size_t size,INT32 tag, void *user,  INT32 alignb
 	return rez;
 }
 
-void Z_FreeTags(INT32 lowtag, INT32 hightag)
+// Z_FreeTags without the lock, for when the caller already has it.
+static void Z_PurgeTags(INT32 lowtag, INT32 hightag)
 {
 	memblock_t *block, *next;
 
-	Z_CheckHeap(420);
 	for (block = head.next; block != &head; block = next)
 	{
 		next = block->next; // get link before freeing
 
 		if (block->tag >= lowtag && block->tag <= hightag)
-			Z_Free((UINT8 *)block->hdr + sizeof *block->hdr);
+			Z_FreeBlock((UINT8 *)block->hdr + sizeof *block->hdr, __FILE__, __LINE__);
+	}
+
+#ifdef ZONEARENAS
+	{
+		INT32 i;
+		for (i = 0; i < NUMZARENAS; i++)
+			if (zarenas[i].tag >= lowtag && zarenas[i].tag <= hightag)
+				Z_ReleaseArena(&zarenas[i]);
 	}
+	{
+		zpool_t *pool;
+		for (pool = zpools; pool; pool = pool->next)
+			if (pool->tag >= lowtag && pool->tag <= hightag)
+				Z_ReleasePool(pool);
+	}
+#endif
+}
+
+void Z_FreeTags(INT32 lowtag, INT32 hightag)
+{
+	Z_CheckHeap(420);
+	Z_LockZone();
+	Z_PurgeTags(lowtag, hightag);
+	Z_UnlockZone();
 }
 
 //
@@ -437,19 +1193,14 @@ void Z_CheckMemCleanup(void)
 }
 
 
-/** Checks the heap, as well as the memhdr_ts, for any corruption or
-  * other problems.
-  * \param i Identifies from where in the code Z_CheckHeap was called.
-  * \author Graue <graue@oceanbase.org>
-  */
-void Z_CheckHeap(INT32 i)
+static void Z_CheckBlockList(memblock_t *list, INT32 i)
 {
 	memblock_t *block;
 	memhdr_t *hdr;
 	UINT32 blocknumon = 0;
 	void *given;
 
-	for (block = head.next; block != &head; block = block->next)
+	for (block = list->next; block != list; block = block->next)
 	{
 		blocknumon++;
 		hdr = block->hdr;
@@ -542,6 +1293,26 @@ void Z_CheckHeap(INT32 i)
 	}
 }
 
+/** Checks the heap, as well as the memhdr_ts, for any corruption or
+  * other problems.
+  * \param i Identifies from where in the code Z_CheckHeap was called.
+  * \author Graue <graue@oceanbase.org>
+  */
+void Z_CheckHeap(INT32 i)
+{
+	Z_CheckBlockList(&head, i);
+
+#if defined (ZONEARENAS) && defined (PARANOIA)
+	// Walking every level block on every Z_FreeTags is exactly what the
+	// arenas are there to avoid, so only do it when being paranoid.
+	{
+		INT32 a;
+		for (a = 0; a < NUMZARENAS; a++)
+			Z_CheckBlockList(&zarenas[a].head, i);
+	}
+#endif
+}
+
 #ifdef PARANOIA
 void Z_ChangeTag2(void *ptr, INT32 tag, const char *file, INT32 line)
 #else
@@ -570,6 +1341,12 @@ void Z_ChangeTag2(void *ptr, INT32 tag)
 #endif
 	}
 #endif
+#ifdef ZONEARENAS
+	// Pool slots belong to their pool's tag and have no user to set.
+	if (hdr->id == POOLID)
+		I_Error("Internal memory management error: "
+			"tried to change the tag of a pooled block");
+#endif
 #ifdef PARANOIA
 	if (hdr->id != ZONEID) I_Error("Z_CT at %s:%d: wrong id", file, line);
 #endif
@@ -584,7 +1361,14 @@ void Z_ChangeTag2(void *ptr, INT32 tag)
 		I_Error("Internal memory management error: "
 			"tried to make block purgable but it has no owner");
 
+	Z_LockZone();
+#ifdef ZONEARENAS
+	if (block->chunk != NULL && !block->pinned && tag != block->chunk->arena->tag)
+		Z_ArenaPin(block);
+#endif
+
 	block->tag = tag;
+	Z_UnlockZone();
 }
 
 /** Calculates memory usage for a given set of tags.
@@ -606,6 +1390,21 @@ size_t Z_TagsUsage(INT32 lowtag, INT32 hightag)
 		cnt += rover->size + sizeof *rover;
 	}
 
+#ifdef ZONEARENAS
+	{
+		INT32 i;
+		for (i = 0; i < NUMZARENAS; i++)
+			if (zarenas[i].tag >= lowtag && zarenas[i].tag <= hightag)
+				cnt += zarenas[i].live;
+	}
+	{
+		zpool_t *pool;
+		for (pool = zpools; pool; pool = pool->next)
+			if (pool->tag >= lowtag && pool->tag <= hightag)
+				cnt += pool->numslabs * (sizeof (zslab_t) + ZPOOL_SLOTHDR + ZPOOL_CACHELINE + pool->perslab * pool->stride);
+	}
+#endif
+
 	return cnt;
 }
 
@@ -630,6 +1429,41 @@ void Command_Memfree_f(void)
 	CONS_Printf(M_GetText("All purgable      : %7s KB\n"),
 		sizeu1(Z_TagsUsage(PU_PURGELEVEL, INT32_MAX)>>10));
 
+#ifdef ZONEARENAS
+	if (usezarenas)
+	{
+		size_t chunks = 0, reserved = 0, live = 0, freed = 0;
+		memchunk_t *chunk;
+		INT32 i;
+
+		for (i = 0; i < NUMZARENAS; i++)
+		{
+			chunks += zarenas[i].numchunks;
+			live += zarenas[i].live;
+			freed += zarenas[i].freebytes;
+		}
+		reserved = chunks * (ZARENA_CHUNKHDR + ZARENA_CHUNKSIZE);
+		for (chunk = retiredchunks, i = 0; chunk; chunk = chunk->next)
+			i++;
+
+		CONS_Printf("\x82%s", M_GetText("Level Arena Info\n"));
+		CONS_Printf(M_GetText("Chunks            : %7s (%s retired)\n"), sizeu1(chunks), sizeu2((size_t)i));
+		CONS_Printf(M_GetText("Reserved          : %7s KB\n"), sizeu1(reserved>>10));
+		CONS_Printf(M_GetText("In use            : %7s KB\n"), sizeu1(live>>10));
+		CONS_Printf(M_GetText("On free lists     : %7s KB\n"), sizeu1(freed>>10));
+	}
+
+	if (zpools)
+	{
+		zpool_t *pool;
+
+		CONS_Printf("\x82%s", M_GetText("Object Pool Info\n"));
+		for (pool = zpools; pool; pool = pool->next)
+			CONS_Printf(M_GetText("%-18s: %s live, %s peak, %s recycled, %s slabs\n"), pool->name,
+				sizeu1(pool->live), sizeu2(pool->peak), sizeu3(pool->recycled), sizeu4(pool->numslabs));
+	}
+#endif
+
 #ifdef HWRENDER
 	if (rendermode != render_soft && rendermode != render_none)
 	{
@@ -665,6 +1499,22 @@ static void Command_Memdump_f(void)
 			char *filename = strrchr(block->ownerfile, PATHSEP[0]);
 			CONS_Printf("[%3d] %s (%s) bytes @ %s:%d\n", block->tag, sizeu1(block->size), sizeu2(block->realsize), filename ? filename + 1 : block->ownerfile, block->ownerline);
 		}
+
+#ifdef ZONEARENAS
+	for (i = 0; i < NUMZARENAS; i++)
+	{
+		memblock_t *list = &zarenas[i].head;
+
+		if (zarenas[i].tag < mintag || zarenas[i].tag > maxtag)
+			continue;
+
+		for (block = list->next; block != list; block = block->next)
+		{
+			char *filename = strrchr(block->ownerfile, PATHSEP[0]);
+			CONS_Printf("[%3d] %s (%s) bytes @ %s:%d (arena)\n", block->tag, sizeu1(block->size), sizeu2(block->realsize), filename ? filename + 1 : block->ownerfile, block->ownerline);
+		}
+	}
+#endif
 }
 #endif
 
@@ -693,6 +1543,12 @@ void Z_SetUser2(void *ptr, void **newuser)
 	VALGRIND_MAKE_MEM_DEFINED(hdr, sizeof *hdr);
 #endif
 
+#ifdef ZONEARENAS
+	// Pool slots belong to their pool's tag and have no user to set.
+	if (hdr->id == POOLID)
+		I_Error("Internal memory management error: "
+			"tried to set the user of a pooled block");
+#endif
 #ifdef PARANOIA
 	if (hdr->id != ZONEID) I_Error("Z_CT at %s:%d: wrong id", file, line);
 #endif
@@ -707,6 +1563,8 @@ void Z_SetUser2(void *ptr, void **newuser)
 		I_Error("Internal memory management error: "
 			"tried to make block purgable but it has no owner");
 
+	Z_LockZone();
 	block->user = (void*)newuser;
 	*newuser = ptr;
+	Z_UnlockZone();
 }
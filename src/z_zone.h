@@ -74,7 +74,8 @@ void Z_SetUser2(void *ptr, void **newuser, const char *file, INT32 line);
 void Z_SetUser2(void *ptr, void **newuser);
 #endif
 
-#ifdef ZDEBUG
+// Call sites are always passed along, so the memory profiler (see
+// "memprofile") can attribute allocations without a ZDEBUG build.
 #define Z_Free(p) Z_Free2(p, __FILE__, __LINE__)
 void Z_Free2(void *ptr, const char *file, INT32 line);
 #define Z_Malloc(s,t,u) Z_Malloc2(s, t, u, 0, __FILE__, __LINE__)
@@ -86,19 +87,54 @@ void *Z_Calloc2(size_t size, INT32 tag, void *user, INT32 alignbits, const char
 #define Z_Realloc(p,s,t,u) Z_Realloc2(p, s, t, u, 0, __FILE__, __LINE__)
 #define Z_ReallocAlign(p,s,t,u,a) Z_Realloc2(p,s, t, u, a, __FILE__, __LINE__)
 void *Z_Realloc2(void *ptr, size_t size, INT32 tag, void *user, INT32 alignbits, const char *file, INT32 line) FUNCALLOC(2);
-#else
-void Z_Free(void *ptr);
-void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits) FUNCALLOC(1);
-#define Z_Malloc(s,t,u) Z_MallocAlign(s, t, u, 0)
-void *Z_CallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits) FUNCALLOC(1);
-#define Z_Calloc(s,t,u) Z_CallocAlign(s, t, u, 0)
-void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignbits) FUNCALLOC(2) ;
-#define Z_Realloc(p, s,t,u) Z_ReallocAlign(p, s, t, u, 0)
-#endif
+
+// Turns memory that came from somewhere other than malloc (a file mapping,
+// say) into a zone block, so it can be tagged, purged and freed like any
+// other. There must be Z_ADOPTROOM writable bytes right before "given";
+// "release" gets called on "real" instead of free() when the block goes.
+#define Z_ADOPTROOM 16
+typedef void (*zrelease_t)(void *real, size_t realsize);
+#define Z_Adopt(r,g,s,f,t,u) Z_Adopt2(r, g, s, f, t, u, __FILE__, __LINE__)
+void *Z_Adopt2(void *real, void *given, size_t size, zrelease_t release, INT32 tag, void *user, const char *file, INT32 line);
 
 size_t Z_TagUsage(INT32 tagnum);
 size_t Z_TagsUsage(INT32 lowtag, INT32 hightag);
 
+//
+// Fixed-size object pools, for level objects that are spawned and
+// removed all the time (mobjs, precipitation, some special thinkers).
+// Objects come out zeroed and cache-line aligned, and are given back
+// with plain Z_Free. Everything in a pool goes away when its tag is
+// purged by Z_FreeTags, like any other block with that tag.
+//
+typedef struct zpool_s
+{
+	const char *name;
+	size_t objsize;
+	INT32 tag;
+
+	// Private to z_zone.c
+	size_t stride; // bytes per slot
+	size_t perslab; // slots per slab
+	void *slabs; // newest first, only the first one is bumped
+	void *freelist;
+	struct zpool_s *next; // all pools that have been used
+	boolean registered;
+
+	// Counters, for memfree
+	size_t numslabs;
+	size_t live; // objects currently handed out
+	size_t peak; // highest value of live since startup
+	size_t recycled; // allocations served from the free list
+
+	UINT32 site; // memprofile site for the whole pool
+} zpool_t;
+
+#define Z_POOL(name, type, tag) {name, sizeof (type), tag, 0, 0, NULL, NULL, NULL, false, 0, 0, 0, 0, 0}
+
+#define Z_PoolCalloc(p) Z_PoolCalloc2(p, __FILE__, __LINE__)
+void *Z_PoolCalloc2(zpool_t *pool, const char *file, INT32 line);
+
 char *Z_StrDup(const char *in);
 
 // This is used to get the local FILE : LINE info from CPP